@@ -0,0 +1,83 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES
+ *
+ * GPL-3.0 License
+ *
+ * QES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Winds. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file handleBenchmarkArgs.cpp */
+
+#include "handleBenchmarkArgs.h"
+
+BenchmarkArgs::BenchmarkArgs()
+{
+  reg("help", "help/usage information", ArgumentParsing::NONE, '?');
+
+  reg("inputdir", "folder with the xml files of the benchmark domains", ArgumentParsing::STRING, 'q');
+  reg("domain", "run only one domain (FlatTerrain, GaussianHill, BuildingArray)", ArgumentParsing::STRING, 'd');
+  reg("kernel", "run only one kernel (solver_cpu, solver_cpu_rb, turbulence, interp_trilinear, advection, reflection, netcdf_save)", ArgumentParsing::STRING, 'k');
+  reg("output", "JSON file with the results", ArgumentParsing::STRING, 'o');
+
+  reg("repeat", "number of timed repetitions of each kernel", ArgumentParsing::INT, 'n');
+  reg("iterations", "number of SOR iterations per solve", ArgumentParsing::INT, 'i');
+  reg("samples", "number of random points for the interpolation and reflection kernels", ArgumentParsing::INT, 'p');
+  reg("duration", "simulated time (s) of the particle advection kernel", ArgumentParsing::FLOAT, 't');
+}
+
+void BenchmarkArgs::processArguments(int argc, char *argv[])
+{
+  processCommandLineArgs(argc, argv);
+
+  if (isSet("help")) {
+    printUsage();
+    exit(EXIT_SUCCESS);
+  }
+
+  if (!isSet("inputdir", inputDir)) {
+    inputDir = std::string(QES_DIR) + "/benchmarks/inputs";
+  }
+  isSet("domain", domain);
+  isSet("kernel", kernel);
+  isSet("output", outputFile);
+
+  isSet("repeat", repetitions);
+  isSet("iterations", solverIterations);
+  isSet("samples", samples);
+  isSet("duration", plumeDuration);
+
+  if (repetitions < 1 || solverIterations < 1 || samples < 1 || plumeDuration <= 0.0) {
+    QESout::error("repeat, iterations, samples and duration must be positive");
+  }
+
+  std::cout << "Summary of QES benchmark options: " << std::endl;
+  std::cout << "----------------------------" << std::endl;
+  std::cout << "Input folder:\t\t " << inputDir << std::endl;
+  std::cout << "Domain:\t\t\t " << (domain.empty() ? "all" : domain) << std::endl;
+  std::cout << "Kernel:\t\t\t " << (kernel.empty() ? "all" : kernel) << std::endl;
+  std::cout << "Repetitions:\t\t " << repetitions << std::endl;
+  std::cout << "Results:\t\t " << outputFile << std::endl;
+  std::cout << "----------------------------" << std::endl;
+}
@@ -0,0 +1,79 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES
+ *
+ * GPL-3.0 License
+ *
+ * QES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Winds. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file handleBenchmarkArgs.h */
+
+#pragma once
+
+/*
+ * This class handles the commandline options of the benchmark suite
+ * and places the values into variables. This inherits from Argument Parsing
+ */
+
+#include <iostream>
+#include <string>
+
+#include "util/ArgumentParsing.h"
+#include "util/QESout.h"
+
+class BenchmarkArgs : public ArgumentParsing
+{
+public:
+  BenchmarkArgs();
+
+  ~BenchmarkArgs() {}
+
+  /*
+   * Takes in the commandline arguments and places
+   * them into variables.
+   *
+   * @param argc -number of commandline options/arguments
+   * @param argv -array of strings for arguments
+   */
+  void processArguments(int argc, char *argv[]);
+
+  // folder with the xml files of the synthetic domains
+  std::string inputDir = "";
+  // run a single domain (empty -> all the domains)
+  std::string domain = "";
+  // run a single kernel (empty -> all the kernels)
+  std::string kernel = "";
+  // JSON file with the results
+  std::string outputFile = "qesBenchmarks.json";
+
+  // number of timed repetitions of each kernel (the best one is reported)
+  int repetitions = 3;
+  // number of SOR iterations per solve (the tolerance is set to zero)
+  int solverIterations = 100;
+  // number of random points for the interpolation and reflection kernels
+  int samples = 1000000;
+  // simulated time (s) of the particle advection kernel
+  float plumeDuration = 60.0;
+};
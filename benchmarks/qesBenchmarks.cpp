@@ -0,0 +1,378 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES
+ *
+ * GPL-3.0 License
+ *
+ * QES is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Winds. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file qesBenchmarks.cpp */
+
+/*
+ * Microbenchmarks of the QES hot kernels on reproducible synthetic domains
+ * (xml files in benchmarks/inputs). Each kernel is run several times, the
+ * best repetition is reported as a rate (work units per second) and all the
+ * results are written in a JSON file to compare commits and machines.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "util/QESout.h"
+#include "util/QESprofile.h"
+
+#include "winds/WINDSInputData.h"
+#include "winds/WINDSGeneralData.h"
+#include "winds/WINDSOutputVisualization.h"
+#include "winds/TURBGeneralData.h"
+#include "winds/CPUSolver.h"
+#include "winds/Solver_CPU_RB.h"
+
+#include "plume/PlumeInputData.hpp"
+#include "plume/Plume.hpp"
+#include "plume/WallReflection_StairStep.h"
+
+#include "handleBenchmarkArgs.h"
+
+// work done and time spent by one repetition of a kernel
+struct BenchmarkSample
+{
+  double work;
+  double seconds;
+};
+
+struct BenchmarkResult
+{
+  std::string domain;
+  std::string kernel;
+  std::string unit;
+  std::vector<BenchmarkSample> samples;
+
+  // best repetition (highest rate)
+  BenchmarkSample best() const
+  {
+    return *std::max_element(samples.begin(), samples.end(), [](const BenchmarkSample &a, const BenchmarkSample &b) {
+      return a.work * b.seconds < b.work * a.seconds;
+    });
+  }
+  double meanSeconds() const
+  {
+    double sum = 0.0;
+    for (const auto &s : samples) {
+      sum += s.seconds;
+    }
+    return sum / samples.size();
+  }
+};
+
+static double secondsSince(const std::chrono::high_resolution_clock::time_point &start)
+{
+  std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+  return elapsed.count();
+}
+
+static void writeResults(const BenchmarkArgs &arguments, const std::vector<BenchmarkResult> &results)
+{
+  std::ofstream out(arguments.outputFile);
+  if (!out.is_open()) {
+    QESout::error("cannot write the benchmark results to " + arguments.outputFile);
+  }
+
+  char host[256] = "unknown";
+  gethostname(host, sizeof(host) - 1);
+  std::time_t now = std::time(nullptr);
+  char date[32];
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+  int threads = 1;
+#ifdef _OPENMP
+  threads = omp_get_max_threads();
+#endif
+
+  out.precision(9);
+  out << "{\n";
+  out << "  \"qes_version\": \"" << QES_VERSION_INFO << "\",\n";
+  out << "  \"host\": \"" << host << "\",\n";
+  out << "  \"date\": \"" << date << "\",\n";
+  out << "  \"threads\": " << threads << ",\n";
+  out << "  \"repetitions\": " << arguments.repetitions << ",\n";
+  out << "  \"results\": [";
+  std::string sep = "\n";
+  for (const auto &result : results) {
+    BenchmarkSample best = result.best();
+    out << sep << "    { \"domain\": \"" << result.domain << "\", \"kernel\": \"" << result.kernel << "\""
+        << ", \"unit\": \"" << result.unit << "\""
+        << ", \"work\": " << best.work
+        << ", \"seconds_best\": " << best.seconds
+        << ", \"seconds_mean\": " << result.meanSeconds()
+        << ", \"rate\": " << (best.seconds > 0.0 ? best.work / best.seconds : 0.0) << " }";
+    sep = ",\n";
+  }
+  out << "\n  ]\n}\n";
+
+  std::cout << "[QES-Bench] \t Results written to " << arguments.outputFile << std::endl;
+}
+
+// runs the benchmarks of one synthetic domain
+static void benchmarkDomain(const BenchmarkArgs &arguments,
+                            const std::string &domain,
+                            std::vector<BenchmarkResult> &results)
+{
+  auto selected = [&arguments](const std::string &kernel) {
+    return arguments.kernel.empty() || arguments.kernel == kernel;
+  };
+  auto run = [&](const std::string &kernel, const std::string &unit, const std::function<BenchmarkSample()> &fn) {
+    if (!selected(kernel)) {
+      return;
+    }
+    std::cout << "-------------------------------------------------------------------" << std::endl;
+    std::cout << "[QES-Bench] \t " << domain << " :: " << kernel << std::endl;
+    BenchmarkResult result = { domain, kernel, unit, {} };
+    for (int rep = 0; rep < arguments.repetitions; ++rep) {
+      QESprofile::reset();
+      result.samples.push_back(fn());
+    }
+    BenchmarkSample best = result.best();
+    std::cout << "[QES-Bench] \t " << domain << " :: " << kernel << " -> "
+              << best.work / best.seconds << " " << unit << " (best of " << arguments.repetitions << ")" << std::endl;
+    results.push_back(result);
+  };
+
+  std::string windsFile = arguments.inputDir + "/bench_winds_" + domain + ".xml";
+  std::string plumeFile = arguments.inputDir + "/bench_plume_" + domain + ".xml";
+
+  WINDSInputData *WID = new WINDSInputData(windsFile);
+  WINDSGeneralData *WGD = new WINDSGeneralData(WID, 1);
+
+  WGD->resetICellFlag();
+  WGD->applyWindProfile(WID, 0, 1);
+  WGD->applyParametrizations(WID);
+
+  // fixed number of iterations: the tolerance can never be reached
+  WID->simParams->maxIterations = arguments.solverIterations;
+  WID->simParams->tolerance = 0.0;
+
+  auto solveSample = [&](Solver *solver) {
+    solver->resetLambda();
+    auto start = std::chrono::high_resolution_clock::now();
+    solver->solve(WID, WGD, true);
+    double seconds = secondsSince(start);
+    double cellUpdates = QESprofile::totalCount("winds/solver/cell_updates");
+    return BenchmarkSample{ cellUpdates, seconds };
+  };
+
+  if (selected("solver_cpu")) {
+    CPUSolver solver(WID, WGD);
+    run("solver_cpu", "cell_updates/s", [&]() { return solveSample(&solver); });
+  }
+  Solver_CPU_RB solverRB(WID, WGD);
+  run("solver_cpu_rb", "cell_updates/s", [&]() { return solveSample(&solverRB); });
+
+  // the following kernels use a solved wind field
+  if (!arguments.kernel.empty() && arguments.kernel.compare(0, 6, "solver") == 0) {
+    delete WGD;
+    delete WID;
+    return;
+  }
+  if (!selected("solver_cpu_rb")) {
+    solveSample(&solverRB);
+  }
+
+  TURBGeneralData *TGD = new TURBGeneralData(WID, WGD);
+  run("turbulence", "cells/s", [&]() {
+    auto start = std::chrono::high_resolution_clock::now();
+    TGD->run();
+    return BenchmarkSample{ (double)WGD->numcell_cent, secondsSince(start) };
+  });
+  if (!selected("turbulence")) {
+    TGD->run();
+  }
+
+  std::mt19937 generator(20240101);
+  PlumeInputData *PID = new PlumeInputData(plumeFile);
+
+  if (selected("interp_trilinear") || selected("reflection")) {
+    Plume *plume = new Plume(PID, WGD, TGD);
+    Interp *interp = plume->interp;
+
+    // random points in the air cells (fixed seed -> same points on every machine)
+    std::vector<int> airCells, wallCells;
+    for (int k = 1; k < WGD->nz - 2; ++k) {
+      for (int j = 1; j < WGD->ny - 2; ++j) {
+        for (int i = 1; i < WGD->nx - 2; ++i) {
+          int id = i + j * (WGD->nx - 1) + k * (WGD->nx - 1) * (WGD->ny - 1);
+          if (WGD->icellflag[id] == 0 || WGD->icellflag[id] == 2) {
+            continue;
+          }
+          airCells.push_back(id);
+          // air cell next to a building or the terrain
+          int neighbors[6] = { id - 1, id + 1, id - (WGD->nx - 1), id + (WGD->nx - 1), id - (WGD->nx - 1) * (WGD->ny - 1), id + (WGD->nx - 1) * (WGD->ny - 1) };
+          for (int n : neighbors) {
+            if (WGD->icellflag[n] == 0 || WGD->icellflag[n] == 2) {
+              wallCells.push_back(id);
+              break;
+            }
+          }
+        }
+      }
+    }
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    auto randomPoint = [&](const std::vector<int> &cells, double &x, double &y, double &z) {
+      int id = cells[generator() % cells.size()];
+      int k = id / ((WGD->nx - 1) * (WGD->ny - 1));
+      int j = (id - k * (WGD->nx - 1) * (WGD->ny - 1)) / (WGD->nx - 1);
+      int i = id - j * (WGD->nx - 1) - k * (WGD->nx - 1) * (WGD->ny - 1);
+      x = (i + unit(generator)) * WGD->dx;
+      y = (j + unit(generator)) * WGD->dy;
+      z = WGD->z_face[k] + unit(generator) * WGD->dz_array[k];
+    };
+
+    std::vector<double> xs(arguments.samples), ys(arguments.samples), zs(arguments.samples);
+    for (int n = 0; n < arguments.samples; ++n) {
+      randomPoint(airCells, xs[n], ys[n], zs[n]);
+    }
+    run("interp_trilinear", "calls/s", [&]() {
+      double uMean, vMean, wMean, txx, txy, txz, tyy, tyz, tzz, fx, fy, fz, nuT, CoEps;
+      double checksum = 0.0;
+      auto start = std::chrono::high_resolution_clock::now();
+      for (int n = 0; n < arguments.samples; ++n) {
+        interp->interpValues(xs[n], ys[n], zs[n], WGD, uMean, vMean, wMean, TGD, txx, txy, txz, tyy, tyz, tzz, fx, fy, fz, nuT, CoEps);
+        checksum += uMean;
+      }
+      double seconds = secondsSince(start);
+      // keep the loop from being optimized away
+      if (checksum == 0.123456789) {
+        std::cout << checksum << std::endl;
+      }
+      return BenchmarkSample{ (double)arguments.samples, seconds };
+    });
+
+    if (!wallCells.empty()) {
+      // trajectories of one cell in a random direction starting next to a wall
+      std::normal_distribution<double> normal(0.0, 1.0);
+      std::vector<double> dis(3 * arguments.samples), fluct(3 * arguments.samples);
+      for (int n = 0; n < arguments.samples; ++n) {
+        randomPoint(wallCells, xs[n], ys[n], zs[n]);
+        double dx = normal(generator), dy = normal(generator), dz = normal(generator);
+        double norm = std::max(sqrt(dx * dx + dy * dy + dz * dz), 1e-6);
+        dis[3 * n] = dx / norm * WGD->dx;
+        dis[3 * n + 1] = dy / norm * WGD->dy;
+        dis[3 * n + 2] = dz / norm * WGD->dz;
+        fluct[3 * n] = normal(generator);
+        fluct[3 * n + 1] = normal(generator);
+        fluct[3 * n + 2] = normal(generator);
+      }
+      WallReflection_StairStep wallReflect;
+      run("reflection", "calls/s", [&]() {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int n = 0; n < arguments.samples; ++n) {
+          double xPos = xs[n] + dis[3 * n], yPos = ys[n] + dis[3 * n + 1], zPos = zs[n] + dis[3 * n + 2];
+          double disX = dis[3 * n], disY = dis[3 * n + 1], disZ = dis[3 * n + 2];
+          double uFluct = fluct[3 * n], vFluct = fluct[3 * n + 1], wFluct = fluct[3 * n + 2];
+          wallReflect.reflect(WGD, plume, xPos, yPos, zPos, disX, disY, disZ, uFluct, vFluct, wFluct);
+        }
+        return BenchmarkSample{ (double)arguments.samples, secondsSince(start) };
+      });
+    }
+    delete plume;
+  }
+
+  run("advection", "particles/s", [&]() {
+    // a new plume every repetition, to release the same particles
+    Plume plume(PID, WGD, TGD);
+    std::vector<QESNetCDFOutput *> noOutput;
+    plume.run(WGD->timestamp[0] + arguments.plumeDuration, WGD, TGD, noOutput);
+    for (auto *par : plume.particleList) {
+      delete par;
+    }
+    return BenchmarkSample{ QESprofile::totalCount("plume/particles_advected"),
+                            QESprofile::totalTime("plume/advection") };
+  });
+
+  run("netcdf_save", "bytes/s", [&]() {
+    std::string outFile = "bench_" + domain + "_windsOut.nc";
+    WINDSOutputVisualization *output = new WINDSOutputVisualization(WGD, WID, outFile);
+    auto start = std::chrono::high_resolution_clock::now();
+    output->save(WGD->timestamp[0]);
+    double seconds = secondsSince(start);
+    delete output;
+    std::remove(outFile.c_str());
+    return BenchmarkSample{ QESprofile::totalCount("output/bytes"), seconds };
+  });
+
+  delete PID;
+  delete TGD;
+  delete WGD;
+  delete WID;
+}
+
+int main(int argc, char *argv[])
+{
+  QESout::splashScreen();
+
+  BenchmarkArgs arguments;
+  arguments.processArguments(argc, argv);
+
+  // the solver and plume kernels report their work through the profiling counters
+  QESprofile::enable();
+
+  std::vector<std::string> domains = { "FlatTerrain", "GaussianHill", "BuildingArray" };
+  if (!arguments.domain.empty()) {
+    if (std::find(domains.begin(), domains.end(), arguments.domain) == domains.end()) {
+      QESout::error("unknown benchmark domain " + arguments.domain);
+    }
+    domains = { arguments.domain };
+  }
+
+  std::vector<BenchmarkResult> results;
+  for (const auto &domain : domains) {
+    benchmarkDomain(arguments, domain, results);
+  }
+
+  std::cout << "##############################################################" << std::endl;
+  for (const auto &result : results) {
+    BenchmarkSample best = result.best();
+    printf("%-14s %-18s %14.4e %s\n", result.domain.c_str(), result.kernel.c_str(), best.work / best.seconds, result.unit.c_str());
+  }
+  std::cout << "##############################################################" << std::endl;
+
+  writeResults(arguments, results);
+
+  exit(EXIT_SUCCESS);
+}
@@ -16,6 +16,8 @@ QESArgs::QESArgs()
 
   reg("windsolveroff", "Turns off the wind solver and wind output", ArgumentParsing::NONE, 'x');
   reg("solvetype", "selects the method for solving the windfield", ArgumentParsing::INT, 's');
+  reg("batchsize", "number of timesteps solved together by the CPU solver (same geometry, one right-hand side per timestep)", ArgumentParsing::INT, 'b');
+  reg("pipeline", "overlaps the solve of the next timestep with the turbulence, output and plume of the current one (CPU solver)", ArgumentParsing::NONE, 'P');
 
   reg("qesWindsParamFile", "Specifies the QES Proj file", ArgumentParsing::STRING, 'q');
   reg("qesPlumeParamFile", "Specifies the QES Proj file", ArgumentParsing::STRING, 'p');
@@ -32,6 +34,8 @@ QESArgs::QESArgs()
   // going to assume concentration is always output. So these next options are like choices for additional debug output
   // reg("doEulDataOutput",     "should debug Eulerian data be output",           ArgumentParsing::NONE,   'e');
   reg("doParticleDataOutput", "should debug Lagrangian data be output", ArgumentParsing::NONE, 'l');
+
+  reg("profile", "write a profiling report (timers and counters per timestep) to the given .json or .csv file", ArgumentParsing::STRING, 'r');
 }
 
 
@@ -53,11 +57,30 @@ void QESArgs::processArguments(int argc, char *argv[])
 
   solveWind = !isSet("windsolveroff");
   isSet("solvetype", solveType);
+#ifndef HAS_MPI
+  if (solveType == Distributed_Type) {
+    QESout::warning("MPI is not supported in this build, using the CPU solver");
+    solveType = CPU_Type;
+  }
+#endif
 #ifndef HAS_CUDA
   // if CUDA is not supported, force the solveType to be CPU no matter
-  solveType = CPU_Type;
+  // (the distributed solver runs on the CPU)
+  if (solveType != Distributed_Type)
+    solveType = CPU_Type;
 #endif
 
+  isSet("batchsize", batchSize);
+  if (batchSize < 1) {
+    QESout::warning("Invalid batch size, solving the timesteps one by one");
+    batchSize = 1;
+  }
+  pipeline = isSet("pipeline");
+  if (pipeline && batchSize > 1) {
+    QESout::warning("Batched solve is not available in pipelined mode, solving the timesteps one by one");
+    batchSize = 1;
+  }
+
   compTurb = isSet("turbcomp");
   compPlume = isSet("qesPlumeParamFile", qesPlumeParamFile);
   if (compPlume) {
@@ -77,6 +100,8 @@ void QESArgs::processArguments(int argc, char *argv[])
 
   doParticleDataOutput = isSet("doParticleDataOutput");
 
+  isSet("profile", profileFile);
+
   isSet("outbasename", netCDFFileBasename);
   if (!netCDFFileBasename.empty()) {
     // visuOutput = isSet("visuout");
@@ -108,6 +133,7 @@ void QESArgs::processArguments(int argc, char *argv[])
     // }
     if (compPlume) {
       outputPlumeFile = netCDFFileBasename + "_plumeOut.nc";
+      outputReceptorFile = netCDFFileBasename + "_receptors.nc";
       if (doParticleDataOutput) {
         outputParticleDataFile = netCDFFileBasename + "_particleInfo.nc";
       }
@@ -140,6 +166,8 @@ void QESArgs::processArguments(int argc, char *argv[])
       std::cout << "Wind Solver:\t\t ON\t [Global memory solver (GPU)]" << std::endl;
     else if (solveType == Shared_M)
       std::cout << "Wind Solver:\t\t ON\t [Shared memory solver (GPU)]" << std::endl;
+    else if (solveType == Distributed_Type)
+      std::cout << "Wind Solver:\t\t ON\t [Distributed Red/Black solver (MPI)]" << std::endl;
     else
       std::cout << "[WARNING]\t the wind fields are not being calculated" << std::endl;
   }
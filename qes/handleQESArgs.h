@@ -12,7 +12,8 @@
 enum solverTypes : int { CPU_Type = 1,
                          DYNAMIC_P = 2,
                          Global_M = 3,
-                         Shared_M = 4 };
+                         Shared_M = 4,
+                         Distributed_Type = 5 };
 
 class QESArgs : public ArgumentParsing
 {
@@ -43,6 +44,10 @@ public:
   // flag to turn on/off different modules
   bool solveWind, compTurb, compPlume;
   int solveType;
+  // number of timesteps solved together by the CPU solver (1 -> one by one)
+  int batchSize = 1;
+  // prepare and solve the next timestep while the current one is finished
+  bool pipeline = false;
 
   // QES_WINDS output files:
   bool visuOutput, wkspOutput, terrainOut;
@@ -68,6 +73,10 @@ public:
   // std::string outputEulerianFile;
   std::string outputPlumeFile = "";
   std::string outputParticleDataFile = "";
+  std::string outputReceptorFile = "";
+
+  // profiling report (empty -> profiling turned off)
+  std::string profileFile = "";
 
 private:
 };
@@ -29,11 +29,13 @@
  ****************************************************************************/
 
 #include <iostream>
+#include <future>
 
 #include "util/ParseException.h"
 #include "util/ParseInterface.h"
 
 #include "util/QESout.h"
+#include "util/QESprofile.h"
 
 #include "util/QESNetCDFOutput.h"
 
@@ -50,6 +52,10 @@
 #include "winds/Solver.h"
 #include "winds/CPUSolver.h"
 #include "winds/Solver_CPU_RB.h"
+#ifdef HAS_MPI
+#include <mpi.h>
+#include "winds/Solver_MPI.h"
+#endif
 #ifdef HAS_CUDA
 #include "winds/DynamicParallelism.h"
 #include "winds/GlobalMemory.h"
@@ -63,13 +69,29 @@
 #include "plume/Plume.hpp"
 #include "plume/PlumeOutput.h"
 #include "plume/PlumeOutputParticleData.h"
+#include "plume/PlumeOutputReceptors.h"
 
 
 Solver *setSolver(const int, WINDSInputData *, WINDSGeneralData *);
+void prepareTimestep(const QESArgs &, WINDSInputData *, WINDSGeneralData *, int);
+void finishTimestep(int, WINDSGeneralData *, TURBGeneralData *, Plume *, PlumeInputData *,
+                    std::vector<QESNetCDFOutput *> &, std::vector<QESNetCDFOutput *> &);
+void runPipelined(const QESArgs &, WINDSInputData *, WINDSGeneralData *, TURBGeneralData *,
+                  Solver_CPU_RB *, Plume *, PlumeInputData *,
+                  std::vector<QESNetCDFOutput *> &, std::vector<QESNetCDFOutput *> &);
 
 int main(int argc, char *argv[])
 {
-  QESout::splashScreen();
+  // rank of the process with the distributed solver (only the root writes the output files)
+  int mpiRank = 0, mpiSize = 1;
+#ifdef HAS_MPI
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
+  MPI_Comm_size(MPI_COMM_WORLD, &mpiSize);
+#endif
+
+  if (mpiRank == 0)
+    QESout::splashScreen();
 
   // ///////////////////////////////////
   // Parse Command Line arguments
@@ -80,6 +102,22 @@ int main(int argc, char *argv[])
   // how to extend the arguments.
   QESArgs arguments;
   arguments.processArguments(argc, argv);
+  if (!arguments.profileFile.empty()) {
+    QESprofile::enable();
+  }
+
+#ifdef HAS_MPI
+  // distributed solver: only the root process builds the domain, the
+  // other processes hold their tile of the solver until the end of the run
+  if (arguments.solveType == Distributed_Type && mpiRank != 0) {
+    {
+      Solver_MPI tileSolver;
+      tileSolver.serve();
+    }
+    MPI_Finalize();
+    exit(EXIT_SUCCESS);
+  }
+#endif
 
   // ///////////////////////////////////
   // Read and Process any Input for the system
@@ -103,7 +141,7 @@ int main(int argc, char *argv[])
   }
 
 
-  if (arguments.terrainOut) {
+  if (arguments.terrainOut && mpiRank == 0) {
     if (WID->simParams->DTE_heightField) {
       std::cout << "Creating terrain OBJ....\n";
       WID->simParams->DTE_heightField->outputOBJ(arguments.filenameTerrain);
@@ -118,10 +156,10 @@ int main(int argc, char *argv[])
 
   // create WINDS output classes
   std::vector<QESNetCDFOutput *> outputVec;
-  if (arguments.visuOutput) {
+  if (arguments.visuOutput && mpiRank == 0) {
     outputVec.push_back(new WINDSOutputVisualization(WGD, WID, arguments.netCDFFileVisu));
   }
-  if (arguments.wkspOutput) {
+  if (arguments.wkspOutput && mpiRank == 0) {
     outputVec.push_back(new WINDSOutputWorkspace(WGD, arguments.netCDFFileWksp));
   }
 
@@ -132,7 +170,7 @@ int main(int argc, char *argv[])
   if (arguments.compTurb) {
     TGD = new TURBGeneralData(WID, WGD);
   }
-  if (arguments.compTurb && arguments.turbOutput) {
+  if (arguments.compTurb && arguments.turbOutput && mpiRank == 0) {
     outputVec.push_back(new TURBOutput(TGD, arguments.netCDFFileTurb));
   }
 
@@ -143,11 +181,37 @@ int main(int argc, char *argv[])
   if (arguments.compPlume) {
     // Create instance of Plume model class
     plume = new Plume(PID, WGD, TGD);
+    // the particles are spread over the processes (if several), except with the
+    // distributed solver: the other processes then only hold their tile of the solver
+#ifdef HAS_MPI
+    if (arguments.solveType == Distributed_Type) {
+      if (mpiSize > 1) {
+        QESout::warning("The plume is not distributed with the distributed solver, running it on the root process");
+      }
+    } else {
+      plume->distribute();
+    }
+#else
+    plume->distribute();
+#endif
 
-    // always supposed to output lagrToEulOutput data
-    outputPlume.push_back(new PlumeOutput(PID, plume, arguments.outputPlumeFile));
+    // lagrToEulOutput data (unless only the receptors are sampled)
+    // (the other processes only contribute to the concentration of the root process)
+    if (PID->colParams->gridOutput) {
+      outputPlume.push_back(new PlumeOutput(PID, plume, mpiRank == 0 ? arguments.outputPlumeFile : ""));
+    }
+    if (PID->receptorParams) {
+      outputPlume.push_back(new PlumeOutputReceptors(PID, plume, mpiRank == 0 ? arguments.outputReceptorFile : ""));
+    }
     if (arguments.doParticleDataOutput) {
-      outputPlume.push_back(new PlumeOutputParticleData(PID, plume, arguments.outputParticleDataFile));
+      if (plume->isDistributed()) {
+        QESout::warning("Particle data output is not available with several processes");
+      } else if (PID->plumeParams->particleBudget > 0) {
+        // one slot per released particle, the population control creates and removes particles
+        QESout::warning("Particle data output is not available with the population control (particleBudget)");
+      } else {
+        outputPlume.push_back(new PlumeOutputParticleData(PID, plume, arguments.outputParticleDataFile));
+      }
     }
   }
 
@@ -158,46 +222,71 @@ int main(int argc, char *argv[])
   // //////////////////////////////////////////
   Solver *solver = setSolver(arguments.solveType, WID, WGD);
 
-  for (int index = 0; index < WGD->totalTimeIncrements; index++) {
-    // print time progress (time stamp and percentage)
-    WGD->printTimeProgress(index);
-
-    // Reset icellflag values
-    WGD->resetICellFlag();
-
-    // Create initial velocity field from the new sensors
-    WGD->applyWindProfile(WID, index, arguments.solveType);
-
-    // Apply parametrizations
-    WGD->applyParametrizations(WID);
-
-    // Run WINDS simulation code
-    solver->solve(WID, WGD, arguments.solveWind);
-
-    // Run turbulence
-    if (TGD != nullptr) {
-      TGD->run();
+  // batched mode: the operator only depends on the geometry, the right-hand sides of
+  // batchSize timesteps are solved together, then each timestep is finished in turn
+  int batchSize = arguments.batchSize;
+  Solver_CPU_RB *batchSolver = nullptr;
+  if (batchSize > 1) {
+    batchSolver = dynamic_cast<Solver_CPU_RB *>(solver);
+    if (batchSolver) {
+      batchSolver->setBatchSize(WGD, batchSize);
+    } else {
+      QESout::warning("Batched solve is only available with the Red/Black CPU solver, solving the timesteps one by one");
+      batchSize = 1;
     }
+  }
 
-    // /////////////////////////////
-    // Output the various files requested from the simulation run
-    // (netcdf wind velocity, icell values, etc...
-    // /////////////////////////////
-    for (auto outItr = outputVec.begin(); outItr != outputVec.end(); ++outItr) {
-      (*outItr)->save(WGD->timestamp[index]);
+  // pipelined mode: two slots of the solver hold the timesteps in flight
+  Solver_CPU_RB *pipeSolver = nullptr;
+  if (arguments.pipeline) {
+    pipeSolver = dynamic_cast<Solver_CPU_RB *>(solver);
+    if (pipeSolver) {
+      pipeSolver->setBatchSize(WGD, 2);
+    } else {
+      QESout::warning("Pipelined mode is only available with the Red/Black CPU solver, running the timesteps in sequence");
     }
+  }
 
-    // Run plume advection model
-    if (plume != nullptr) {
-      QEStime endtime;
-      if (WGD->totalTimeIncrements == 1) {
-        endtime = WGD->timestamp[index] + PID->plumeParams->simDur;
-      } else if (index == WGD->totalTimeIncrements - 1) {
-        endtime = WGD->timestamp[index] + (WGD->timestamp[index] - WGD->timestamp[index - 1]);
-      } else {
-        endtime = WGD->timestamp[index + 1];
+  if (pipeSolver) {
+    runPipelined(arguments, WID, WGD, TGD, pipeSolver, plume, PID, outputVec, outputPlume);
+  } else {
+    // timestep whose initial field and parametrization state are held by WGD
+    int prepared = -1;
+    for (int batchStart = 0; batchStart < WGD->totalTimeIncrements; batchStart += batchSize) {
+      int nBatch = std::min(batchSize, WGD->totalTimeIncrements - batchStart);
+      if (batchSolver) {
+        QESprofile::beginStep(batchStart);
+        for (int b = 0; b < nBatch; ++b) {
+          prepareTimestep(arguments, WID, WGD, batchStart + b);
+          batchSolver->storeBatchRHS(WGD, b);
+          prepared = batchStart + b;
+        }
+        batchSolver->solveBatch(WID, WGD, nBatch);
+      }
+
+      for (int index = batchStart; index < batchStart + nBatch; index++) {
+        QESprofile::beginStep(index);
+        // print time progress (time stamp and percentage)
+        WGD->printTimeProgress(index);
+
+        if (batchSolver) {
+          // the parametrizations also leave per-timestep state read by the turbulence
+          // (canopy wake direction, ...): the initial field of this timestep is set up
+          // again (cheap next to the solve) before its solution is applied
+          if (index != prepared) {
+            prepareTimestep(arguments, WID, WGD, index);
+            prepared = index;
+          }
+          batchSolver->applyBatch(WGD, index - batchStart);
+        } else {
+          prepareTimestep(arguments, WID, WGD, index);
+
+          // Run WINDS simulation code
+          solver->solve(WID, WGD, arguments.solveWind);
+        }
+
+        finishTimestep(index, WGD, TGD, plume, PID, outputVec, outputPlume);
       }
-      plume->run(endtime, WGD, TGD, outputPlume);
     }
   }
 
@@ -205,6 +294,16 @@ int main(int argc, char *argv[])
     plume->showCurrentStatus();
   }
 
+  if (QESprofile::enabled() && mpiRank == 0) {
+    QESprofile::writeReport(arguments.profileFile);
+  }
+
+#ifdef HAS_MPI
+  if (arguments.solveType == Distributed_Type) {
+    static_cast<Solver_MPI *>(solver)->stop();
+  }
+  MPI_Finalize();
+#endif
   exit(EXIT_SUCCESS);
 }
 
@@ -225,9 +324,119 @@ Solver *setSolver(const int solveType, WINDSInputData *WID, WINDSGeneralData *WG
     solver = new GlobalMemory(WID, WGD);
   } else if (solveType == Shared_M) {
     solver = new SharedMemory(WID, WGD);
+#endif
+#ifdef HAS_MPI
+  } else if (solveType == Distributed_Type) {
+    solver = new Solver_MPI(WID, WGD);
 #endif
   } else {
     QESout::error("Invalid solve type");
   }
   return solver;
 }
+
+// initial velocity field of a timestep (wind profile and parametrizations)
+void prepareTimestep(const QESArgs &arguments, WINDSInputData *WID, WINDSGeneralData *WGD, int index)
+{
+  // Reset icellflag values
+  WGD->resetICellFlag();
+
+  // Create initial velocity field from the new sensors
+  WGD->applyWindProfile(WID, index, arguments.solveType);
+
+  // Apply parametrizations
+  WGD->applyParametrizations(WID);
+}
+
+// stages using the solved velocity field of a timestep: turbulence, outputs and plume
+void finishTimestep(int index, WINDSGeneralData *WGD, TURBGeneralData *TGD, Plume *plume, PlumeInputData *PID,
+                    std::vector<QESNetCDFOutput *> &outputVec, std::vector<QESNetCDFOutput *> &outputPlume)
+{
+  // Run turbulence
+  if (TGD != nullptr) {
+    TGD->run();
+  }
+
+  // /////////////////////////////
+  // Output the various files requested from the simulation run
+  // (netcdf wind velocity, icell values, etc...
+  // /////////////////////////////
+  for (auto outItr = outputVec.begin(); outItr != outputVec.end(); ++outItr) {
+    (*outItr)->save(WGD->timestamp[index]);
+  }
+
+  // Run plume advection model
+  if (plume != nullptr) {
+    QEStime endtime;
+    if (WGD->totalTimeIncrements == 1) {
+      endtime = WGD->timestamp[index] + PID->plumeParams->simDur;
+    } else if (index == WGD->totalTimeIncrements - 1) {
+      endtime = WGD->timestamp[index] + (WGD->timestamp[index] - WGD->timestamp[index - 1]);
+    } else {
+      endtime = WGD->timestamp[index + 1];
+    }
+    plume->run(endtime, WGD, TGD, outputPlume);
+  }
+}
+
+// Pipelined timesteps: the solve of timestep index + 1 runs in a second thread
+// while timestep index is finished (turbulence, outputs, plume) and timestep
+// index + 2 is prepared. The solve only reads the coefficients of WGD and its
+// own slot of the solver, the other stages stay in order on the main thread.
+// A timestep is prepared twice: for its solve, then again before it is finished
+// so that the turbulence sees its own parametrization state.
+// At most two timesteps are in flight (one slot solved, one slot applied or
+// filled), so the memory is bounded by two right-hand sides and multipliers.
+void runPipelined(const QESArgs &arguments, WINDSInputData *WID, WINDSGeneralData *WGD, TURBGeneralData *TGD,
+                  Solver_CPU_RB *solver, Plume *plume, PlumeInputData *PID,
+                  std::vector<QESNetCDFOutput *> &outputVec, std::vector<QESNetCDFOutput *> &outputPlume)
+{
+  const int nt = WGD->totalTimeIncrements;
+  std::future<void> solveNext;
+
+  // timestep 0 is solved while timestep 1 is prepared
+  QESprofile::beginStep(0);
+  prepareTimestep(arguments, WID, WGD, 0);
+  solver->storeBatchRHS(WGD, 0);
+  solveNext = std::async(std::launch::async, [=]() { solver->solveBatch(WID, WGD, 1, 0); });
+  if (nt > 1) {
+    prepareTimestep(arguments, WID, WGD, 1);
+    solver->storeBatchRHS(WGD, 1);
+  }
+  solveNext.get();
+
+  for (int index = 0; index < nt; index++) {
+    QESprofile::beginStep(index);
+    // print time progress (time stamp and percentage)
+    WGD->printTimeProgress(index);
+
+    const int slot = index % 2;
+    const int nextSlot = (index + 1) % 2;
+
+    // the next timestep (already prepared) is solved in the background
+    if (index + 1 < nt) {
+      solveNext = std::async(std::launch::async, [=]() { solver->solveBatch(WID, WGD, 1, nextSlot); });
+    }
+
+    // WGD holds the parametrization state of the last timestep prepared (index + 1),
+    // which the turbulence reads (canopy wake direction, ...): the initial field of
+    // this timestep is set up again before its solution is applied (the preparation
+    // does not touch the coefficients read by the solve in flight)
+    if (index + 1 < nt) {
+      prepareTimestep(arguments, WID, WGD, index);
+    }
+    solver->applyBatch(WGD, slot);
+
+    finishTimestep(index, WGD, TGD, plume, PID, outputVec, outputPlume);
+
+    // the slot of this timestep is free again
+    if (index + 2 < nt) {
+      prepareTimestep(arguments, WID, WGD, index + 2);
+      solver->storeBatchRHS(WGD, slot);
+    }
+
+    if (solveNext.valid()) {
+      solveNext.get();
+    }
+  }
+}
@@ -43,16 +43,20 @@ PlumeArgs::PlumeArgs()
   // reg("debug", "should command line output include debug info", ArgumentParsing::NONE, 'd');
 
   reg("qesPlumeParamFile", "specifies input xml settings file", ArgumentParsing::STRING, 'q');
+  reg("ensembleFile", "specifies a list of input xml settings files (one scenario per line) run together", ArgumentParsing::STRING, 'n');
   // single name for all input/output files
   reg("projectQESFiles", "specifies input/output files name", ArgumentParsing::STRING, 'm');
   // individual names for input/output files
   reg("inputWINDSFile", "specifies input qes-winds file", ArgumentParsing::STRING, 'w');
   reg("inputTURBFile", "specifies input qes-turb file", ArgumentParsing::STRING, 't');
   reg("outbasename", "Specifies the basename for netcdf files", ArgumentParsing::STRING, 'o');
+  reg("fieldCache", "read the winds/turbulence fields from memory-mapped caches (created next to the input files if missing)", ArgumentParsing::NONE, 'c');
   // going to assume concentration is always output. So these next options are like choices for additional debug output
   reg("doEulDataOutput", "should debug Eulerian data be output", ArgumentParsing::NONE, 'e');
   reg("doParticleDataOutput", "should debug Lagrangian data be output", ArgumentParsing::NONE, 'l');
   reg("doSimInfoFileOutput", "should debug simInfoFile be output", ArgumentParsing::NONE, 's');
+
+  reg("profile", "write a profiling report (timers and counters per timestep) to the given .json or .csv file", ArgumentParsing::STRING, 'r');
 }
 
 void PlumeArgs::processArguments(int argc, char *argv[])
@@ -65,7 +69,24 @@ void PlumeArgs::processArguments(int argc, char *argv[])
   }
 
   isSet("qesPlumeParamFile", qesPlumeParamFile);
-  if (qesPlumeParamFile.empty()) {
+  if (isSet("ensembleFile", ensembleFile)) {
+    std::ifstream ensembleList(ensembleFile);
+    if (!ensembleList) {
+      QESout::error("ensembleFile " + ensembleFile + " not able to be read");
+    }
+    std::string line;
+    while (std::getline(ensembleList, line)) {
+      // skip empty lines and comments
+      line.erase(0, line.find_first_not_of(" \t"));
+      line.erase(line.find_last_not_of(" \t\r") + 1);
+      if (!line.empty() && line[0] != '#') {
+        ensembleParamFiles.push_back(line);
+      }
+    }
+    if (ensembleParamFiles.empty()) {
+      QESout::error("ensembleFile " + ensembleFile + " does not list any scenario");
+    }
+  } else if (qesPlumeParamFile.empty()) {
     QESout::error("qesPlumeParamFile not specified");
   }
 
@@ -76,6 +97,8 @@ void PlumeArgs::processArguments(int argc, char *argv[])
   doEulDataOutput = isSet("doEulDataOutput");
   doParticleDataOutput = isSet("doParticleDataOutput");
   doSimInfoFileOutput = isSet("doSimInfoFileOutput");
+  useFieldCache = isSet("fieldCache");
+  isSet("profile", profileFile);
 
   if (isSet("projectQESFiles", projectQESFiles)) {
     inputWINDSFile = projectQESFiles + "_windsWk.nc";
@@ -83,6 +106,7 @@ void PlumeArgs::processArguments(int argc, char *argv[])
     outputFile = projectQESFiles + "_plumeOut.nc";
     outputEulerianFile = projectQESFiles + "_eulerianData.nc";
     outputParticleDataFile = projectQESFiles + "_particleInfo.nc";
+    outputReceptorFile = projectQESFiles + "_receptors.nc";
   } else {
     if (!isSet("inputWINDSFile", inputWINDSFile)) {
       QESout::error("inputWINDSFile not specified!");
@@ -97,6 +121,7 @@ void PlumeArgs::processArguments(int argc, char *argv[])
       outputEulerianFile = netCDFFileBasename + "_eulerianData.nc";
       outputFile = netCDFFileBasename + "_plumeOut.nc";
       outputParticleDataFile = netCDFFileBasename + "_particleInfo.nc";
+      outputReceptorFile = netCDFFileBasename + "_receptors.nc";
     } else {
       QESout::error("No output basename set -> output turned off ");
     }
@@ -111,10 +136,20 @@ void PlumeArgs::processArguments(int argc, char *argv[])
     std::cout << "Verbose:\t\t OFF" << std::endl;
   }
   std::cout << "----------------------------" << std::endl;
-  std::cout << "qesPlumeParamFile set to " << qesPlumeParamFile << std::endl;
+  if (ensembleParamFiles.empty()) {
+    std::cout << "qesPlumeParamFile set to " << qesPlumeParamFile << std::endl;
+  } else {
+    std::cout << "Ensemble of " << ensembleParamFiles.size() << " scenarios:" << std::endl;
+    for (size_t k = 0; k < ensembleParamFiles.size(); ++k) {
+      std::cout << "\t scenario " << k << ": " << ensembleParamFiles[k] << std::endl;
+    }
+  }
   std::cout << "----------------------------" << std::endl;
   std::cout << "[INPUT]\t Winds NetCDF input file set:\t\t " << inputWINDSFile << std::endl;
   std::cout << "[INPUT]\t Turbulence NetCDF input file set:\t " << inputTURBFile << std::endl;
+  if (useFieldCache) {
+    std::cout << "[INPUT]\t Field caches:\t\t\t\t " << inputWINDSFile << ".fcache, " << inputTURBFile << ".fcache" << std::endl;
+  }
   std::cout << "----------------------------" << std::endl;
   std::cout << "[PLUME]\t Plume NetCDF output file set:\t\t " << outputFile << std::endl;
   if (doEulDataOutput) {
@@ -40,6 +40,9 @@
 #pragma once
 
 #include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
 
 #include "util/doesFolderExist.h"
 #include "util/ArgumentParsing.h"
@@ -68,6 +71,9 @@ public:
 
   std::string qesPlumeParamFile = "";
 
+  std::string ensembleFile = ""; /**< list of xml settings files (ensemble mode) */
+  std::vector<std::string> ensembleParamFiles; /**< one xml settings file per scenario */
+
   std::string netCDFFileBasename = ""; /**< Base name for all NetCDF output files */
 
   std::string projectQESFiles = "";
@@ -79,10 +85,15 @@ public:
   bool doParticleDataOutput;
   bool doSimInfoFileOutput;
 
+  bool useFieldCache = false; /**< read the fields from memory-mapped caches instead of NetCDF */
+
+  std::string profileFile = ""; /**< profiling report file (empty -> profiling turned off) */
+
   // output file variables created from the outputFolder and caseBaseName
   std::string outputEulerianFile;
   std::string outputFile;
   std::string outputParticleDataFile;
+  std::string outputReceptorFile;
 
 private:
 };
@@ -35,6 +35,9 @@
 #include <cstdio>
 #include <algorithm>
 
+#ifdef HAS_MPI
+#include <mpi.h>
+#endif
 
 #include <boost/foreach.hpp>
 #include <boost/property_tree/xml_parser.hpp>
@@ -47,27 +50,50 @@
 #include "plume/PlumeInputData.hpp"
 #include "util/NetCDFInput.h"
 #include "util/QESout.h"
+#include "util/QESprofile.h"
 
 #include "winds/WINDSGeneralData.h"
 #include "winds/TURBGeneralData.h"
 
 #include "plume/Plume.hpp"
+#include "plume/PlumeEnsemble.hpp"
 
 #include "util/QESNetCDFOutput.h"
 #include "plume/PlumeOutput.h"
 #include "plume/PlumeOutputParticleData.h"
+#include "plume/PlumeOutputReceptors.h"
 
 
 // LA do these need to be here???
 using namespace netCDF;
 using namespace netCDF::exceptions;
 
+// output file of a scenario of the ensemble: <name>_scenario<k>.nc
+static std::string scenarioFileName(const std::string &fileName, const size_t &k)
+{
+  std::string tag = "_scenario" + std::to_string(k);
+  size_t ext = fileName.rfind(".nc");
+  if (ext == std::string::npos) {
+    return fileName + tag;
+  }
+  return fileName.substr(0, ext) + tag + fileName.substr(ext);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Program main
 ////////////////////////////////////////////////////////////////////////////////
 int main(int argc, char **argv)
 {
-  QESout::splashScreen();
+  // distributed mode: the particles are spread over the processes (only the root writes the output files)
+  int mpiRank = 0, mpiSize = 1;
+#ifdef HAS_MPI
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
+  MPI_Comm_size(MPI_COMM_WORLD, &mpiSize);
+#endif
+
+  if (mpiRank == 0)
+    QESout::splashScreen();
 
   // set up timer information for the simulation runtime
   calcTime timers;
@@ -76,32 +102,144 @@ int main(int argc, char **argv)
   // parse command line arguments
   PlumeArgs arguments;
   arguments.processArguments(argc, argv);
+  if (!arguments.profileFile.empty()) {
+    QESprofile::enable();
+  }
+
+  // ensemble mode: several scenarios run together over the same winds
+  bool ensembleMode = !arguments.ensembleParamFiles.empty();
+  if (ensembleMode && mpiSize > 1) {
+    QESout::error("Ensemble mode cannot be distributed over several processes");
+  }
+  if (arguments.doParticleDataOutput && mpiSize > 1) {
+    QESout::warning("Particle data output is not available with several processes");
+    arguments.doParticleDataOutput = false;
+  }
+  if (arguments.useFieldCache && mpiSize > 1) {
+    QESout::warning("Field cache is not available with several processes");
+    arguments.useFieldCache = false;
+  }
 
   // parse xml settings
-  PlumeInputData *PID = new PlumeInputData(arguments.qesPlumeParamFile);
-  if (!PID)
-    QESout::error("QES-Plume input file: " + arguments.qesPlumeParamFile + " not able to be read successfully.");
+  std::vector<PlumeInputData *> PIDs;
+  if (ensembleMode) {
+    for (const auto &paramFile : arguments.ensembleParamFiles) {
+      PIDs.push_back(new PlumeInputData(paramFile));
+      if (!PIDs.back())
+        QESout::error("QES-Plume input file: " + paramFile + " not able to be read successfully.");
+    }
+  } else {
+    PIDs.push_back(new PlumeInputData(arguments.qesPlumeParamFile));
+    if (!PIDs.back())
+      QESout::error("QES-Plume input file: " + arguments.qesPlumeParamFile + " not able to be read successfully.");
+  }
+  // the first scenario drives the settings shared by all the scenarios
+  PlumeInputData *PID = PIDs[0];
+
+  // the particle data file holds one slot per released particle, the particles
+  // created or removed by the population control do not fit in it
+  if (arguments.doParticleDataOutput) {
+    for (auto *pid : PIDs) {
+      if (pid->plumeParams->particleBudget > 0) {
+        QESout::warning("Particle data output is not available with the population control (particleBudget)");
+        arguments.doParticleDataOutput = false;
+        break;
+      }
+    }
+  }
+
+  // distributed mode: each process only loads its tile of the domain plus a halo
+  std::vector<int> window = Plume::tileWindow(arguments.inputWINDSFile, arguments.inputTURBFile, PID);
 
   // Create instance of QES-winds General data class
-  WINDSGeneralData *WGD = new WINDSGeneralData(arguments.inputWINDSFile);
+  WINDSGeneralData *WGD = new WINDSGeneralData(arguments.inputWINDSFile, window);
   // Create instance of QES-Turb General data class
   TURBGeneralData *TGD = new TURBGeneralData(arguments.inputTURBFile, WGD);
 
-  // Create instance of Plume model class
-  Plume *plume = new Plume(PID, WGD, TGD);
+  if (arguments.useFieldCache) {
+    WGD->attachFieldCache(arguments.inputWINDSFile + ".fcache");
+    TGD->attachFieldCache(arguments.inputTURBFile + ".fcache");
+  }
+
+  // second resident timestep, used to blend the fields in time between stored timesteps
+  WINDSGeneralData *WGD_next = nullptr;
+  TURBGeneralData *TGD_next = nullptr;
+  if (PID->plumeParams->timeInterpolation && WGD->totalTimeIncrements > 1) {
+    std::cout << "[QES-Plume] \t Blending wind and turbulence fields in time between stored timesteps" << std::endl;
+    WGD_next = new WINDSGeneralData(arguments.inputWINDSFile, window);
+    TGD_next = new TURBGeneralData(arguments.inputTURBFile, WGD_next);
+    if (arguments.useFieldCache) {
+      WGD_next->attachFieldCache(arguments.inputWINDSFile + ".fcache");
+      TGD_next->attachFieldCache(arguments.inputTURBFile + ".fcache");
+    }
+  }
+
+  // Create instance of Plume model class (one per scenario in ensemble mode)
+  Plume *plume = nullptr;
+  PlumeEnsemble *ensemble = nullptr;
 
   // create output instance
   std::vector<QESNetCDFOutput *> outputVec;
-  // always supposed to output lagrToEulOutput data
-  outputVec.push_back(new PlumeOutput(PID, plume, arguments.outputFile));
-  if (arguments.doParticleDataOutput) {
-    outputVec.push_back(new PlumeOutputParticleData(PID, plume, arguments.outputParticleDataFile));
+  std::vector<std::vector<QESNetCDFOutput *>> ensembleOutputVec;
+  if (ensembleMode) {
+    ensemble = new PlumeEnsemble(PIDs, WGD, TGD);
+    for (size_t k = 0; k < PIDs.size(); ++k) {
+      ensembleOutputVec.emplace_back();
+      // lagrToEulOutput data (unless only the receptors are sampled)
+      if (PIDs[k]->colParams->gridOutput) {
+        ensembleOutputVec[k].push_back(new PlumeOutput(PIDs[k], ensemble->members[k], scenarioFileName(arguments.outputFile, k)));
+      }
+      if (PIDs[k]->receptorParams) {
+        ensembleOutputVec[k].push_back(new PlumeOutputReceptors(PIDs[k], ensemble->members[k], scenarioFileName(arguments.outputReceptorFile, k)));
+      }
+      if (arguments.doParticleDataOutput) {
+        ensembleOutputVec[k].push_back(new PlumeOutputParticleData(PIDs[k], ensemble->members[k], scenarioFileName(arguments.outputParticleDataFile, k)));
+      }
+    }
+  } else {
+    plume = new Plume(PID, WGD, TGD);
+    plume->distribute();
+    // lagrToEulOutput data (unless only the receptors are sampled)
+    // (the other processes only contribute to the concentration of the root process)
+    if (PID->colParams->gridOutput) {
+      outputVec.push_back(new PlumeOutput(PID, plume, mpiRank == 0 ? arguments.outputFile : ""));
+    }
+    if (PID->receptorParams) {
+      outputVec.push_back(new PlumeOutputReceptors(PID, plume, mpiRank == 0 ? arguments.outputReceptorFile : ""));
+    }
+    if (arguments.doParticleDataOutput) {
+      outputVec.push_back(new PlumeOutputParticleData(PID, plume, arguments.outputParticleDataFile));
+    }
   }
 
   for (int index = 0; index < WGD->totalTimeIncrements; index++) {
-    // load data at
-    TGD->loadNetCDFData(index);
-    WGD->loadNetCDFData(index);
+    QESprofile::beginStep(index);
+    if (WGD_next) {
+      // keep the timesteps index and index + 1 resident
+      if (index == 0) {
+        TGD->loadNetCDFData(index);
+        WGD->loadNetCDFData(index);
+      } else {
+        // the next timestep becomes the current one
+        std::swap(WGD, WGD_next);
+        std::swap(TGD, TGD_next);
+      }
+      if (index + 1 < WGD->totalTimeIncrements) {
+        TGD_next->loadNetCDFData(index + 1);
+        WGD_next->loadNetCDFData(index + 1);
+      }
+      // the current pair is reloaded with index + 2 once rotated,
+      // read it in the background while the particles are advected
+      TGD->prefetchNetCDFData(index + 2);
+      WGD->prefetchNetCDFData(index + 2);
+    } else {
+      // load data at
+      TGD->loadNetCDFData(index);
+      WGD->loadNetCDFData(index);
+      // read the next step in the background while the particles are advected
+      TGD->prefetchNetCDFData(index + 1);
+      WGD->prefetchNetCDFData(index + 1);
+    }
 
     // Run plume advection model
     QEStime endtime;
@@ -112,16 +250,33 @@ int main(int argc, char **argv)
     } else {
       endtime = WGD->timestamp[index + 1];
     }
-    plume->run(endtime, WGD, TGD, outputVec);
+    // blend in time with the next timestep if it is resident
+    bool blend = (WGD_next && index + 1 < WGD->totalTimeIncrements);
+    if (ensemble) {
+      ensemble->run(endtime, WGD, TGD, blend ? WGD_next : nullptr, blend ? TGD_next : nullptr, ensembleOutputVec);
+    } else {
+      plume->run(endtime, WGD, TGD, blend ? WGD_next : nullptr, blend ? TGD_next : nullptr, outputVec);
+    }
 
     // compute run time information and print the elapsed execution time
     std::cout << "[QES-Plume] \t Finished." << std::endl;
   }
 
   std::cout << "End run particle summary \n";
-  plume->showCurrentStatus();
+  if (ensemble) {
+    ensemble->showCurrentStatus();
+  } else {
+    plume->showCurrentStatus();
+  }
   timers.printStoredTime("QES-Plume total runtime");
   std::cout << "##############################################################" << std::endl;
 
+  if (QESprofile::enabled() && mpiRank == 0) {
+    QESprofile::writeReport(arguments.profileFile);
+  }
+
+#ifdef HAS_MPI
+  MPI_Finalize();
+#endif
   exit(EXIT_SUCCESS);
 }
@@ -63,6 +63,8 @@ WINDSArgs::WINDSArgs()
 
   reg("turbcomp", "Turns on the computation of turbulent fields", ArgumentParsing::NONE, 't');
   reg("firemode", "Enable writing of wind data back to WRF Input file.", ArgumentParsing::NONE, 'f');
+
+  reg("profile", "write a profiling report (timers and counters per timestep) to the given .json or .csv file", ArgumentParsing::STRING, 'r');
 }
 
 void WINDSArgs::processArguments(int argc, char *argv[])
@@ -83,9 +85,17 @@ void WINDSArgs::processArguments(int argc, char *argv[])
 
   solveWind = !isSet("windsolveroff");
   isSet("solvetype", solveType);
+#ifndef HAS_MPI
+  if (solveType == Distributed_Type) {
+    QESout::warning("MPI is not supported in this build, using the CPU solver");
+    solveType = CPU_Type;
+  }
+#endif
 #ifndef HAS_CUDA
   // if CUDA is not supported, force the solveType to be CPU no matter
-  solveType = CPU_Type;
+  // (the distributed solver runs on the CPU)
+  if (solveType != Distributed_Type)
+    solveType = CPU_Type;
 #endif
 
   compTurb = isSet("turbcomp");
@@ -97,6 +107,8 @@ void WINDSArgs::processArguments(int argc, char *argv[])
     QESout::setVerbose();
   }
 
+  isSet("profile", profileFile);
+
   std::cout << "Summary of QES-WINDS options: " << std::endl;
   std::cout << "----------------------------" << std::endl;
 
@@ -113,6 +125,8 @@ void WINDSArgs::processArguments(int argc, char *argv[])
       std::cout << "Wind Solver:\t\t ON\t [Global memory solver (GPU)]" << std::endl;
     else if (solveType == Shared_M)
       std::cout << "Wind Solver:\t\t ON\t [Shared memory solver (GPU)]" << std::endl;
+    else if (solveType == Distributed_Type)
+      std::cout << "Wind Solver:\t\t ON\t [Distributed Red/Black solver (MPI)]" << std::endl;
     else
       std::cout << "[WARNING]\t the wind fields are not being calculated" << std::endl;
   }
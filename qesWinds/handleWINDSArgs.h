@@ -39,7 +39,8 @@
 enum solverTypes : int { CPU_Type = 1,
                          DYNAMIC_P = 2,
                          Global_M = 3,
-                         Shared_M = 4 };
+                         Shared_M = 4,
+                         Distributed_Type = 5 };
 
 /**
  * @class WINDSArgs
@@ -87,5 +88,7 @@ public:
 
   bool fireMode; /**< Boolean to treat WRF input in fire mode */
 
+  std::string profileFile = ""; /**< Profiling report file (empty -> profiling turned off) */
+
 private:
 };
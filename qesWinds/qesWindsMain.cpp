@@ -35,6 +35,7 @@
 
 #include "util/QESNetCDFOutput.h"
 #include "util/QESout.h"
+#include "util/QESprofile.h"
 
 #include "handleWINDSArgs.h"
 
@@ -49,6 +50,10 @@
 #include "winds/Solver.h"
 #include "winds/CPUSolver.h"
 #include "winds/Solver_CPU_RB.h"
+#ifdef HAS_MPI
+#include <mpi.h>
+#include "winds/Solver_MPI.h"
+#endif
 #ifdef HAS_CUDA
 #include "winds/DynamicParallelism.h"
 #include "winds/GlobalMemory.h"
@@ -58,7 +63,15 @@
 
 int main(int argc, char *argv[])
 {
-  QESout::splashScreen();
+  // rank of the process with the distributed solver (only the root writes the output files)
+  int mpiRank = 0;
+#ifdef HAS_MPI
+  MPI_Init(&argc, &argv);
+  MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
+#endif
+
+  if (mpiRank == 0)
+    QESout::splashScreen();
 
   // ///////////////////////////////////
   // Parse Command Line arguments
@@ -69,6 +82,22 @@ int main(int argc, char *argv[])
   // how to extend the arguments.
   WINDSArgs arguments;
   arguments.processArguments(argc, argv);
+  if (!arguments.profileFile.empty()) {
+    QESprofile::enable();
+  }
+
+#ifdef HAS_MPI
+  // distributed solver: only the root process builds the domain, the
+  // other processes hold their tile of the solver until the end of the run
+  if (arguments.solveType == Distributed_Type && mpiRank != 0) {
+    {
+      Solver_MPI tileSolver;
+      tileSolver.serve();
+    }
+    MPI_Finalize();
+    exit(EXIT_SUCCESS);
+  }
+#endif
 
   // ///////////////////////////////////
   // Read and Process any Input for the system
@@ -88,7 +117,7 @@ int main(int argc, char *argv[])
   }
 
 
-  if (arguments.terrainOut) {
+  if (arguments.terrainOut && mpiRank == 0) {
     if (WID->simParams->DTE_heightField) {
       std::cout << "Creating terrain OBJ....\n";
       WID->simParams->DTE_heightField->outputOBJ(arguments.filenameTerrain);
@@ -103,10 +132,10 @@ int main(int argc, char *argv[])
 
   // create WINDS output classes
   std::vector<QESNetCDFOutput *> outputVec;
-  if (arguments.visuOutput) {
+  if (arguments.visuOutput && mpiRank == 0) {
     outputVec.push_back(new WINDSOutputVisualization(WGD, WID, arguments.netCDFFileVisu));
   }
-  if (arguments.wkspOutput) {
+  if (arguments.wkspOutput && mpiRank == 0) {
     outputVec.push_back(new WINDSOutputWorkspace(WGD, arguments.netCDFFileWksp));
   }
 
@@ -116,7 +145,7 @@ int main(int argc, char *argv[])
   if (arguments.compTurb) {
     TGD = new TURBGeneralData(WID, WGD);
   }
-  if (arguments.compTurb && arguments.turbOutput) {
+  if (arguments.compTurb && arguments.turbOutput && mpiRank == 0) {
     outputVec.push_back(new TURBOutput(TGD, arguments.netCDFFileTurb));
   }
 
@@ -145,6 +174,11 @@ int main(int argc, char *argv[])
   } else if (arguments.solveType == Shared_M) {
     std::cout << "Run Shared Memory Solver (GPU) ..." << std::endl;
     solver = new SharedMemory(WID, WGD);
+#endif
+#ifdef HAS_MPI
+  } else if (arguments.solveType == Distributed_Type) {
+    std::cout << "Run Distributed Red/Black Solver (MPI) ..." << std::endl;
+    solver = new Solver_MPI(WID, WGD);
 #endif
   } else {
     QESout::error("Invalid solve type");
@@ -154,6 +188,7 @@ int main(int argc, char *argv[])
   int tempMaxIter = WID->simParams->maxIterations;
 
   for (int index = 0; index < WGD->totalTimeIncrements; index++) {
+    QESprofile::beginStep(index);
     // print time progress (time stamp and percentage)
     if (!WID->simParams->wrfCoupling) {
       WGD->printTimeProgress(index);
@@ -195,7 +230,7 @@ int main(int argc, char *argv[])
     // /////////////////////////////
     // WRF Coupling
     // /////////////////////////////
-    if (WID->simParams->wrfCoupling) {
+    if (WID->simParams->wrfCoupling && mpiRank == 0) {
       // send our stuff to wrf input file
       std::cout << "Writing data back to the WRF file." << std::endl;
       WID->simParams->wrfInputData->extractWind(WGD);
@@ -215,10 +250,20 @@ int main(int argc, char *argv[])
     }
   }
 
-  if (WID->simParams->wrfCoupling)
+  if (WID->simParams->wrfCoupling && mpiRank == 0)
     WID->simParams->wrfInputData->endWRFSession();
 
   // /////////////////////////////
   std::cout << "QES-Winds Exiting." << std::endl;
+  if (QESprofile::enabled() && mpiRank == 0) {
+    QESprofile::writeReport(arguments.profileFile);
+  }
+
+#ifdef HAS_MPI
+  if (arguments.solveType == Distributed_Type) {
+    static_cast<Solver_MPI *>(solver)->stop();
+  }
+  MPI_Finalize();
+#endif
   exit(EXIT_SUCCESS);
 }
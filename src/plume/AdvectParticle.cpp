@@ -32,6 +32,8 @@
 
 #include "Plume.hpp"
 
+#include "util/QESprofile.h"
+
 void Plume::advectParticle(double timeRemainder, Particle *par_ptr, double boxSizeZ, WINDSGeneralData *WGD, TURBGeneralData *TGD)
 {
   /*
@@ -129,6 +131,9 @@ void Plume::advectParticle(double timeRemainder, Particle *par_ptr, double boxSi
 
   double CoEps = 1e-6;
 
+  // length of the simulation timestep, used to know where each substep is in time
+  double timeStep = timeRemainder;
+
   // time to do a particle timestep loop. start the time remainder as the simulation timestep.
   // at each particle timestep loop iteration the time remainder gets closer and closer to zero.
   // the particle timestep for a given particle timestep loop is either the time remainder or the value calculated
@@ -139,14 +144,20 @@ void Plume::advectParticle(double timeRemainder, Particle *par_ptr, double boxSi
   //  for the last simulation timestep. The problem is that simTimes.at(nSimTimes-1) is greater than simTimes.at(nSimTimes-2) + sim_dt.
   // FMargairaz -> need clean-up the comment
 
+  // profiling counters for this particle
+  long nSubSteps = 0;
+
   while (isActive && timeRemainder > 0.0) {
+    nSubSteps++;
 
     /*
       now get the Lagrangian values for the current iteration from the Interperian grid
       will need to use the interp3D function
     */
 
-    interp->interpValues(xPos, yPos, zPos, WGD, uMean, vMean, wMean, TGD, txx, txy, txz, tyy, tyz, tzz, flux_div_x, flux_div_y, flux_div_z, nuT, CoEps);
+    // the fields are blended in time with the next stored timestep (if any)
+    double timeWeight = getTimeWeight(timeStep - timeRemainder);
+    interp->interpValuesInTime(xPos, yPos, zPos, WGD, TGD, WGD_next, TGD_next, timeWeight, uMean, vMean, wMean, txx, txy, txz, tyy, tyz, tzz, flux_div_x, flux_div_y, flux_div_z, nuT, CoEps);
 
     // now need to call makeRealizable on tau
     makeRealizable(txx, txy, txz, tyy, tyz, tzz);
@@ -344,6 +355,10 @@ void Plume::advectParticle(double timeRemainder, Particle *par_ptr, double boxSi
 
   }// while( isActive == true && timeRemainder > 0.0 )
 
+  if (QESprofile::enabled()) {
+    nSubStepsCount += nSubSteps;
+  }
+
   // now update the old values and current values in the dispersion storage to be ready for the next iteration
   // also throw in the already calculated velFluct increment
   // notice that the values from the particle timestep loop are used directly here,
@@ -62,6 +62,18 @@ public:
   float averagingStartTime{};// time to start concentration averaging, not the time to start output.
   float averagingPeriod{};// time averaging frequency and output frequency
 
+  // concentration estimator:
+  //  boxCount - the mass of a particle goes to the box it is in (default)
+  //  kernel - the mass of a particle is spread over the neighbouring boxes with a compact kernel
+  std::string concentrationEstimator = "boxCount";
+  // half-width of the kernel = kernelBandwidthFactor * sigma * travel time (in each direction),
+  // capped to kernelMaxBoxes boxes
+  float kernelBandwidthFactor = 0.1;
+  float kernelMaxBoxes = 3.0;
+  // output of the concentration on the collection boxes (can be turned off when only receptors are needed,
+  // the deposition is written with the boxes)
+  bool gridOutput = true;
+
   void parseValues() override
   {
     parsePrimitive<float>(true, averagingStartTime, "timeAvgStart");
@@ -75,6 +87,10 @@ public:
     parsePrimitive<int>(true, nBoxesX, "nBoxesX");
     parsePrimitive<int>(true, nBoxesY, "nBoxesY");
     parsePrimitive<int>(true, nBoxesZ, "nBoxesZ");
+    parsePrimitive<std::string>(false, concentrationEstimator, "concentrationEstimator");
+    parsePrimitive<float>(false, kernelBandwidthFactor, "kernelBandwidthFactor");
+    parsePrimitive<float>(false, kernelMaxBoxes, "kernelMaxBoxes");
+    parsePrimitive<bool>(false, gridOutput, "gridOutput");
 
     // check some of the parsed values to see if they make sense
     checkParsedValues();
@@ -155,5 +171,21 @@ public:
       std::cerr << " boxBoundsZ1 = \"" << boxBoundsZ1 << "\", boxBoundsZ2 = \"" << boxBoundsZ2 << "\"" << std::endl;
       exit(EXIT_FAILURE);
     }
+
+    if (concentrationEstimator != "boxCount" && concentrationEstimator != "kernel") {
+      std::cerr << "(CollectionParameters::checkParsedValues): input concentrationEstimator must be boxCount or kernel!";
+      std::cerr << " concentrationEstimator = \"" << concentrationEstimator << "\"" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (kernelBandwidthFactor < 0) {
+      std::cerr << "(CollectionParameters::checkParsedValues): input kernelBandwidthFactor must be zero or greater!";
+      std::cerr << " kernelBandwidthFactor = \"" << kernelBandwidthFactor << "\"" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (kernelMaxBoxes < 0) {
+      std::cerr << "(CollectionParameters::checkParsedValues): input kernelMaxBoxes must be zero or greater!";
+      std::cerr << " kernelMaxBoxes = \"" << kernelMaxBoxes << "\"" << std::endl;
+      exit(EXIT_FAILURE);
+    }
   }
 };
@@ -0,0 +1,105 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Plume
+ *
+ * GPL-3.0 License
+ *
+ * QES-Plume is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Plume is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Plume. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file ConcentrationKernel.cpp
+ * @brief Compact kernel spreading the mass of a particle over the concentration boxes
+ */
+
+#include "ConcentrationKernel.h"
+
+#include <algorithm>
+#include <cmath>
+
+ConcentrationKernel::ConcentrationKernel(const int &nBoxes, const float &lBnd, const float &boxSize, const bool &foldLower, const float &foldAt)
+  : m_nBoxes(nBoxes), m_lBnd(lBnd), m_boxSize(boxSize), m_foldLower(foldLower), m_foldAt(foldAt)
+{
+}
+
+double ConcentrationKernel::cdf(const double &u)
+{
+  if (u <= -1.0) {
+    return 0.0;
+  } else if (u >= 1.0) {
+    return 1.0;
+  }
+  return 0.5 + 0.75 * u - 0.25 * u * u * u;
+}
+
+double ConcentrationKernel::boxWeight(const int &i, const double &x, const double &h) const
+{
+  double a = m_lBnd + i * m_boxSize;
+  double b = a + m_boxSize;
+  if (!m_foldLower) {
+    return cdf((b - x) / h) - cdf((a - x) / h);
+  }
+  // only the part of the box above the reflection plane, where the mirror image of the
+  // kernel with respect to the plane is added
+  if (b <= m_foldAt) {
+    return 0.0;
+  }
+  a = std::max(a, m_foldAt);
+  double xm = 2.0 * m_foldAt - x;
+  return cdf((b - x) / h) - cdf((a - x) / h) + cdf((b - xm) / h) - cdf((a - xm) / h);
+}
+
+bool ConcentrationKernel::weights(const double &x, const double &h, int &first, std::vector<double> &w) const
+{
+  w.clear();
+  if (m_foldLower && x < m_foldAt) {
+    return false;
+  }
+
+  if (h <= 0.0) {
+    // degenerated kernel: box count (same convention as PlumeOutput::boxCount)
+    int id = std::floor((x - m_lBnd) / (m_boxSize + 1e-9));
+    if (id < 0 || id > m_nBoxes - 1) {
+      return false;
+    }
+    first = id;
+    w.push_back(1.0);
+    return true;
+  }
+
+  // boxes covered by the support [x - h, x + h] (the mirror image only reaches above the
+  // reflection plane when x - h is below it, and then stays below x + h)
+  int iStart = std::floor((x - h - m_lBnd) / m_boxSize);
+  int iEnd = std::ceil((x + h - m_lBnd) / m_boxSize) - 1;
+  iStart = (iStart < 0) ? 0 : iStart;
+  iEnd = (iEnd > m_nBoxes - 1) ? m_nBoxes - 1 : iEnd;
+  if (iStart > iEnd) {
+    return false;
+  }
+
+  first = iStart;
+  for (int i = iStart; i <= iEnd; ++i) {
+    w.push_back(boxWeight(i, x, h));
+  }
+  return true;
+}
@@ -0,0 +1,71 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Plume
+ *
+ * GPL-3.0 License
+ *
+ * QES-Plume is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Plume is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Plume. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file ConcentrationKernel.h
+ * @brief Compact kernel spreading the mass of a particle over the concentration boxes
+ */
+
+#pragma once
+
+#include <vector>
+
+// One direction of the concentration boxes (nBoxes boxes of size boxSize starting at lBnd).
+// The mass of a particle is spread with the Epanechnikov kernel K(u) = 3/4 (1 - u^2) of
+// half-width h. The weight of a box is the integral of the kernel over the box, so the weights
+// sum exactly to one (the part of the kernel outside of the boxes is lost, as a particle
+// outside of the boxes is with the box count) and h -> 0 gives back the box count.
+// With foldLower, the part of the kernel below the reflection plane foldAt (the ground) is
+// reflected back above it, so no mass is put below the plane.
+class ConcentrationKernel
+{
+public:
+  ConcentrationKernel()
+  {}
+  ConcentrationKernel(const int &nBoxes, const float &lBnd, const float &boxSize, const bool &foldLower, const float &foldAt = 0.0);
+  ~ConcentrationKernel()
+  {}
+
+  // compute the weights of the boxes covered by the kernel centered at x with half-width h:
+  // w[n] is the weight of the box first + n, only the boxes inside of the domain are listed.
+  // returns false if the kernel does not touch any box
+  bool weights(const double &x, const double &h, int &first, std::vector<double> &w) const;
+
+private:
+  // primitive of the kernel (cumulative distribution), u in units of the half-width
+  static double cdf(const double &u);
+  // weight of the box i for the kernel centered at x
+  double boxWeight(const int &i, const double &x, const double &h) const;
+
+  int m_nBoxes = 0;
+  double m_lBnd = 0.0;
+  double m_boxSize = 1.0;
+  bool m_foldLower = false;
+  double m_foldAt = 0.0;
+};
@@ -101,7 +101,7 @@ void Plume::depositParticle(double xPos, double yPos, double zPos, double disX,
 
       // add deposition amount to the buffer (for parallelization)
       par_ptr->dep_buffer_flag = true;
-      par_ptr->dep_buffer_cell.push_back(cellId_old);
+      par_ptr->dep_buffer_cell.push_back(deposition->domainCellId(cellId_old));
       par_ptr->dep_buffer_val.push_back((1.0 - P_v) * par_ptr->m);
       // deposition->depcvol[cellId_old] += (1.0 - P_v) * par_ptr->m;
 
@@ -124,7 +124,7 @@ void Plume::depositParticle(double xPos, double yPos, double zPos, double disX,
 
       // add deposition amount to the buffer (for parallelization)
       par_ptr->dep_buffer_flag = true;
-      par_ptr->dep_buffer_cell.push_back(cellId_old);
+      par_ptr->dep_buffer_cell.push_back(deposition->domainCellId(cellId_old));
       par_ptr->dep_buffer_val.push_back((1.0 - P_g) * par_ptr->m);
       // deposition->depcvol[cellId] += (1.0 - P_g) * par_ptr->m;
 
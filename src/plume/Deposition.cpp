@@ -36,13 +36,12 @@
 
 Deposition::Deposition(const WINDSGeneralData *WGD)
 {
-  numcell_cent = WGD->numcell_cent;
-
-  x.resize(WGD->nx - 1);
+  // the deposition grid covers the whole domain, even if WGD only holds a window of it
+  x.resize(WGD->x.size());
   for (auto k = 0u; k < x.size(); ++k) {
     x[k] = WGD->x[k];
   }
-  y.resize(WGD->ny - 1);
+  y.resize(WGD->y.size());
   for (auto k = 0u; k < y.size(); ++k) {
     y[k] = WGD->y[k];
   }
@@ -51,8 +50,14 @@ Deposition::Deposition(const WINDSGeneralData *WGD)
     z[k] = WGD->z[k];
   }
 
+  numcell_cent = x.size() * y.size() * z.size();
   depcvol.resize(numcell_cent, 0.0);
 
+  windowI0 = WGD->windowI0;
+  windowJ0 = WGD->windowJ0;
+  windowNx = WGD->nx - 1;
+  windowNy = WGD->ny - 1;
+
   nbrFace = WGD->wall_below_indices.size()
             + WGD->wall_above_indices.size()
             + WGD->wall_back_indices.size()
@@ -60,3 +65,12 @@ Deposition::Deposition(const WINDSGeneralData *WGD)
             + WGD->wall_left_indices.size()
             + WGD->wall_right_indices.size();
 }
+
+int Deposition::domainCellId(const int &cellId) const
+{
+  int k = cellId / (windowNx * windowNy);
+  int j = (cellId - k * windowNx * windowNy) / windowNx;
+  int i = cellId - j * windowNx - k * windowNx * windowNy;
+
+  return (i + windowI0) + (j + windowJ0) * (int)x.size() + k * (int)(x.size() * y.size());
+}
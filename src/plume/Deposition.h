@@ -78,4 +78,13 @@ public:
   std::vector<float> depcvol;
 
   int nbrFace;
+
+  // cell of the deposition grid (whole domain) of a cell of the fields of
+  // WINDSGeneralData, which may only cover a window of the domain
+  int domainCellId(const int &) const;
+
+private:
+  // window of the domain held by WINDSGeneralData (first cell and number of cells)
+  int windowI0 = 0, windowJ0 = 0;
+  int windowNx = 0, windowNy = 0;
 };
@@ -0,0 +1,341 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Plume
+ *
+ * GPL-3.0 License
+ *
+ * QES-Plume is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Plume is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Plume. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file DistributeParticles.cpp */
+
+#include "Plume.hpp"
+
+#include "ParticleTracer.hpp"
+#include "ParticleSmall.hpp"
+#include "ParticleLarge.hpp"
+#include "ParticleHeavyGas.hpp"
+
+#include "util/QESprofile.h"
+#include "util/NetCDFInput.h"
+
+#ifdef HAS_MPI
+#include <mpi.h>
+
+namespace {
+// the tiles follow the decomposition of the distributed wind solver (Solver_MPI):
+// the first (n % parts) blocks get one more cell
+int blockStart(int n, int parts, int b)
+{
+  return b * (n / parts) + std::min(b, n % parts);
+}
+
+// process grid of the tiles: the longest horizontal direction gets the most tiles
+void tileLayout(int nxc, int nyc, int nRanks, int dims[2])
+{
+  dims[0] = 0;
+  dims[1] = 0;
+  MPI_Dims_create(nRanks, 2, dims);
+  if ((nxc < nyc) == (dims[0] > dims[1])) {
+    std::swap(dims[0], dims[1]);
+  }
+}
+
+// writes the state of a particle to a buffer of doubles
+struct ParticlePacker
+{
+  std::vector<double> &buffer;
+  void operator()(double &v) { buffer.push_back(v); }
+  void operator()(int &v) { buffer.push_back(v); }
+  void operator()(bool &v) { buffer.push_back(v ? 1.0 : 0.0); }
+};
+
+// reads the state of a particle from a buffer of doubles
+struct ParticleUnpacker
+{
+  const double *ptr;
+  void operator()(double &v) { v = *ptr++; }
+  void operator()(int &v) { v = (int)*ptr++; }
+  void operator()(bool &v) { v = (*ptr++ != 0.0); }
+};
+
+Particle *newParticle(ParticleType type)
+{
+  switch (type) {
+  case ParticleType::small:
+    return new ParticleSmall();
+  case ParticleType::large:
+    return new ParticleLarge();
+  case ParticleType::heavygas:
+    return new ParticleHeavyGas();
+  default:
+    return new ParticleTracer();
+  }
+}
+}// namespace
+
+void Plume::distribute()
+{
+  MPI_Comm_size(MPI_COMM_WORLD, &mpiSize);
+  MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank);
+  if (mpiSize == 1) {
+    return;
+  }
+  distributed = true;
+
+  int nxc = nx - 1, nyc = ny - 1;
+  tileLayout(nxc, nyc, mpiSize, tileDims);
+  tileXbounds.resize(tileDims[0] + 1);
+  for (int b = 0; b <= tileDims[0]; ++b) {
+    tileXbounds[b] = blockStart(nxc, tileDims[0], b) * dx;
+  }
+  tileYbounds.resize(tileDims[1] + 1);
+  for (int b = 0; b <= tileDims[1]; ++b) {
+    tileYbounds[b] = blockStart(nyc, tileDims[1], b) * dy;
+  }
+
+  // the random generators share the drand48 state, use a different sequence on each process
+  srand48(long(time(nullptr)) ^ (long(mpiRank) << 20));
+
+  if (mpiRank == 0) {
+    std::cout << "[QES-Plume] \t Particles distributed over " << mpiSize << " processes ("
+              << tileDims[0] << " x " << tileDims[1] << " tiles)" << std::endl;
+  }
+
+  // particles released before the distribution
+  migrateParticles(particleList);
+}
+
+std::vector<int> Plume::tileWindow(const std::string &windsFile, const std::string &turbFile, const PlumeInputData *PID)
+{
+  int nRanks, rank;
+  MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  if (nRanks == 1) {
+    return {};
+  }
+
+  NetCDFInput winds(windsFile);
+  int nxf, nyf, nzf, ntw;
+  winds.getDimensionSize("x_face", nxf);
+  winds.getDimensionSize("y_face", nyf);
+  winds.getDimensionSize("z_face", nzf);
+  winds.getDimensionSize("t", ntw);
+  int nxc = nxf - 1, nyc = nyf - 1;
+  std::vector<float> x(nxc), y(nyc);
+  winds.getVariableData("x", x);
+  winds.getVariableData("y", y);
+  float dx = x[1] - x[0], dy = y[1] - y[0];
+
+  // tile of the process (same decomposition as distribute())
+  int dims[2];
+  tileLayout(nxc, nyc, nRanks, dims);
+  int bx = rank / dims[1], by = rank % dims[1];
+  int i0 = blockStart(nxc, dims[0], bx), i1 = blockStart(nxc, dims[0], bx + 1);
+  int j0 = blockStart(nyc, dims[1], by), j1 = blockStart(nyc, dims[1], by + 1);
+
+  // largest horizontal wind speed on the faces of the tile, over all the timesteps
+  double maxVel[2] = { 0.0, 0.0 };
+  std::vector<size_t> count_fc = { 1,
+                                   static_cast<unsigned long>(nzf),
+                                   static_cast<unsigned long>(j1 - j0 + 1),
+                                   static_cast<unsigned long>(i1 - i0 + 1) };
+  std::vector<float> buffer(nzf * (j1 - j0 + 1) * (i1 - i0 + 1));
+  for (int t = 0; t < ntw; ++t) {
+    std::vector<size_t> start = { static_cast<unsigned long>(t),
+                                  0,
+                                  static_cast<unsigned long>(j0),
+                                  static_cast<unsigned long>(i0) };
+    for (const std::string name : { "u", "v" }) {
+      winds.getVariableData(name, start, count_fc, buffer);
+      for (float it : buffer) {
+        maxVel[0] = std::max(maxVel[0], (double)std::abs(it));
+      }
+    }
+  }
+
+  // largest fluctuation on the cells of the tile (as getMaxVariance), over all the timesteps
+  NetCDFInput turb(turbFile);
+  int nzc, ntt;
+  turb.getDimensionSize("z", nzc);
+  turb.getDimensionSize("t", ntt);
+  std::vector<size_t> count_cc = { 1,
+                                   static_cast<unsigned long>(nzc),
+                                   static_cast<unsigned long>(j1 - j0),
+                                   static_cast<unsigned long>(i1 - i0) };
+  buffer.resize(nzc * (j1 - j0) * (i1 - i0));
+  for (int t = 0; t < ntt; ++t) {
+    std::vector<size_t> start = { static_cast<unsigned long>(t),
+                                  0,
+                                  static_cast<unsigned long>(j0),
+                                  static_cast<unsigned long>(i0) };
+    for (const std::string name : { "txx", "tyy", "tzz" }) {
+      turb.getVariableData(name, start, count_cc, buffer);
+      for (float it : buffer) {
+        maxVel[1] = std::max(maxVel[1], (double)std::sqrt(std::abs(it)));
+      }
+    }
+  }
+  MPI_Allreduce(MPI_IN_PLACE, maxVel, 2, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+  // travel over one timestep: mean wind plus the fluctuations below the rogue threshold (10 x the largest
+  // standard deviation, see Plume::run), the particles are migrated to their tile at each timestep;
+  // the extra cells cover the interpolation stencil and the stress gradients at the edge of the window
+  double travel = PID->plumeParams->timeStep * (maxVel[0] + 10.0 * maxVel[1]);
+  int haloX = (int)std::ceil(travel / dx) + 3;
+  int haloY = (int)std::ceil(travel / dy) + 3;
+
+  std::vector<int> window = { std::max(i0 - haloX, 0), std::min(i1 + haloX, nxc),
+                              std::max(j0 - haloY, 0), std::min(j1 + haloY, nyc) };
+  // periodic boundaries: the particles wrap around the domain
+  if (PID->BCs->xBCtype == "periodic") {
+    window[0] = 0;
+    window[1] = nxc;
+  }
+  if (PID->BCs->yBCtype == "periodic") {
+    window[2] = 0;
+    window[3] = nyc;
+  }
+
+  if (rank == 0) {
+    std::cout << "[QES-Plume] \t Fields loaded on the tile of each process plus a halo of "
+              << haloX << " x " << haloY << " cells" << std::endl;
+  }
+  return window;
+}
+
+int Plume::tileOwner(const Particle *par_ptr) const
+{
+  // tile containing the particle (particles outside the domain belong to the closest tile)
+  int bx = std::upper_bound(tileXbounds.begin() + 1, tileXbounds.end() - 1, par_ptr->xPos) - (tileXbounds.begin() + 1);
+  int by = std::upper_bound(tileYbounds.begin() + 1, tileYbounds.end() - 1, par_ptr->yPos) - (tileYbounds.begin() + 1);
+  // row-major ranks, as MPI_Cart_create without reordering
+  return bx * tileDims[1] + by;
+}
+
+void Plume::migrateParticles(std::list<Particle *> &particles)
+{
+  // pack the particles leaving the tile, per destination
+  std::vector<std::vector<double>> outgoing(mpiSize);
+  for (auto parItr = particles.begin(); parItr != particles.end();) {
+    int owner = tileOwner(*parItr);
+    if (owner != mpiRank) {
+      ParticlePacker pack = { outgoing[owner] };
+      pack.buffer.push_back((*parItr)->particleType);
+      (*parItr)->forEachState(pack);
+      delete *parItr;
+      parItr = particles.erase(parItr);
+    } else {
+      ++parItr;
+    }
+  }
+
+  // one batched exchange between all the processes
+  std::vector<int> sendCounts(mpiSize), sendDispls(mpiSize), recvCounts(mpiSize), recvDispls(mpiSize);
+  std::vector<double> sendBuf;
+  for (int r = 0; r < mpiSize; ++r) {
+    sendCounts[r] = outgoing[r].size();
+    sendDispls[r] = sendBuf.size();
+    sendBuf.insert(sendBuf.end(), outgoing[r].begin(), outgoing[r].end());
+  }
+  MPI_Alltoall(sendCounts.data(), 1, MPI_INT, recvCounts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+  int nRecv = 0;
+  for (int r = 0; r < mpiSize; ++r) {
+    recvDispls[r] = nRecv;
+    nRecv += recvCounts[r];
+  }
+  std::vector<double> recvBuf(nRecv);
+  MPI_Alltoallv(sendBuf.data(), sendCounts.data(), sendDispls.data(), MPI_DOUBLE,
+                recvBuf.data(), recvCounts.data(), recvDispls.data(), MPI_DOUBLE, MPI_COMM_WORLD);
+
+  // unpack the particles entering the tile
+  long nMigrated = 0;
+  ParticleUnpacker unpack = { recvBuf.data() };
+  while (unpack.ptr < recvBuf.data() + nRecv) {
+    Particle *par_ptr = newParticle((ParticleType)(int)*unpack.ptr++);
+    par_ptr->forEachState(unpack);
+    particles.push_back(par_ptr);
+    nMigrated++;
+  }
+  QESprofile::addCount("plume/particles_migrated", nMigrated);
+}
+
+double Plume::maxOverProcesses(double value) const
+{
+  MPI_Allreduce(MPI_IN_PLACE, &value, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+  return value;
+}
+
+void Plume::sumOnRoot(std::vector<int> &field)
+{
+  if (!distributed) {
+    return;
+  }
+  MPI_Reduce(mpiRank == 0 ? MPI_IN_PLACE : field.data(), field.data(), field.size(), MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
+}
+
+void Plume::sumOnRoot(std::vector<float> &field)
+{
+  if (!distributed) {
+    return;
+  }
+  MPI_Reduce(mpiRank == 0 ? MPI_IN_PLACE : field.data(), field.data(), field.size(), MPI_FLOAT, MPI_SUM, 0, MPI_COMM_WORLD);
+}
+
+#else
+
+// without MPI there is a single process: nothing to distribute
+
+void Plume::distribute()
+{
+}
+
+int Plume::tileOwner(const Particle *) const
+{
+  return 0;
+}
+
+std::vector<int> Plume::tileWindow(const std::string &, const std::string &, const PlumeInputData *)
+{
+  return {};
+}
+
+void Plume::migrateParticles(std::list<Particle *> &)
+{
+}
+
+double Plume::maxOverProcesses(double value) const
+{
+  return value;
+}
+
+void Plume::sumOnRoot(std::vector<int> &)
+{
+}
+
+void Plume::sumOnRoot(std::vector<float> &)
+{
+}
+
+#endif
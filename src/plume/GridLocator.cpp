@@ -0,0 +1,68 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Plume
+ *
+ * GPL-3.0 License
+ *
+ * QES-Plume is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Plume is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Plume. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file GridLocator.cpp */
+
+#include "GridLocator.h"
+
+#include <cmath>
+#include <limits>
+
+GridLocator::GridLocator(const std::vector<float> &nodes)
+  : m_nodes(nodes), m_size(nodes.size())
+{
+  if (m_size < 2) {
+    m_table.assign(1, m_size);
+    return;
+  }
+
+  // bin width: half of the smallest spacing between two nodes
+  double minSpacing = std::numeric_limits<double>::max();
+  for (int k = 0; k < m_size - 1; ++k) {
+    double spacing = m_nodes[k + 1] - m_nodes[k];
+    if (spacing > 0.0 && spacing < minSpacing) {
+      minSpacing = spacing;
+    }
+  }
+  m_start = m_nodes[0];
+  m_invWidth = 2.0 / minSpacing;
+  m_nBins = (int)((m_nodes[m_size - 1] - m_start) * m_invWidth) + 1;
+
+  // m_table[b] = number of nodes in the bins before b (the bins of the nodes are computed
+  // with the same arithmetic as the queries, which keeps the lookup exact)
+  m_table.assign(m_nBins + 1, 0);
+  for (int k = 0; k < m_size; ++k) {
+    double b = (m_nodes[k] - m_start) * m_invWidth;
+    m_table[(b > 0.0) ? (int)b + 1 : 1]++;
+  }
+  for (int b = 0; b < m_nBins; ++b) {
+    m_table[b + 1] += m_table[b];
+  }
+}
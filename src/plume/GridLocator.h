@@ -0,0 +1,98 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Plume
+ *
+ * GPL-3.0 License
+ *
+ * QES-Plume is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Plume is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Plume. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file GridLocator.h
+ * @brief O(1) location of a height on the (possibly stretched) vertical grid
+ */
+
+#pragma once
+
+#include <vector>
+
+// Locates a height on a monotonic list of nodes (z or z_face of the WINDS grid) without a
+// binary search: the heights are binned uniformly with a bin width of half the smallest node
+// spacing, so that a bin and the next one hold at most one node. The index of the interval is
+// read from the table of the bin and corrected with a single comparison, which is exact for
+// any stretching of the grid.
+class GridLocator
+{
+public:
+  GridLocator()
+  {}
+  GridLocator(const std::vector<float> &nodes);
+  ~GridLocator()
+  {}
+
+  // number of nodes strictly below z minus 1 (same as std::lower_bound(z) - begin - 1):
+  // nodes[k] < z <= nodes[k + 1]
+  int lowerIndex(const double &z) const
+  {
+    int n = countBelow(z);
+    return ((n < m_size && m_nodes[n] < z) ? n + 1 : n) - 1;
+  }
+
+  // number of nodes lower or equal to z minus 1 (same as std::upper_bound(z) - begin - 1):
+  // nodes[k] <= z < nodes[k + 1]
+  int upperIndex(const double &z) const
+  {
+    int n = countBelow(z);
+    return ((n < m_size && m_nodes[n] <= z) ? n + 1 : n) - 1;
+  }
+
+  // index k with nodes[k] < z <= nodes[k + 1] and the fractional distance between the two nodes
+  void interval(const double &z, int &k, double &w) const
+  {
+    k = lowerIndex(z);
+    w = (z - m_nodes[k]) / (m_nodes[k + 1] - m_nodes[k]);
+  }
+
+private:
+  // number of nodes strictly below the start of the bin of z
+  int countBelow(const double &z) const
+  {
+    double b = (z - m_start) * m_invWidth;
+    if (!(b > 0.0)) {
+      return 0;
+    }
+    if (b >= m_nBins) {
+      return m_table.back();
+    }
+    return m_table[(int)b];
+  }
+
+  std::vector<float> m_nodes;
+  int m_size = 0;
+
+  // uniform bins over the nodes
+  double m_start = 0.0;
+  double m_invWidth = 0.0;
+  int m_nBins = 0;
+  std::vector<int> m_table;
+};
@@ -46,13 +46,21 @@ Interp::Interp(WINDSGeneralData *WGD)
   dy = WGD->dy;
   dx = WGD->dx;
 
-  // domain beginning for interpolation in each direction
+  // vertical grid locators (stretched grids from dz_array)
+  zCellLocator = GridLocator(WGD->z);
+  zFaceLocator = GridLocator(WGD->z_face);
+
+  // the fields may only cover a window of the domain (x and y always cover the whole domain)
+  iOrigin = WGD->windowI0;
+  jOrigin = WGD->windowJ0;
+
+  // domain beginning for interpolation in each direction (indices of the whole domain)
   // in x-direction (halo cell to account for TURB variables)
   iStart = 1;
-  iEnd = nx - 3;
+  iEnd = WGD->x.size() - 2;
   // in y-direction (halo cell to account for TURB variables)
   jStart = 1;
-  jEnd = ny - 3;
+  jEnd = WGD->y.size() - 2;
   // in z-direction (ghost cell at bottom and halo cell at top)
   kStart = 1;
   kEnd = nz - 2;
@@ -68,3 +76,110 @@ Interp::Interp(WINDSGeneralData *WGD)
   zStart = WGD->z_face[kStart];
   zEnd = WGD->z_face[kEnd];
 }
+
+void Interp::interpValuesInTime(const double &xPos,
+                                const double &yPos,
+                                const double &zPos,
+                                const WINDSGeneralData *WGD0,
+                                const TURBGeneralData *TGD0,
+                                const WINDSGeneralData *WGD1,
+                                const TURBGeneralData *TGD1,
+                                const double &weight,
+                                double &uMean_out,
+                                double &vMean_out,
+                                double &wMean_out,
+                                double &txx_out,
+                                double &txy_out,
+                                double &txz_out,
+                                double &tyy_out,
+                                double &tyz_out,
+                                double &tzz_out,
+                                double &flux_div_x_out,
+                                double &flux_div_y_out,
+                                double &flux_div_z_out,
+                                double &nuT_out,
+                                double &CoEps_out)
+{
+  interpValues(xPos, yPos, zPos, WGD0, uMean_out, vMean_out, wMean_out, TGD0, txx_out, txy_out, txz_out, tyy_out, tyz_out, tzz_out, flux_div_x_out, flux_div_y_out, flux_div_z_out, nuT_out, CoEps_out);
+
+  if (weight <= 0.0 || !WGD1 || !TGD1) {
+    return;
+  }
+
+  double uMean1, vMean1, wMean1;
+  double txx1, txy1, txz1, tyy1, tyz1, tzz1;
+  double flux_div_x1, flux_div_y1, flux_div_z1;
+  double nuT1, CoEps1;
+  interpValues(xPos, yPos, zPos, WGD1, uMean1, vMean1, wMean1, TGD1, txx1, txy1, txz1, tyy1, tyz1, tzz1, flux_div_x1, flux_div_y1, flux_div_z1, nuT1, CoEps1);
+
+  // weight of the first timestep
+  double w0 = 1.0 - weight;
+
+  uMean_out = w0 * uMean_out + weight * uMean1;
+  vMean_out = w0 * vMean_out + weight * vMean1;
+  wMean_out = w0 * wMean_out + weight * wMean1;
+
+  txx_out = w0 * txx_out + weight * txx1;
+  txy_out = w0 * txy_out + weight * txy1;
+  txz_out = w0 * txz_out + weight * txz1;
+  tyy_out = w0 * tyy_out + weight * tyy1;
+  tyz_out = w0 * tyz_out + weight * tyz1;
+  tzz_out = w0 * tzz_out + weight * tzz1;
+
+  flux_div_x_out = w0 * flux_div_x_out + weight * flux_div_x1;
+  flux_div_y_out = w0 * flux_div_y_out + weight * flux_div_y1;
+  flux_div_z_out = w0 * flux_div_z_out + weight * flux_div_z1;
+
+  nuT_out = w0 * nuT_out + weight * nuT1;
+  // both values are already bounded away from zero by the interpolation
+  CoEps_out = w0 * CoEps_out + weight * CoEps1;
+}
+
+void Interp::interpInitialValuesInTime(const double &xPos,
+                                       const double &yPos,
+                                       const double &zPos,
+                                       const TURBGeneralData *TGD0,
+                                       const TURBGeneralData *TGD1,
+                                       const double &weight,
+                                       double &sig_x_out,
+                                       double &sig_y_out,
+                                       double &sig_z_out,
+                                       double &txx_out,
+                                       double &txy_out,
+                                       double &txz_out,
+                                       double &tyy_out,
+                                       double &tyz_out,
+                                       double &tzz_out)
+{
+  interpInitialValues(xPos, yPos, zPos, TGD0, sig_x_out, sig_y_out, sig_z_out, txx_out, txy_out, txz_out, tyy_out, tyz_out, tzz_out);
+
+  if (weight <= 0.0 || !TGD1) {
+    return;
+  }
+
+  double sig_x1, sig_y1, sig_z1;
+  double txx1, txy1, txz1, tyy1, tyz1, tzz1;
+  interpInitialValues(xPos, yPos, zPos, TGD1, sig_x1, sig_y1, sig_z1, txx1, txy1, txz1, tyy1, tyz1, tzz1);
+
+  // weight of the first timestep
+  double w0 = 1.0 - weight;
+
+  // the stress tensor is blended linearly, the sigmas are recomputed from the
+  // blended normal stresses to stay consistent with it
+  txx_out = w0 * txx_out + weight * txx1;
+  txy_out = w0 * txy_out + weight * txy1;
+  txz_out = w0 * txz_out + weight * txz1;
+  tyy_out = w0 * tyy_out + weight * tyy1;
+  tyz_out = w0 * tyz_out + weight * tyz1;
+  tzz_out = w0 * tzz_out + weight * tzz1;
+
+  sig_x_out = std::sqrt(std::abs(txx_out));
+  if (sig_x_out == 0.0)
+    sig_x_out = 1e-8;
+  sig_y_out = std::sqrt(std::abs(tyy_out));
+  if (sig_y_out == 0.0)
+    sig_y_out = 1e-8;
+  sig_z_out = std::sqrt(std::abs(tzz_out));
+  if (sig_z_out == 0.0)
+    sig_z_out = 1e-8;
+}
@@ -47,6 +47,8 @@
 #include "util/Vector3.h"
 #include "util/Vector3Double.h"
 
+#include "GridLocator.h"
+
 #include "PlumeInputData.hpp"
 #include "winds/WINDSGeneralData.h"
 #include "winds/TURBGeneralData.h"
@@ -103,6 +105,48 @@ public:
                                    double &tyz_out,
                                    double &tzz_out) = 0;
 
+  // blends linearly in time the values interpolated on two resident timesteps:
+  // out = (1 - weight) * interp(WGD0, TGD0) + weight * interp(WGD1, TGD1)
+  // the second timestep is skipped when weight is zero or WGD1/TGD1 are null.
+  void interpValuesInTime(const double &xPos,
+                          const double &yPos,
+                          const double &zPos,
+                          const WINDSGeneralData *WGD0,
+                          const TURBGeneralData *TGD0,
+                          const WINDSGeneralData *WGD1,
+                          const TURBGeneralData *TGD1,
+                          const double &weight,
+                          double &uMean_out,
+                          double &vMean_out,
+                          double &wMean_out,
+                          double &txx_out,
+                          double &txy_out,
+                          double &txz_out,
+                          double &tyy_out,
+                          double &tyz_out,
+                          double &tzz_out,
+                          double &flux_div_x_out,
+                          double &flux_div_y_out,
+                          double &flux_div_z_out,
+                          double &nuT_out,
+                          double &CoEps_out);
+
+  void interpInitialValuesInTime(const double &xPos,
+                                 const double &yPos,
+                                 const double &zPos,
+                                 const TURBGeneralData *TGD0,
+                                 const TURBGeneralData *TGD1,
+                                 const double &weight,
+                                 double &sig_x_out,
+                                 double &sig_y_out,
+                                 double &sig_z_out,
+                                 double &txx_out,
+                                 double &txy_out,
+                                 double &txz_out,
+                                 double &tyy_out,
+                                 double &tyz_out,
+                                 double &tzz_out);
+
   int getCellId(const double &, const double &, const double &);
   int getCellId(Vector3Double &);
   int getCellId2d(const double &, const double &);
@@ -120,6 +164,14 @@ protected:
   double dy;
   double dz;
 
+  // O(1) location on the vertical grid (exact for stretched grids), built once
+  GridLocator zCellLocator;// cell-centers (z)
+  GridLocator zFaceLocator;// faces (z_face)
+
+  // first cell of the fields of WINDSGeneralData in x and y (not 0 when
+  // it only holds a window of the domain): the indices are local to the window
+  int iOrigin = 0, jOrigin = 0;
+
   // index of domain bounds
   int iStart, iEnd;
   int jStart, jEnd;
@@ -137,9 +189,9 @@ protected:
 
 inline int Interp::getCellId(const double &xPos, const double &yPos, const double &zPos)
 {
-  int i = floor((xPos - 0.0 * dx) / (dx + 1e-9));
-  int j = floor((yPos - 0.0 * dy) / (dy + 1e-9));
-  int k = floor((zPos + 1.0 * dz) / (dz + 1e-9));
+  int i = floor((xPos - 0.0 * dx) / (dx + 1e-9)) - iOrigin;
+  int j = floor((yPos - 0.0 * dy) / (dy + 1e-9)) - jOrigin;
+  int k = zFaceLocator.upperIndex(zPos);
 
   return i + j * (nx - 1) + k * (nx - 1) * (ny - 1);
 }
@@ -150,17 +202,17 @@ inline int Interp::getCellId(Vector3Double &X)
   // int j = floor((yPos - yStart + 0.5*dy)/(dy+1e-9));
   // int k = floor((zPos - zStart + dz)/(dz+1e-9));
 
-  int i = floor((X[0] - 0.0 * dx) / (dx + 1e-9));
-  int j = floor((X[1] - 0.0 * dy) / (dy + 1e-9));
-  int k = floor((X[2] + 1.0 * dz) / (dz + 1e-9));
+  int i = floor((X[0] - 0.0 * dx) / (dx + 1e-9)) - iOrigin;
+  int j = floor((X[1] - 0.0 * dy) / (dy + 1e-9)) - jOrigin;
+  int k = zFaceLocator.upperIndex(X[2]);
 
   return i + j * (nx - 1) + k * (nx - 1) * (ny - 1);
 }
 
 inline int Interp::getCellId2d(const double &xPos, const double &yPos)
 {
-  int i = floor((xPos - 0.0 * dx) / (dx + 1e-9));
-  int j = floor((yPos - 0.0 * dy) / (dy + 1e-9));
+  int i = floor((xPos - 0.0 * dx) / (dx + 1e-9)) - iOrigin;
+  int j = floor((yPos - 0.0 * dy) / (dy + 1e-9)) - jOrigin;
 
   return i + j * (nx - 1);
 }
@@ -74,12 +74,12 @@ void InterpNearestCell::interpInitialValues(const double &xPos,
                + cellIndex[2] * (nx - 1) * (ny - 1);
 
   // this is the current reynolds stress tensor
-  txx_out = TGD->txx[cellId];
-  txy_out = TGD->txy[cellId];
-  txz_out = TGD->txz[cellId];
-  tyy_out = TGD->tyy[cellId];
-  tyz_out = TGD->tyz[cellId];
-  tzz_out = TGD->tzz[cellId];
+  txx_out = TGD->txxView()[cellId];
+  txy_out = TGD->txyView()[cellId];
+  txz_out = TGD->txzView()[cellId];
+  tyy_out = TGD->tyyView()[cellId];
+  tyz_out = TGD->tyzView()[cellId];
+  tzz_out = TGD->tzzView()[cellId];
 
   sig_x_out = std::sqrt(std::abs(txx_out));
   if (sig_x_out == 0.0)
@@ -123,23 +123,23 @@ void InterpNearestCell::interpValues(const double &xPos,
                + cellIndex[1] * WGD->nx
                + cellIndex[2] * WGD->nx * WGD->ny;
 
-  uMean_out = 0.5 * (WGD->u[faceId] + WGD->u[faceId + 1]);
-  vMean_out = 0.5 * (WGD->v[faceId] + WGD->v[faceId + WGD->nx]);
-  vMean_out = 0.5 * (WGD->w[faceId] + WGD->w[faceId + WGD->nx * WGD->ny]);
+  uMean_out = 0.5 * (WGD->uView()[faceId] + WGD->uView()[faceId + 1]);
+  vMean_out = 0.5 * (WGD->vView()[faceId] + WGD->vView()[faceId + WGD->nx]);
+  vMean_out = 0.5 * (WGD->wView()[faceId] + WGD->wView()[faceId + WGD->nx * WGD->ny]);
 
-  CoEps_out = TGD->CoEps[cellId];
+  CoEps_out = TGD->CoEpsView()[cellId];
   // make sure CoEps is always bigger than zero
   if (CoEps_out <= 1e-6) {
     CoEps_out = 1e-6;
   }
 
   // this is the current reynolds stress tensor
-  txx_out = TGD->txx[cellId];
-  txy_out = TGD->txy[cellId];
-  txz_out = TGD->txz[cellId];
-  tyy_out = TGD->tyy[cellId];
-  tyz_out = TGD->tyz[cellId];
-  tzz_out = TGD->tzz[cellId];
+  txx_out = TGD->txxView()[cellId];
+  txy_out = TGD->txyView()[cellId];
+  txz_out = TGD->txzView()[cellId];
+  tyy_out = TGD->tyyView()[cellId];
+  tyz_out = TGD->tyzView()[cellId];
+  tzz_out = TGD->tzzView()[cellId];
 
 
   flux_div_x_out = TGD->div_tau_x[cellId];
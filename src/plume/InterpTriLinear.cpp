@@ -73,12 +73,12 @@ void InterpTriLinear::interpInitialValues(const double &xPos,
   setInterp3Dindex_cellVar(xPos, yPos, zPos, wgt);
 
   // get the tau values from the InterpTriLinear grid for the particle value
-  interp3D_cellVar(TGD->txx, wgt, txx_out);
-  interp3D_cellVar(TGD->txy, wgt, txy_out);
-  interp3D_cellVar(TGD->txz, wgt, txz_out);
-  interp3D_cellVar(TGD->tyy, wgt, tyy_out);
-  interp3D_cellVar(TGD->tyz, wgt, tyz_out);
-  interp3D_cellVar(TGD->tzz, wgt, tzz_out);
+  interp3D_cellVar(TGD->txxView(), wgt, txx_out);
+  interp3D_cellVar(TGD->txyView(), wgt, txy_out);
+  interp3D_cellVar(TGD->txzView(), wgt, txz_out);
+  interp3D_cellVar(TGD->tyyView(), wgt, tyy_out);
+  interp3D_cellVar(TGD->tyzView(), wgt, tyz_out);
+  interp3D_cellVar(TGD->tzzView(), wgt, tzz_out);
 
   sig_x_out = std::sqrt(std::abs(txx_out));
   if (sig_x_out == 0.0)
@@ -117,36 +117,36 @@ void InterpTriLinear::interpValues(const double &xPos,
   // set interpolation indexing variables for uFace variables
   setInterp3Dindex_uFace(xPos, yPos, zPos, wgt);
   // interpolation of variables on uFace
-  interp3D_faceVar(WGD->u, wgt, uMean_out);
+  interp3D_faceVar(WGD->uView(), wgt, uMean_out);
 
   // set interpolation indexing variables for vFace variables
   setInterp3Dindex_vFace(xPos, yPos, zPos, wgt);
   // interpolation of variables on vFace
-  interp3D_faceVar(WGD->v, wgt, vMean_out);
+  interp3D_faceVar(WGD->vView(), wgt, vMean_out);
 
   // set interpolation indexing variables for wFace variables
   setInterp3Dindex_wFace(xPos, yPos, zPos, wgt);
   // interpolation of variables on wFace
-  interp3D_faceVar(WGD->w, wgt, wMean_out);
+  interp3D_faceVar(WGD->wView(), wgt, wMean_out);
 
   // this replaces the old indexing trick, set the indexing variables for the interp3D for each particle,
   // then get interpolated values from the InterpTriLinear grid to the particle Lagrangian values for multiple datatype
   setInterp3Dindex_cellVar(xPos, yPos, zPos, wgt);
 
   // this is the CoEps for the particle
-  interp3D_cellVar(TGD->CoEps, wgt, CoEps_out);
+  interp3D_cellVar(TGD->CoEpsView(), wgt, CoEps_out);
   // make sure CoEps is always bigger than zero
   if (CoEps_out <= 1e-6) {
     CoEps_out = 1e-6;
   }
 
   // this is the current reynolds stress tensor
-  interp3D_cellVar(TGD->txx, wgt, txx_out);
-  interp3D_cellVar(TGD->txy, wgt, txy_out);
-  interp3D_cellVar(TGD->txz, wgt, txz_out);
-  interp3D_cellVar(TGD->tyy, wgt, tyy_out);
-  interp3D_cellVar(TGD->tyz, wgt, tyz_out);
-  interp3D_cellVar(TGD->tzz, wgt, tzz_out);
+  interp3D_cellVar(TGD->txxView(), wgt, txx_out);
+  interp3D_cellVar(TGD->txyView(), wgt, txy_out);
+  interp3D_cellVar(TGD->txzView(), wgt, txz_out);
+  interp3D_cellVar(TGD->tyyView(), wgt, tyy_out);
+  interp3D_cellVar(TGD->tyzView(), wgt, tyz_out);
+  interp3D_cellVar(TGD->tzzView(), wgt, tzz_out);
 
 
   interp3D_cellVar(TGD->div_tau_x, wgt, flux_div_x_out);
@@ -170,8 +170,8 @@ void InterpTriLinear::setInterp3Dindex_uFace(const double &par_xPos,
   double par_y = par_yPos - 0.5 * dy;
   // double par_z = par_zPos + 0.5 * dz;
 
-  wgt.ii = floor(par_x / (dx + 1e-7));
-  wgt.jj = floor(par_y / (dy + 1e-7));
+  wgt.ii = floor(par_x / (dx + 1e-7)) - iOrigin;
+  wgt.jj = floor(par_y / (dy + 1e-7)) - jOrigin;
   // wgt.kk = floor(par_z / (dz + 1e-7));
 
   // fractional distance between the nearest nodes
@@ -179,10 +179,7 @@ void InterpTriLinear::setInterp3Dindex_uFace(const double &par_xPos,
   wgt.jw = (par_y / dy) - floor(par_y / (dy + 1e-7));
   // wgt.kw = (par_z / dz) - floor(par_z / (dz + 1e-7));
 
-  auto itr = std::lower_bound(m_WGD->z.begin(), m_WGD->z.end(), par_zPos);
-  wgt.kk = itr - m_WGD->z.begin() - 1;
-
-  wgt.kw = (par_zPos - m_WGD->z[wgt.kk]) / (m_WGD->z[wgt.kk + 1] - m_WGD->z[wgt.kk]);
+  zCellLocator.interval(par_zPos, wgt.kk, wgt.kw);
 }
 
 
@@ -200,8 +197,8 @@ void InterpTriLinear::setInterp3Dindex_vFace(const double &par_xPos,
   double par_y = par_yPos - 0.0 * dy;
   // double par_z = par_zPos + 0.5 * dz;
 
-  wgt.ii = floor(par_x / (dx + 1e-7));
-  wgt.jj = floor(par_y / (dy + 1e-7));
+  wgt.ii = floor(par_x / (dx + 1e-7)) - iOrigin;
+  wgt.jj = floor(par_y / (dy + 1e-7)) - jOrigin;
   // wgt.kk = floor(par_z / (dz + 1e-7));
 
   // fractional distance between the nearest nodes
@@ -209,10 +206,7 @@ void InterpTriLinear::setInterp3Dindex_vFace(const double &par_xPos,
   wgt.jw = (par_y / dy) - floor(par_y / (dy + 1e-4));
   // wgt.kw = (par_z / dz) - floor(par_z / (dz + 1e-4));
 
-  auto itr = std::lower_bound(m_WGD->z.begin(), m_WGD->z.end(), par_zPos);
-  wgt.kk = itr - m_WGD->z.begin() - 1;
-
-  wgt.kw = (par_zPos - m_WGD->z[wgt.kk]) / (m_WGD->z[wgt.kk + 1] - m_WGD->z[wgt.kk]);
+  zCellLocator.interval(par_zPos, wgt.kk, wgt.kw);
 }
 
 void InterpTriLinear::setInterp3Dindex_wFace(const double &par_xPos,
@@ -229,8 +223,8 @@ void InterpTriLinear::setInterp3Dindex_wFace(const double &par_xPos,
   double par_y = par_yPos - 0.5 * dy;
   // double par_z = par_zPos + 1.0 * dz;
 
-  wgt.ii = floor(par_x / (dx + 1e-7));
-  wgt.jj = floor(par_y / (dy + 1e-7));
+  wgt.ii = floor(par_x / (dx + 1e-7)) - iOrigin;
+  wgt.jj = floor(par_y / (dy + 1e-7)) - jOrigin;
   // wgt.kk = floor(par_z / (dz + 1e-7));
 
   // fractional distance between the nearest nodes
@@ -238,14 +232,11 @@ void InterpTriLinear::setInterp3Dindex_wFace(const double &par_xPos,
   wgt.jw = (par_y / dy) - floor(par_y / (dy + 1e-7));
   // wgt.kw = (par_z / dz) - floor(par_z / (dz + 1e-7));
 
-  auto itr = std::lower_bound(m_WGD->z_face.begin(), m_WGD->z_face.end(), par_zPos);
-  wgt.kk = itr - m_WGD->z_face.begin() - 1;
-
-  wgt.kw = (par_zPos - m_WGD->z_face[wgt.kk]) / (m_WGD->z_face[wgt.kk + 1] - m_WGD->z_face[wgt.kk]);
+  zFaceLocator.interval(par_zPos, wgt.kk, wgt.kw);
 }
 
 // always call this after setting the interpolation indices with the setInterp3Dindex_u/v/wFace() function!
-void InterpTriLinear::interp3D_faceVar(const std::vector<float> &EulerData,
+void InterpTriLinear::interp3D_faceVar(const FieldView<float> &EulerData,
                                        const interpWeight &wgt,
                                        double &out)
 {
@@ -349,8 +340,8 @@ void InterpTriLinear::setInterp3Dindex_cellVar(const double &par_xPos,
   // basically adding a small number to dx shifts the indices so that instead of going
   // from 0 to nx - 1, they go from 0 to nx - 2. This means that ii + ip can at most be nx - 1
   // and only if a particle lands directly on the far boundary condition edge
-  wgt.ii = floor(par_x / (dx + 1e-7));
-  wgt.jj = floor(par_y / (dy + 1e-7));
+  wgt.ii = floor(par_x / (dx + 1e-7)) - iOrigin;
+  wgt.jj = floor(par_y / (dy + 1e-7)) - jOrigin;
   // wgt.kk = floor(par_z / (dz + 1e-7));
 
   // fractional distance between the nearest nodes
@@ -358,15 +349,12 @@ void InterpTriLinear::setInterp3Dindex_cellVar(const double &par_xPos,
   wgt.jw = (par_y / dy) - floor(par_y / (dy + 1e-7));
   // wgt.kw = (par_z / dz) - floor(par_z / (dz + 1e-7));
 
-  auto itr = std::lower_bound(m_WGD->z.begin(), m_WGD->z.end(), par_zPos);
-  wgt.kk = itr - m_WGD->z.begin() - 1;
-
-  wgt.kw = (par_zPos - m_WGD->z[wgt.kk]) / (m_WGD->z[wgt.kk + 1] - m_WGD->z[wgt.kk]);
+  zCellLocator.interval(par_zPos, wgt.kk, wgt.kw);
 }
 
 
 // always call this after setting the interpolation indices with the setInterp3Dindexing() function!
-void InterpTriLinear::interp3D_cellVar(const std::vector<float> &EulerData,
+void InterpTriLinear::interp3D_cellVar(const FieldView<float> &EulerData,
                                        const interpWeight &wgt,
                                        double &out)
 {
@@ -108,11 +108,11 @@ private:
   void setInterp3Dindex_uFace(const double &, const double &, const double &, interpWeight &);
   void setInterp3Dindex_vFace(const double &, const double &, const double &, interpWeight &);
   void setInterp3Dindex_wFace(const double &, const double &, const double &, interpWeight &);
-  void interp3D_faceVar(const std::vector<float> &, const interpWeight &, double &);
+  void interp3D_faceVar(const FieldView<float> &, const interpWeight &, double &);
   void interp3D_faceVar(const std::vector<double> &, const interpWeight &, double &);
 
   void setInterp3Dindex_cellVar(const double &, const double &, const double &, interpWeight &);
-  void interp3D_cellVar(const std::vector<float> &, const interpWeight &, double &);
+  void interp3D_cellVar(const FieldView<float> &, const interpWeight &, double &);
   void interp3D_cellVar(const std::vector<double> &, const interpWeight &, double &);
 
   // copies of debug related information from the input arguments
@@ -36,6 +36,7 @@
 
 #include <cmath>
 #include <utility>
+#include <vector>
 
 #include "util/ParseInterface.h"
 
@@ -193,6 +194,7 @@ public:
 
   bool isRogue{};// this is false until it becomes true. Should not go true.
   bool isActive{};// this is true until it becomes false.
+  int splitLevel{};// number of times the particle was split by the population control
 
   // particle physical property
   double d;// particle diameter diameter [microns]
@@ -227,4 +229,32 @@ public:
   double wdecay;// (1 - fraction) particle decayed [0,1]
 
   virtual void setSettlingVelocity(const double &, const double &){};
+
+  // copy of the particle (same type and state), used to split a particle
+  virtual Particle *clone() const { return new Particle(*this); }
+
+  // applies the function f to every variable of the state of the particle
+  // (used to send particles between processes, the type and the tag are set by the constructor
+  // and the deposition buffer is flushed at the end of each timestep)
+  template<typename Func>
+  void forEachState(Func &f)
+  {
+    f(xPos_init), f(yPos_init), f(zPos_init);
+    f(tStrt), f(particleID), f(sourceIdx);
+    f(xPos), f(yPos), f(zPos);
+    f(uMean), f(vMean), f(wMean);
+    f(uFluct), f(vFluct), f(wFluct);
+    f(disX), f(disY), f(disZ);
+    f(uTot), f(vTot), f(wTot);
+    f(CoEps);
+    f(uFluct_old), f(vFluct_old), f(wFluct_old);
+    f(txx_old), f(txy_old), f(txz_old), f(tyy_old), f(tyz_old), f(tzz_old);
+    f(delta_uFluct), f(delta_vFluct), f(delta_wFluct);
+    f(isRogue), f(isActive), f(splitLevel);
+    f(d), f(d_m), f(m), f(m_kg), f(m_o), f(m_kg_o), f(rho);
+    f(Sc), f(taud), f(vd), f(depFlag);
+    f(decayConst), f(c1), f(c2);
+    f(dstar), f(Cd), f(wstar), f(vs);
+    f(wdecay);
+  }
 };
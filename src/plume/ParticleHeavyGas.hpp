@@ -83,6 +83,8 @@ public:
   {
   }
 
+  Particle *clone() const override { return new ParticleHeavyGas(*this); }
+
   //  void setSettlingVelocity(const double &, const double &);
   void setSettlingVelocity(const double &rhoAir, const double &nuAir) override
   {
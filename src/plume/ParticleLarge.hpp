@@ -81,6 +81,8 @@ public:
   // destructor
   ~ParticleLarge() override = default;
 
+  Particle *clone() const override { return new ParticleLarge(*this); }
+
   //  void setSettlingVelocity(const double &, const double &);
   void setSettlingVelocity(const double &rhoAir, const double &nuAir) override
   {
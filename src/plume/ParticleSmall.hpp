@@ -82,6 +82,8 @@ public:
   // destructor
   ~ParticleSmall() override = default;
 
+  Particle *clone() const override { return new ParticleSmall(*this); }
+
   // void setSettlingVelocity(const double &, const double &);
   void setSettlingVelocity(const double &rhoAir, const double &nuAir) override
   {
@@ -84,6 +84,8 @@ public:
   {
   }
 
+  Particle *clone() const override { return new ParticleTracer(*this); }
+
   //  void setSettlingVelocity(const double &, const double &){
   //    vs = 0.0;
   void setSettlingVelocity(const double &rhoAir, const double &nuAir) override
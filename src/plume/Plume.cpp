@@ -32,6 +32,8 @@
 
 #include "Plume.hpp"
 
+#include "util/QESprofile.h"
+
 Plume::Plume(WINDSGeneralData *WGD, TURBGeneralData *TGD)
   : particleList(0), allSources(0)
 {
@@ -45,8 +47,9 @@ Plume::Plume(WINDSGeneralData *WGD, TURBGeneralData *TGD)
   verbose = false;// arguments->verbose;
 
   // make local copies of the QES-Winds nVals for each dimension
-  nx = WGD->nx;
-  ny = WGD->ny;
+  // (whole domain, WGD may only hold a window of it)
+  nx = WGD->x.size() + 1;
+  ny = WGD->y.size() + 1;
   nz = WGD->nz;
 
   dx = WGD->dx;
@@ -56,6 +59,11 @@ Plume::Plume(WINDSGeneralData *WGD, TURBGeneralData *TGD)
 }
 
 Plume::Plume(PlumeInputData *PID, WINDSGeneralData *WGD, TURBGeneralData *TGD)
+  : Plume(PID, WGD, TGD, nullptr)
+{
+}
+
+Plume::Plume(PlumeInputData *PID, WINDSGeneralData *WGD, TURBGeneralData *TGD, Interp *sharedInterp)
   : particleList(0), allSources(0)
 {
   std::cout << "-------------------------------------------------------------------" << std::endl;
@@ -71,8 +79,9 @@ Plume::Plume(PlumeInputData *PID, WINDSGeneralData *WGD, TURBGeneralData *TGD)
   verbose = false;// arguments->verbose;
 
   // make local copies of the QES-Winds nVals for each dimension
-  nx = WGD->nx;
-  ny = WGD->ny;
+  // (whole domain, WGD may only hold a window of it)
+  nx = WGD->x.size() + 1;
+  ny = WGD->y.size() + 1;
   nz = WGD->nz;
 
   dx = WGD->dx;
@@ -83,7 +92,9 @@ Plume::Plume(PlumeInputData *PID, WINDSGeneralData *WGD, TURBGeneralData *TGD)
   // Create instance of Interpolation class
   std::cout << "[QES-Plume] \t Interpolation Method set to: "
             << PID->plumeParams->interpMethod << std::endl;
-  if (PID->plumeParams->interpMethod == "analyticalPowerLaw") {
+  if (sharedInterp) {
+    interp = sharedInterp;
+  } else if (PID->plumeParams->interpMethod == "analyticalPowerLaw") {
     interp = new InterpPowerLaw(WGD, TGD, debug);
   } else if (PID->plumeParams->interpMethod == "nearestCell") {
     interp = new InterpNearestCell(WGD, TGD, debug);
@@ -141,6 +152,19 @@ Plume::Plume(PlumeInputData *PID, WINDSGeneralData *WGD, TURBGeneralData *TGD)
   updateFrequency_timeLoop = PID->plumeParams->updateFrequency_timeLoop;
   updateFrequency_particleLoop = PID->plumeParams->updateFrequency_particleLoop;
 
+  // population control, the particles are split in the collection boxes
+  particleBudget = PID->plumeParams->particleBudget;
+  maxSplitGenerations = PID->plumeParams->maxSplitGenerations;
+  roiBounds[0] = PID->colParams->boxBoundsX1;
+  roiBounds[1] = PID->colParams->boxBoundsX2;
+  roiBounds[2] = PID->colParams->boxBoundsY1;
+  roiBounds[3] = PID->colParams->boxBoundsY2;
+  roiBounds[4] = PID->colParams->boxBoundsZ1;
+  roiBounds[5] = PID->colParams->boxBoundsZ2;
+  if (particleBudget > 0) {
+    std::cout << "[QES-Plume] \t Population control with a budget of " << particleBudget << " particles" << std::endl;
+  }
+
   // set the isRogueCount and isNotActiveCount to zero
   isRogueCount = 0;
   isNotActiveCount = 0;
@@ -196,38 +220,18 @@ Plume::Plume(PlumeInputData *PID, WINDSGeneralData *WGD, TURBGeneralData *TGD)
 
 void Plume::run(QEStime loopTimeEnd, WINDSGeneralData *WGD, TURBGeneralData *TGD, std::vector<QESNetCDFOutput *> outputVec)
 {
-  auto startTimeAdvec = std::chrono::high_resolution_clock::now();
-
-  std::cout << "-------------------------------------------------------------------" << std::endl;
-
-  // get the threshold velocity fluctuation to define rogue particles
-  vel_threshold = 10.0 * getMaxVariance(TGD);
-
-  // //////////////////////////////////////////
-  // TIME Stepping Loop
-  // for every simulation time step
-  // //////////////////////////////////////////
-
-  if (debug) {
-    // start recording the amount of time it takes to perform the simulation
-    // time integration loop
-    timers.startNewTimer("simulation time integration loop");
-
-    // start additional timers that need to be reset at different times during
-    // the following loops LA future work: probably should wrap all of these in
-    // a debug if statement
-    timers.startNewTimer("advection loop");
-    timers.startNewTimer("particle iteration");
-  }
-
-  QEStime nextUpdate = simTimeCurr + updateFrequency_timeLoop;
-  float simTime = simTimeCurr - simTimeStart;
+  run(loopTimeEnd, WGD, TGD, nullptr, nullptr, outputVec);
+}
 
-  std::cout << "[QES-Plume] \t Advecting particles from " << simTimeCurr << " to " << loopTimeEnd << ".\n"
-            << "\t\t Total run time = " << loopTimeEnd - simTimeCurr << " s "
-            << "(sim time = " << simTime << " s, iteration = " << simTimeIdx << "). \n";
-  std::cout << "\t\t Particles: Released = " << nParsReleased << " "
-            << "Active = " << particleList.size() << "." << std::endl;
+void Plume::run(QEStime loopTimeEnd,
+                WINDSGeneralData *WGD,
+                TURBGeneralData *TGD,
+                WINDSGeneralData *WGD_nextStep,
+                TURBGeneralData *TGD_nextStep,
+                std::vector<QESNetCDFOutput *> outputVec)
+{
+  QESprofile::Scope profile("plume");
+  startInterval(loopTimeEnd, TGD, WGD_nextStep, TGD_nextStep);
 
   // LA note: that this loop goes from 0 to nTimes-2, not nTimes-1. This is
   // because
@@ -245,46 +249,18 @@ void Plume::run(QEStime loopTimeEnd, WINDSGeneralData *WGD, TURBGeneralData *TGD
   //  function calls need to also be set to tStep+1.
   // FMargairaz -> need clean-up
   while (simTimeCurr < loopTimeEnd) {
-    // need to release new particles -> add new particles to the number to move
-    int nParsToRelease = generateParticleList(simTime, WGD, TGD);
-    if (debug) {
-      std::cout << "Time = " << simTime << " s (iteration = " << simTimeIdx
-                << "). Finished emitting particles "
-                << "from " << allSources.size() << " sources. "
-                << "Particles: New released = " << nParsToRelease << " "
-                << "Total released = " << nParsReleased << "." << std::endl;
-    }
-
-    // number of active particle at the current time step.
-    // list is scrubbed at the end of each time step (if flag turned true)
-    bool needToScrub = false;
+    // release the new particles and get the length of this simulation timestep
+    double timeRemainder = startTimeStep(loopTimeEnd, WGD, TGD);
 
     // Move each particle for every simulation time step
     // Advection Loop
 
-    // start recording the amount of time it takes to advect each set of
-    // particles for a given simulation timestep,
-    //  but only output the result when updateFrequency allows
-    // LA future work: would love to put this into a debug if statement wrapper
-    /* if( debug == true ) {
-       if( (simTimeIdx+1) % updateFrequency_timeLoop == 0 || simTimeIdx == 0 ||
-       simTimeIdx == nSimTimes-2 ) { timers.resetStoredTimer("advection loop");
-       }
-       }*/
-
-    // the current time, updated in this loop with each new par_dt.
-    // Will end at simTimes.at(simTimeIdx+1) at the end of this particle loop
-    double timeRemainder = loopTimeEnd - simTimeCurr;
-    if (timeRemainder > sim_dt) {
-      timeRemainder = sim_dt;
-    }
-
     // This the main loop over all active particles
     // All the particle here are active => no need to check
     //  for (auto parItr = particleList.begin(); parItr != particleList.end(); parItr++) {
 
-    auto startTime = std::chrono::high_resolution_clock::now();
     // FM: openmp parallelization of the advection loop
+    QESprofile::Scope profileAdvection("advection");
 #ifdef _OPENMP
     std::vector<Particle *> tmp(particleList.begin(), particleList.end());
 #pragma omp parallel for default(none) shared(WGD, TGD, tmp, timeRemainder)
@@ -298,71 +274,195 @@ void Plume::run(QEStime loopTimeEnd, WINDSGeneralData *WGD, TURBGeneralData *TGD
       advectParticle(timeRemainder, parItr, boxSizeZ, WGD, TGD);
     }// end of loop
 #endif
+    profileAdvection.stop();
 
-    //  flush deposition buffer
-    for (auto &parItr : particleList) {
-      if (parItr->dep_buffer_flag) {
-        for (auto n = 0u; n < parItr->dep_buffer_cell.size(); ++n) {
-          deposition->depcvol[parItr->dep_buffer_cell[n]] += parItr->dep_buffer_val[n];
-        }
-        parItr->dep_buffer_flag = false;
-        parItr->dep_buffer_cell.clear();
-        parItr->dep_buffer_val.clear();
-      }
-    }
+    // deposition, particle bookkeeping and outputs
+    finishTimeStep(timeRemainder, loopTimeEnd, outputVec);
 
-    for (auto &parItr : particleList) {
-      // now update the isRogueCount and isNotActiveCount
-      if (parItr->isRogue) {
-        isRogueCount = isRogueCount + 1;
-      }
-      if (!parItr->isActive) {
-        isNotActiveCount = isNotActiveCount + 1;
-        needToScrub = true;
+  }// end of time loop
+
+  finishInterval();
+}
+
+void Plume::startInterval(QEStime loopTimeEnd,
+                          TURBGeneralData *TGD,
+                          WINDSGeneralData *WGD_nextStep,
+                          TURBGeneralData *TGD_nextStep)
+{
+  startTimeAdvec = std::chrono::high_resolution_clock::now();
+
+  std::cout << "-------------------------------------------------------------------" << std::endl;
+
+  // set the fields to blend with in time (weight goes from 0 now to 1 at loopTimeEnd)
+  WGD_next = WGD_nextStep;
+  TGD_next = TGD_nextStep;
+  if (WGD_next == nullptr || TGD_next == nullptr) {
+    WGD_next = nullptr;
+    TGD_next = nullptr;
+  }
+  blendTimeStart = simTimeCurr;
+  blendTimeSpan = loopTimeEnd - simTimeCurr;
+  blendTimeOffset = 0.0;
+
+  // get the threshold velocity fluctuation to define rogue particles
+  vel_threshold = 10.0 * getMaxVariance(TGD);
+  if (TGD_next) {
+    vel_threshold = std::max(vel_threshold, 10.0 * getMaxVariance(TGD_next));
+  }
+  // distributed mode: each process only holds a window of the fields, use the same threshold everywhere
+  if (distributed) {
+    vel_threshold = maxOverProcesses(vel_threshold);
+  }
+
+  // //////////////////////////////////////////
+  // TIME Stepping Loop
+  // for every simulation time step
+  // //////////////////////////////////////////
+
+  if (debug) {
+    // start recording the amount of time it takes to perform the simulation
+    // time integration loop
+    timers.startNewTimer("simulation time integration loop");
+
+    // start additional timers that need to be reset at different times during
+    // the following loops LA future work: probably should wrap all of these in
+    // a debug if statement
+    timers.startNewTimer("advection loop");
+    timers.startNewTimer("particle iteration");
+  }
+
+  nextUpdate = simTimeCurr + updateFrequency_timeLoop;
+  float simTime = simTimeCurr - simTimeStart;
+
+  std::cout << "[QES-Plume] \t Advecting particles from " << simTimeCurr << " to " << loopTimeEnd << ".\n"
+            << "\t\t Total run time = " << loopTimeEnd - simTimeCurr << " s "
+            << "(sim time = " << simTime << " s, iteration = " << simTimeIdx << "). \n";
+  std::cout << "\t\t Particles: Released = " << nParsReleased << " "
+            << "Active = " << particleList.size() << "." << std::endl;
+}
+
+double Plume::startTimeStep(QEStime loopTimeEnd, WINDSGeneralData *WGD, TURBGeneralData *TGD)
+{
+  float simTime = simTimeCurr - simTimeStart;
+
+  // position of the current simulation timestep between the stored timesteps
+  blendTimeOffset = simTimeCurr - blendTimeStart;
+
+  // need to release new particles -> add new particles to the number to move
+  int nParsToRelease = generateParticleList(simTime, WGD, TGD);
+
+  // distributed mode: the particles that crossed a tile boundary during the previous timestep
+  // are sent to the process owning their tile
+  if (distributed) {
+    migrateParticles(particleList);
+  }
+  if (debug) {
+    std::cout << "Time = " << simTime << " s (iteration = " << simTimeIdx
+              << "). Finished emitting particles "
+              << "from " << allSources.size() << " sources. "
+              << "Particles: New released = " << nParsToRelease << " "
+              << "Total released = " << nParsReleased << "." << std::endl;
+  }
+
+  // start recording the amount of time it takes to advect each set of
+  // particles for a given simulation timestep,
+  //  but only output the result when updateFrequency allows
+  // LA future work: would love to put this into a debug if statement wrapper
+  /* if( debug == true ) {
+     if( (simTimeIdx+1) % updateFrequency_timeLoop == 0 || simTimeIdx == 0 ||
+     simTimeIdx == nSimTimes-2 ) { timers.resetStoredTimer("advection loop");
+     }
+     }*/
+
+  // the current time, updated in this loop with each new par_dt.
+  // Will end at simTimes.at(simTimeIdx+1) at the end of this particle loop
+  double timeRemainder = loopTimeEnd - simTimeCurr;
+  if (timeRemainder > sim_dt) {
+    timeRemainder = sim_dt;
+  }
+
+  return timeRemainder;
+}
+
+void Plume::finishTimeStep(double timeRemainder, QEStime loopTimeEnd, std::vector<QESNetCDFOutput *> &outputVec)
+{
+  // number of active particle at the current time step.
+  // list is scrubbed at the end of each time step (if flag turned true)
+  bool needToScrub = false;
+
+  if (QESprofile::enabled()) {
+    QESprofile::addCount("plume/particles_advected", particleList.size());
+    QESprofile::addCount("plume/substeps", nSubStepsCount.exchange(0));
+    QESprofile::addCount("plume/wall_bounces", wallReflect->takeBounceCount());
+  }
+
+  //  flush deposition buffer
+  for (auto &parItr : particleList) {
+    if (parItr->dep_buffer_flag) {
+      for (auto n = 0u; n < parItr->dep_buffer_cell.size(); ++n) {
+        deposition->depcvol[parItr->dep_buffer_cell[n]] += parItr->dep_buffer_val[n];
       }
-    }// end of loop for (parItr == particleList.begin(); parItr !=
-    // particleList.end() ; parItr++ )
-
-    // incrementation of time and timestep
-    simTimeIdx++;
-    simTimeCurr += timeRemainder;
-    simTime = simTimeCurr - simTimeStart;
-
-    // netcdf output for a given simulation timestep
-    // note that the first time is already output, so this is the time the loop
-    // iteration
-    //  is calculating, not the input time to the loop iteration
-    for (auto &id_out : outputVec) {
-      id_out->save(simTimeCurr);
+      parItr->dep_buffer_flag = false;
+      parItr->dep_buffer_cell.clear();
+      parItr->dep_buffer_val.clear();
     }
+  }
 
-    // For all particles that need to be removed from the particle
-    // advection, remove them now
-    if (needToScrub) {
-      scrubParticleList();
+  for (auto &parItr : particleList) {
+    // now update the isRogueCount and isNotActiveCount
+    if (parItr->isRogue) {
+      isRogueCount = isRogueCount + 1;
     }
-    // output the time, isRogueCount, and isNotActiveCount information for all
-    // simulations, but only when the updateFrequency allows
-    if (simTimeCurr >= nextUpdate || (simTimeCurr == loopTimeEnd)) {
-      if (verbose) {
-        std::cout << "Time = " << simTimeCurr << " (sim time = " << simTime << " s, iteration = " << simTimeIdx << "). "
-                  << "Particles: Released = " << nParsReleased << " "
-                  << "Active = " << particleList.size() << " "
-                  << "Rogue = " << isRogueCount << "." << std::endl;
-      } else {
-        std::cout << "Time = " << simTimeCurr << " (sim time = " << simTime << " s, iteration = " << simTimeIdx << "). "
-                  << "Particles: Released = " << nParsReleased << " "
-                  << "Active = " << particleList.size() << "." << std::endl;
-      }
-      nextUpdate += (float)updateFrequency_timeLoop;
-      // output advection loop runtime if in debug mode
-      if (debug) {
-        timers.printStoredTime("advection loop");
-      }
+    if (!parItr->isActive) {
+      isNotActiveCount = isNotActiveCount + 1;
+      needToScrub = true;
     }
+  }// end of loop for (parItr == particleList.begin(); parItr !=
+  // particleList.end() ; parItr++ )
 
-  }// end of time loop
+  // incrementation of time and timestep
+  simTimeIdx++;
+  simTimeCurr += timeRemainder;
+  float simTime = simTimeCurr - simTimeStart;
+
+  // netcdf output for a given simulation timestep
+  // note that the first time is already output, so this is the time the loop
+  // iteration
+  //  is calculating, not the input time to the loop iteration
+  for (auto &id_out : outputVec) {
+    id_out->save(simTimeCurr);
+  }
+
+  // For all particles that need to be removed from the particle
+  // advection, remove them now
+  if (needToScrub) {
+    scrubParticleList();
+  }
+  // merge or split the particles to stay near the particle budget
+  controlPopulation();
+  // output the time, isRogueCount, and isNotActiveCount information for all
+  // simulations, but only when the updateFrequency allows
+  if (simTimeCurr >= nextUpdate || (simTimeCurr == loopTimeEnd)) {
+    if (verbose) {
+      std::cout << "Time = " << simTimeCurr << " (sim time = " << simTime << " s, iteration = " << simTimeIdx << "). "
+                << "Particles: Released = " << nParsReleased << " "
+                << "Active = " << particleList.size() << " "
+                << "Rogue = " << isRogueCount << "." << std::endl;
+    } else {
+      std::cout << "Time = " << simTimeCurr << " (sim time = " << simTime << " s, iteration = " << simTimeIdx << "). "
+                << "Particles: Released = " << nParsReleased << " "
+                << "Active = " << particleList.size() << "." << std::endl;
+    }
+    nextUpdate += (float)updateFrequency_timeLoop;
+    // output advection loop runtime if in debug mode
+    if (debug) {
+      timers.printStoredTime("advection loop");
+    }
+  }
+}
 
+void Plume::finishInterval()
+{
   std::cout << "[QES-Plume] \t End of particles advection at Time = " << simTimeCurr
             << " s (iteration = " << simTimeIdx << "). \n";
   std::cout << "\t\t Particles: Released = " << nParsReleased << " "
@@ -497,8 +597,28 @@ int Plume::generateParticleList(float currentTime, WINDSGeneralData *WGD, TURBGe
 
   std::list<Particle *> nextSetOfParticles;
   int numNewParticles = 0;
-  for (auto source : allSources) {
-    numNewParticles += source->emitParticles((float)sim_dt, currentTime, nextSetOfParticles);
+  // distributed mode: the particles are released by the root process only
+  if (!distributed || mpiRank == 0) {
+    for (auto source : allSources) {
+      numNewParticles += source->emitParticles((float)sim_dt, currentTime, nextSetOfParticles);
+    }
+  }
+
+  for (auto &par_ptr : nextSetOfParticles) {
+    // set particle ID (use global particle counter)
+    par_ptr->particleID = nParsReleased;
+    nParsReleased++;
+  }
+
+  // distributed mode: the new particles are sent to the process owning their tile,
+  // which holds the fields to set them up
+  if (distributed) {
+    for (auto &par_ptr : nextSetOfParticles) {
+      par_ptr->xPos = par_ptr->xPos_init;
+      par_ptr->yPos = par_ptr->yPos_init;
+      par_ptr->zPos = par_ptr->zPos_init;
+    }
+    migrateParticles(nextSetOfParticles);
   }
 
   setParticleVals(WGD, TGD, nextSetOfParticles);
@@ -529,12 +649,8 @@ void Plume::setParticleVals(WINDSGeneralData *WGD, TURBGeneralData *TGD, std::li
   // the given time particles and sources can potentially be added to the list
   // elsewhere
   // for (auto parItr = newParticles.begin(); parItr != newParticles.end(); parItr++) {
+  // (the particle IDs are set by generateParticleList)
   std::vector<Particle *> tmp(newParticles.begin(), newParticles.end());
-  for (auto &parItr : tmp) {
-    // set particle ID (use global particle counter)
-    parItr->particleID = nParsReleased;
-    nParsReleased++;
-  }
 
   // #pragma omp parallel for default(none) shared(WGD, TGD, tmp)
   // for (auto parItr = tmp.begin(); parItr != tmp.end(); parItr++) {
@@ -557,19 +673,21 @@ void Plume::setParticleVals(WINDSGeneralData *WGD, TURBGeneralData *TGD, std::li
     // get the tau values from the QES grid for the particle value
     double txx, txy, txz, tyy, tyz, tzz;
 
-    interp->interpInitialValues(par_ptr->xPos,
-                                par_ptr->yPos,
-                                par_ptr->zPos,
-                                TGD,
-                                sig_x,
-                                sig_y,
-                                sig_z,
-                                txx,
-                                txy,
-                                txz,
-                                tyy,
-                                tyz,
-                                tzz);
+    interp->interpInitialValuesInTime(par_ptr->xPos,
+                                      par_ptr->yPos,
+                                      par_ptr->zPos,
+                                      TGD,
+                                      TGD_next,
+                                      getTimeWeight(0.0),
+                                      sig_x,
+                                      sig_y,
+                                      sig_z,
+                                      txx,
+                                      txy,
+                                      txz,
+                                      tyy,
+                                      tyz,
+                                      tzz);
 
     // now set the initial velocity fluctuations for the particle
     // The  sqrt of the variance is to match Bailey's code
@@ -633,17 +751,17 @@ double Plume::getMaxVariance(const TURBGeneralData *TGD)
 
   // go through each vector to find the maximum value
   // each one could potentially be different sizes if the grid is not 3D
-  for (float it : TGD->txx) {
+  for (float it : TGD->txxView()) {
     if (std::sqrt(std::abs(it)) > maximumVal) {
       maximumVal = std::sqrt(std::abs(it));
     }
   }
-  for (float it : TGD->tyy) {
+  for (float it : TGD->tyyView()) {
     if (std::sqrt(std::abs(it)) > maximumVal) {
       maximumVal = std::sqrt(std::abs(it));
     }
   }
-  for (float it : TGD->tzz) {
+  for (float it : TGD->tzzView()) {
     if (std::sqrt(std::abs(it)) > maximumVal) {
       maximumVal = std::sqrt(std::abs(it));
     }
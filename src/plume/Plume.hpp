@@ -40,6 +40,9 @@
 #include <list>
 #include <cmath>
 #include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <atomic>
 
 #ifdef _OPENMP
 #include <omp.h>
@@ -90,6 +93,9 @@ public:
   // next copies important input time values and calculates needed time information
   // lastly sets up the boundary condition functions and checks to make sure input BC's are valid
   Plume(PlumeInputData *, WINDSGeneralData *, TURBGeneralData *);
+  // same as above, but uses an existing interpolation object (read-only, can be shared
+  // by several plumes running over the same wind and turbulence fields)
+  Plume(PlumeInputData *, WINDSGeneralData *, TURBGeneralData *, Interp *);
 
   virtual ~Plume()
   {}
@@ -106,6 +112,21 @@ public:
   //  that is used to do an additional time remainder time integration loop for each particle, forcing particles to only
   //  move one cell at a time.
   void run(QEStime, WINDSGeneralData *, TURBGeneralData *, std::vector<QESNetCDFOutput *>);
+  // same as above, but the wind and turbulence fields are blended linearly in time between
+  // the current timestep (first pair) and the next stored timestep (second pair, reached at loopTimeEnd).
+  // the next timestep can be null, in which case the current fields are used over the whole interval.
+  void run(QEStime,
+           WINDSGeneralData *,
+           TURBGeneralData *,
+           WINDSGeneralData *,
+           TURBGeneralData *,
+           std::vector<QESNetCDFOutput *>);
+
+  // phases of run(), also used by PlumeEnsemble to advect several plumes in the same loop
+  void startInterval(QEStime, TURBGeneralData *, WINDSGeneralData *, TURBGeneralData *);
+  double startTimeStep(QEStime, WINDSGeneralData *, TURBGeneralData *);
+  void finishTimeStep(double, QEStime, std::vector<QESNetCDFOutput *> &);
+  void finishInterval();
 
   void addSources(std::vector<Source *> &newSources);
 
@@ -121,6 +142,19 @@ public:
 
   void showCurrentStatus();
 
+  // distributed mode (MPI): the particles are spread over the processes by horizontal tiles of the domain,
+  // each process advects the particles of its tile (does nothing if there is a single process).
+  // The wind and turbulence fields only need to cover the tile plus a halo (see tileWindow()).
+  void distribute();
+  // window of the domain to load on this process in distributed mode ({i0, i1, j0, j1} in cells, see
+  // WINDSGeneralData): the tile of the process plus a halo wide enough for the travel of the particles
+  // over one timestep, found from the largest wind speed and fluctuations of the files (empty with a single process)
+  static std::vector<int> tileWindow(const std::string &, const std::string &, const PlumeInputData *);
+  bool isDistributed() const { return distributed; }
+  // sum of a field over all the processes, stored on the root process (does nothing if not distributed)
+  void sumOnRoot(std::vector<int> &);
+  void sumOnRoot(std::vector<float> &);
+
   // This the storage for all particles
   // the sources can set these values, then the other values are set using urb and turb info using these values
   std::list<Particle *> particleList;
@@ -178,15 +212,44 @@ protected:
   QEStime simTimeStart;
   QEStime simTimeCurr;
   int simTimeIdx = 0;
+  QEStime nextUpdate;// next time the status is printed
+  std::chrono::time_point<std::chrono::high_resolution_clock> startTimeAdvec;
 
   // some overall metadata for the set of particles
   int isRogueCount = 0;// just a total number of rogue particles per time iteration
   int isNotActiveCount = 0;// just a total number of inactive active particles per time iteration
 
+  // distributed mode (see distribute())
+  bool distributed = false;
+  int mpiRank = 0;// rank of the process
+  int mpiSize = 1;// number of processes
+  int tileDims[2] = { 1, 1 };// number of tiles in the x and y directions
+  std::vector<double> tileXbounds;// x-boundaries of the tiles (tileDims[0]+1 values)
+  std::vector<double> tileYbounds;// y-boundaries of the tiles (tileDims[1]+1 values)
+
+  // profiling counters, accumulated by the advection threads (only when profiling is enabled)
+  std::atomic<long> nSubStepsCount{ 0 };
+
+  // population control (see controlPopulation())
+  int particleBudget = 0;// target number of active particles (0 -> off)
+  int maxSplitGenerations = 0;// maximum number of times a released particle can be split
+  double roiBounds[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };// region where the particles are split (collection boxes)
+  // merges co-located light particles, pairwise, until (at most) the given number is removed
+  long mergeParticles(long);
+  // splits the heaviest particles of the region of interest, until (at most) the given number is added
+  long splitParticles(long);
+
   // important time variables not copied from dispersion
   double CourantNum = 0.0;// the Courant number, used to know how to divide up the simulation timestep into smaller per particle timesteps. Copied from input
   double vel_threshold = 0.0;
 
+  // next stored timestep used to blend the fields in time (null when not blending)
+  WINDSGeneralData *WGD_next = nullptr;
+  TURBGeneralData *TGD_next = nullptr;
+  QEStime blendTimeStart;// time of the current stored timestep (weight = 0)
+  double blendTimeSpan = 0.0;// time between the current and the next stored timestep
+  double blendTimeOffset = 0.0;// time since blendTimeStart at the start of the current simulation timestep
+
   // ALL Sources that will be used
   std::vector<Source *> allSources;
   // this is the global counter of particles released (used to set particleID)
@@ -213,6 +276,8 @@ protected:
   bool verbose = false;
 
 private:
+  friend class PlumeEnsemble;
+
   void setParticleVals(WINDSGeneralData *, TURBGeneralData *, std::list<Particle *>);
   // this function gets sources from input data and adds them to the allSources vector
   // this function also calls the many check and calc functions for all the input sources
@@ -227,8 +292,22 @@ private:
   // this function scrubs the inactive particle for the particle list (particleList)
   void scrubParticleList();
 
+  // population control: keeps the number of active particles near particleBudget
+  // (in PopulationControl.cpp)
+  void controlPopulation();
+
+  // rank of the process owning the tile of the particle (distributed mode)
+  int tileOwner(const Particle *) const;
+  // sends the particles of a list outside the tile of the process to their owner, in one batched exchange (distributed mode)
+  void migrateParticles(std::list<Particle *> &);
+  // maximum of a value over all the processes (distributed mode)
+  double maxOverProcesses(double) const;
+
   double getMaxVariance(const TURBGeneralData *);
 
+  // weight of the next stored timestep at a time dt after the start of the current simulation timestep
+  double getTimeWeight(const double &) const;
+
   // this function moves (advects) one particle
   void advectParticle(double, Particle *, double, WINDSGeneralData *, TURBGeneralData *);
 
@@ -323,6 +402,15 @@ private:
   {}
 };
 
+inline double Plume::getTimeWeight(const double &dt) const
+{
+  if (!TGD_next || blendTimeSpan <= 0.0) {
+    return 0.0;
+  }
+  double weight = (blendTimeOffset + dt) / blendTimeSpan;
+  return std::min(std::max(weight, 0.0), 1.0);
+}
+
 inline void Plume::showCurrentStatus()
 {
   std::cout << "----------------------------------------------------------------- \n";
@@ -0,0 +1,109 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Plume
+ *
+ * GPL-3.0 License
+ *
+ * QES-Plume is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Plume is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Plume. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file PlumeEnsemble.cpp */
+
+#include "PlumeEnsemble.hpp"
+
+#include "util/QESprofile.h"
+
+PlumeEnsemble::PlumeEnsemble(std::vector<PlumeInputData *> &PIDs, WINDSGeneralData *WGD, TURBGeneralData *TGD)
+{
+  std::cout << "-------------------------------------------------------------------" << std::endl;
+  std::cout << "[QES-Plume]\t Initialization of plume ensemble (" << PIDs.size() << " scenarios)...\n";
+
+  if (PIDs.empty()) {
+    QESout::error("Plume ensemble without scenario");
+  }
+  for (auto *PID : PIDs) {
+    if (PID->plumeParams->timeStep != PIDs[0]->plumeParams->timeStep) {
+      QESout::error("All scenarios of a plume ensemble need the same timeStep");
+    }
+    if (PID->plumeParams->interpMethod != PIDs[0]->plumeParams->interpMethod) {
+      QESout::error("All scenarios of a plume ensemble need the same interpolationMethod");
+    }
+  }
+
+  // the first member creates the interpolation object, the other members share it
+  members.push_back(new Plume(PIDs[0], WGD, TGD));
+  for (size_t k = 1; k < PIDs.size(); ++k) {
+    members.push_back(new Plume(PIDs[k], WGD, TGD, members[0]->interp));
+  }
+}
+
+void PlumeEnsemble::run(QEStime loopTimeEnd,
+                        WINDSGeneralData *WGD,
+                        TURBGeneralData *TGD,
+                        WINDSGeneralData *WGD_nextStep,
+                        TURBGeneralData *TGD_nextStep,
+                        std::vector<std::vector<QESNetCDFOutput *>> &outputVec)
+{
+  QESprofile::Scope profile("plume");
+  for (auto *plume : members) {
+    plume->startInterval(loopTimeEnd, TGD, WGD_nextStep, TGD_nextStep);
+  }
+
+  // all members share the same time step, hence the same simulation time
+  while (members[0]->simTimeCurr < loopTimeEnd) {
+    std::vector<double> timeRemainder(members.size());
+    // particles of all the members in a single list (with the index of their member)
+    std::vector<Particle *> tmp;
+    std::vector<int> tmp_member;
+    for (size_t m = 0; m < members.size(); ++m) {
+      timeRemainder[m] = members[m]->startTimeStep(loopTimeEnd, WGD, TGD);
+      tmp.insert(tmp.end(), members[m]->particleList.begin(), members[m]->particleList.end());
+      tmp_member.resize(tmp.size(), m);
+    }
+
+    QESprofile::Scope profileAdvection("advection");
+#pragma omp parallel for default(none) shared(WGD, TGD, tmp, tmp_member, timeRemainder)
+    for (auto k = 0u; k < tmp.size(); ++k) {
+      Plume *plume = members[tmp_member[k]];
+      plume->advectParticle(timeRemainder[tmp_member[k]], tmp[k], plume->boxSizeZ, WGD, TGD);
+    }
+    profileAdvection.stop();
+
+    for (size_t m = 0; m < members.size(); ++m) {
+      members[m]->finishTimeStep(timeRemainder[m], loopTimeEnd, outputVec[m]);
+    }
+  }
+
+  for (auto *plume : members) {
+    plume->finishInterval();
+  }
+}
+
+void PlumeEnsemble::showCurrentStatus()
+{
+  for (size_t m = 0; m < members.size(); ++m) {
+    std::cout << "[QES-Plume] \t Scenario " << m << "\n";
+    members[m]->showCurrentStatus();
+  }
+}
@@ -0,0 +1,77 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Plume
+ *
+ * GPL-3.0 License
+ *
+ * QES-Plume is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Plume is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Plume. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file PlumeEnsemble.hpp
+ * @brief Several independent plume scenarios advected together over one
+ * wind and turbulence solution.
+ */
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+
+#include "Plume.hpp"
+
+/**
+ * @class PlumeEnsemble
+ * @brief Runs several plume scenarios (sources, particle types, decay, ...)
+ * over the same wind and turbulence fields in a single process.
+ *
+ * The members share the read-only WINDSGeneralData, TURBGeneralData and
+ * Interp objects. Each member keeps its own particles, deposition and
+ * outputs, and the particles of all members are advected in the same
+ * parallel loop. All members must use the same time step.
+ */
+class PlumeEnsemble
+{
+public:
+  PlumeEnsemble(std::vector<PlumeInputData *> &, WINDSGeneralData *, TURBGeneralData *);
+  virtual ~PlumeEnsemble()
+  {}
+
+  /**
+   * Advects the particles of every member up to loopTimeEnd (see Plume::run).
+   * outputVec[k] holds the outputs of the k-th member.
+   */
+  void run(QEStime,
+           WINDSGeneralData *,
+           TURBGeneralData *,
+           WINDSGeneralData *,
+           TURBGeneralData *,
+           std::vector<std::vector<QESNetCDFOutput *>> &);
+
+  void showCurrentStatus();
+
+  std::vector<Plume *> members; /**< one plume per scenario */
+
+private:
+  PlumeEnsemble() = default;
+};
@@ -40,6 +40,7 @@
 #include "PlumeParameters.hpp"
 #include "CollectionParameters.hpp"
 #include "ParticleOutputParameters.hpp"
+#include "ReceptorParameters.hpp"
 #include "SourceParameters.hpp"
 #include "BoundaryConditions.hpp"
 
@@ -56,6 +57,7 @@ public:
   PlumeParameters *plumeParams = nullptr;
   CollectionParameters *colParams = nullptr;
   ParticleOutputParameters *partOutParams = nullptr;
+  ReceptorParameters *receptorParams = nullptr;
   SourceParameters *sourceParams = nullptr;
   BoundaryConditions *BCs = nullptr;
 
@@ -84,6 +86,7 @@ public:
     parseElement<PlumeParameters>(true, plumeParams, "plumeParameters");
     parseElement<CollectionParameters>(true, colParams, "collectionParameters");
     parseElement<ParticleOutputParameters>(false, partOutParams, "particleOutputParameters");
+    parseElement<ReceptorParameters>(false, receptorParams, "receptorParameters");
     parseElement<SourceParameters>(false, sourceParams, "sourceParameters");
     parseElement<BoundaryConditions>(true, BCs, "boundaryConditions");
   }
@@ -40,6 +40,9 @@
 #include "PlumeOutput.h"
 #include "Plume.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 // note that this sets the output file and the bool for whether to do output, in the netcdf inherited classes
 // in this case, output should always be done, so the bool for whether to do output is set to true
 PlumeOutput::PlumeOutput(const PlumeInputData *PID, Plume *plume_ptr, std::string output_file)
@@ -174,6 +177,20 @@ PlumeOutput::PlumeOutput(const PlumeInputData *PID, Plume *plume_ptr, std::strin
     xR++;
   }
 
+  // kernel estimator: the half-width of the kernel follows the spread of the particle
+  // (local standard deviation of the velocity times the travel time)
+  useKernel = (PID->colParams->concentrationEstimator == "kernel");
+  kernelFactor = PID->colParams->kernelBandwidthFactor;
+  kernelMaxBoxes = PID->colParams->kernelMaxBoxes;
+  if (useKernel) {
+    std::cout << "[PlumeOutput]\t Using kernel concentration estimator (bandwidth factor = "
+              << kernelFactor << ", max half-width = " << kernelMaxBoxes << " boxes)" << std::endl;
+    kernelX = ConcentrationKernel(nBoxesX, lBndx, boxSizeX, false);
+    kernelY = ConcentrationKernel(nBoxesY, lBndy, boxSizeY, false);
+    // the part of the kernel below the ground (z = 0) is reflected back above it
+    kernelZ = ConcentrationKernel(nBoxesZ, lBndz, boxSizeZ, true, 0.0);
+  }
+
   // initialization of the container
   pBox.resize(nBoxesX * nBoxesY * nBoxesZ, 0);
   conc.resize(nBoxesX * nBoxesY * nBoxesZ, 0.0);
@@ -293,11 +310,25 @@ void PlumeOutput::save(QEStime timeIn)
     ongoingAveragingTime += timeStep;
 
     // count the mass and number of particle in each box
-    boxCount();
+    if (useKernel) {
+      kernelCount();
+    } else {
+      boxCount();
+    }
 
     // output to NetCDF file
     if (timeIn >= nextOutputTime) {
 
+      // distributed mode: sum the counts of all the processes on the root process
+      // (the deposited mass is cumulative, the local values are kept for the next outputs)
+      m_plume->sumOnRoot(pBox);
+      m_plume->sumOnRoot(conc);
+      std::vector<float> localDepcvol;
+      if (m_plume->isDistributed()) {
+        localDepcvol = m_plume->deposition->depcvol;
+        m_plume->sumOnRoot(m_plume->deposition->depcvol);
+      }
+
       // adjusting concentration for averaging time and volume of the box
       // cc = 1/Tavg * 1/vol => in kg/m3
       // conc count the mass in the box * dt
@@ -310,6 +341,9 @@ void PlumeOutput::save(QEStime timeIn)
 
       // save the fields to NetCDF files
       saveOutputFields();
+      if (m_plume->isDistributed()) {
+        m_plume->deposition->depcvol.swap(localDepcvol);
+      }
 
       // reset container for the next averaging period
       ongoingAveragingTime = 0.0;
@@ -367,3 +401,57 @@ void PlumeOutput::boxCount()
 
   }// particle loop
 }
+
+void PlumeOutput::kernelCount()
+{
+  // travel time of the particles is measured from the start of the simulation (as tStrt)
+  double simTime = m_plume->getSimTimeCurrent() - m_plume->getSimTimeStart();
+
+  std::vector<Particle *> tmp(m_plume->particleList.begin(), m_plume->particleList.end());
+
+#pragma omp parallel for schedule(dynamic, 256) default(none) shared(tmp, simTime)
+  for (size_t n = 0; n < tmp.size(); ++n) {
+    Particle *par = tmp[n];
+    if (!par->isActive) {
+      continue;
+    }
+
+    // half-width of the kernel in each direction
+    double age = simTime - par->tStrt;
+    age = (age > 0.0) ? age : 0.0;
+    double hx = std::min(kernelFactor * std::sqrt(std::max(par->txx_old, 0.0)) * age, (double)kernelMaxBoxes * boxSizeX);
+    double hy = std::min(kernelFactor * std::sqrt(std::max(par->tyy_old, 0.0)) * age, (double)kernelMaxBoxes * boxSizeY);
+    double hz = std::min(kernelFactor * std::sqrt(std::max(par->tzz_old, 0.0)) * age, (double)kernelMaxBoxes * boxSizeZ);
+
+    int ix, iy, iz;
+    std::vector<double> wx, wy, wz;
+    if (!kernelX.weights(par->xPos, hx, ix, wx)
+        || !kernelY.weights(par->yPos, hy, iy, wy)
+        || !kernelZ.weights(par->zPos, hz, iz, wz)) {
+      continue;
+    }
+
+    // the particle counter is kept for the box the particle is in
+    int idx = floor((par->xPos - lBndx) / (boxSizeX + 1e-9));
+    int idy = floor((par->yPos - lBndy) / (boxSizeY + 1e-9));
+    int idz = floor((par->zPos - lBndz) / (boxSizeZ + 1e-9));
+    if (idx >= 0 && idx <= nBoxesX - 1 && idy >= 0 && idy <= nBoxesY - 1 && idz >= 0 && idz <= nBoxesZ - 1) {
+      int id = idz * nBoxesY * nBoxesX + idy * nBoxesX + idx;
+#pragma omp atomic
+      pBox[id]++;
+    }
+
+    double mass = par->m * par->wdecay * timeStep;
+    for (size_t k = 0; k < wz.size(); ++k) {
+      for (size_t j = 0; j < wy.size(); ++j) {
+        double wzy = mass * wz[k] * wy[j];
+        int id = (iz + k) * nBoxesY * nBoxesX + (iy + j) * nBoxesX + ix;
+        for (size_t i = 0; i < wx.size(); ++i) {
+          float val = wzy * wx[i];
+#pragma omp atomic
+          conc[id + i] += val;
+        }
+      }
+    }
+  }
+}
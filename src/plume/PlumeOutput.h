@@ -42,6 +42,7 @@
 #include <string>
 
 #include "PlumeInputData.hpp"
+#include "ConcentrationKernel.h"
 #include "winds/WINDSGeneralData.h"
 
 #include "util/QESNetCDFOutput.h"
@@ -82,6 +83,11 @@ public:
   std::vector<int> pBox;// sampling box particle counter (for average)
   std::vector<float> conc;// concentration values (for output)
 
+  // kernel estimator of the concentration (instead of the box count)
+  bool useKernel = false;
+  float kernelFactor;// half-width = kernelFactor * sigma * travel time
+  float kernelMaxBoxes;// cap of the half-width (in number of boxes)
+
 private:
   // default constructor
   PlumeOutput() {}
@@ -104,4 +110,9 @@ private:
 
   // function for counting the number of particles in the sampling boxes
   void boxCount();
+  // function spreading the mass of the particles over the sampling boxes with a compact kernel
+  void kernelCount();
+
+  // kernel in each direction (the boxes in z are folded at the ground)
+  ConcentrationKernel kernelX, kernelY, kernelZ;
 };
@@ -0,0 +1,224 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Plume
+ *
+ * GPL-3.0 License
+ *
+ * QES-Plume is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Plume is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Plume. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file PlumeOutputReceptors.cpp
+ * @brief This class handles saving output files for the concentration time series at receptors
+ * (points with a small sampling volume) instead of the full grid of collection boxes.
+ * This is a specialized output class derived and inheriting from QESNetCDFOutput.
+ *
+ * @note child of QESNetCDFOutput
+ * @sa QESNetCDFOutput
+ */
+
+#include "PlumeOutputReceptors.h"
+#include "Plume.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+PlumeOutputReceptors::PlumeOutputReceptors(const PlumeInputData *PID, Plume *plume_ptr, std::string output_file)
+  : QESNetCDFOutput(output_file)
+{
+  std::cout << "[PlumeOutputReceptors]\t Setting NetCDF file: " << output_file << std::endl;
+
+  // setup copy of plume pointer so output data can be grabbed directly
+  m_plume = plume_ptr;
+
+  const ReceptorParameters *recParams = PID->receptorParams;
+
+  // setup output frequency control information (same start as the collection boxes)
+  averagingStartTime = m_plume->getSimTimeStart() + PID->colParams->averagingStartTime;
+  timeStep = PID->plumeParams->timeStep;
+  averagingPeriod = (recParams->averagingPeriod > 0.0) ? recParams->averagingPeriod : timeStep;
+  nextOutputTime = averagingStartTime + averagingPeriod;
+
+  // --------------------------------------------------------
+  // setup information: receptors
+  // --------------------------------------------------------
+
+  nReceptors = recParams->receptors.size();
+  size_t nameLength = 1;
+  for (int r = 0; r < nReceptors; ++r) {
+    const Receptor *rec = recParams->receptors[r];
+    xRec.push_back(rec->xPos);
+    yRec.push_back(rec->yPos);
+    zRec.push_back(rec->zPos);
+    xSize.push_back(rec->xSize);
+    ySize.push_back(rec->ySize);
+    zSize.push_back(rec->zSize);
+    nameLength = std::max(nameLength, rec->name.size());
+  }
+  names.resize(nReceptors * nameLength, '\0');
+  for (int r = 0; r < nReceptors; ++r) {
+    const std::string &name = recParams->receptors[r]->name;
+    std::copy(name.begin(), name.end(), names.begin() + r * nameLength);
+  }
+
+  // spatial hash: a bin is at least as large as every receptor,
+  // so a receptor overlaps at most 2 bins in each direction
+  binSize[0] = *std::max_element(xSize.begin(), xSize.end());
+  binSize[1] = *std::max_element(ySize.begin(), ySize.end());
+  binSize[2] = *std::max_element(zSize.begin(), zSize.end());
+  for (int r = 0; r < nReceptors; ++r) {
+    int i0 = std::floor((xRec[r] - 0.5 * xSize[r]) / binSize[0]), i1 = std::floor((xRec[r] + 0.5 * xSize[r]) / binSize[0]);
+    int j0 = std::floor((yRec[r] - 0.5 * ySize[r]) / binSize[1]), j1 = std::floor((yRec[r] + 0.5 * ySize[r]) / binSize[1]);
+    int k0 = std::floor((zRec[r] - 0.5 * zSize[r]) / binSize[2]), k1 = std::floor((zRec[r] + 0.5 * zSize[r]) / binSize[2]);
+    for (int k = k0; k <= k1; ++k) {
+      for (int j = j0; j <= j1; ++j) {
+        for (int i = i0; i <= i1; ++i) {
+          bins[binKey((i + 0.5) * binSize[0], (j + 0.5) * binSize[1], (k + 0.5) * binSize[2])].push_back(r);
+        }
+      }
+    }
+  }
+
+  // initialization of the container
+  pRec.resize(nReceptors, 0);
+  conc.resize(nReceptors, 0.0);
+
+  // --------------------------------------------------------
+  // setup the netcdf output information storage
+  // --------------------------------------------------------
+
+  setStartTime(m_plume->getSimTimeStart());
+
+  output_fields = { "name", "x", "y", "z", "xSize", "ySize", "zSize", "pRec", "conc", "tAvg" };
+
+  NcDim NcDim_rec = addDimension("receptor", nReceptors);
+  NcDim NcDim_name = addDimension("nameLength", nameLength);
+
+  // create attributes for time dimension
+  std::vector<NcDim> dim_vect_t;
+  dim_vect_t.push_back(NcDim_t);
+  createAttScalar("tAvg", "Averaging time", "s", dim_vect_t, &ongoingAveragingTime);
+
+  // create attributes of the receptors
+  std::vector<NcDim> dim_vect_rec;
+  dim_vect_rec.push_back(NcDim_rec);
+  createAttVector("x", "x-center receptor", "m", dim_vect_rec, &xRec);
+  createAttVector("y", "y-center receptor", "m", dim_vect_rec, &yRec);
+  createAttVector("z", "z-center receptor", "m", dim_vect_rec, &zRec);
+  createAttVector("xSize", "x-size receptor", "m", dim_vect_rec, &xSize);
+  createAttVector("ySize", "y-size receptor", "m", dim_vect_rec, &ySize);
+  createAttVector("zSize", "z-size receptor", "m", dim_vect_rec, &zSize);
+  std::vector<NcDim> dim_vect_name;
+  dim_vect_name.push_back(NcDim_rec);
+  dim_vect_name.push_back(NcDim_name);
+  createAttVector("name", "name receptor", "--", dim_vect_name, &names);
+
+  // create attributes for the time series (nt,nReceptors)
+  std::vector<NcDim> dim_vect_ts;
+  dim_vect_ts.push_back(NcDim_t);
+  dim_vect_ts.push_back(NcDim_rec);
+  createAttVector("pRec", "number of particle per receptor", "#ofPar", dim_vect_ts, &pRec);
+  createAttVector("conc", "concentration", "g m-3", dim_vect_ts, &conc);
+
+  // create output fields
+  addOutputFields();
+}
+
+long long PlumeOutputReceptors::binKey(const double &x, const double &y, const double &z) const
+{
+  // 21 bits per direction (bins centered on the origin)
+  const long long offset = 1 << 20, mask = (1 << 21) - 1;
+  long long i = ((long long)std::floor(x / binSize[0]) + offset) & mask;
+  long long j = ((long long)std::floor(y / binSize[1]) + offset) & mask;
+  long long k = ((long long)std::floor(z / binSize[2]) + offset) & mask;
+  return (k << 42) | (j << 21) | i;
+}
+
+void PlumeOutputReceptors::save(QEStime timeIn)
+{
+  if (timeIn > averagingStartTime) {
+
+    // incrementation of the averaging time
+    ongoingAveragingTime += timeStep;
+
+    // count the mass and number of particle in each receptor
+    receptorCount();
+
+    // output to NetCDF file
+    if (timeIn >= nextOutputTime) {
+
+      // distributed mode: sum the counts of all the processes on the root process
+      m_plume->sumOnRoot(pRec);
+      m_plume->sumOnRoot(conc);
+
+      // adjusting concentration for averaging time and volume of the receptor
+      for (int r = 0; r < nReceptors; ++r) {
+        conc[r] = conc[r] / (ongoingAveragingTime * xSize[r] * ySize[r] * zSize[r]);
+      }
+
+      // set output time for correct netcdf output
+      timeCurrent = timeIn;
+
+      // save the fields to NetCDF files
+      saveOutputFields();
+
+      // reset container for the next averaging period
+      ongoingAveragingTime = 0.0;
+      std::fill(pRec.begin(), pRec.end(), 0);
+      std::fill(conc.begin(), conc.end(), 0.0);
+
+      // update the next output time value
+      nextOutputTime = nextOutputTime + averagingPeriod;
+    }
+  }
+}
+
+void PlumeOutputReceptors::receptorCount()
+{
+  std::vector<Particle *> tmp(m_plume->particleList.begin(), m_plume->particleList.end());
+
+#pragma omp parallel for schedule(dynamic, 1024) default(none) shared(tmp)
+  for (size_t n = 0; n < tmp.size(); ++n) {
+    Particle *par = tmp[n];
+    if (!par->isActive) {
+      continue;
+    }
+
+    // receptors listed in the bin of the particle (the receptors can overlap)
+    auto bin = bins.find(binKey(par->xPos, par->yPos, par->zPos));
+    if (bin == bins.end()) {
+      continue;
+    }
+    for (auto r : bin->second) {
+      if (std::abs(par->xPos - xRec[r]) <= 0.5 * xSize[r]
+          && std::abs(par->yPos - yRec[r]) <= 0.5 * ySize[r]
+          && std::abs(par->zPos - zRec[r]) <= 0.5 * zSize[r]) {
+        float mass = par->m * par->wdecay * timeStep;
+#pragma omp atomic
+        pRec[r]++;
+#pragma omp atomic
+        conc[r] += mass;
+      }
+    }
+  }
+}
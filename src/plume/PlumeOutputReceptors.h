@@ -0,0 +1,99 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Plume
+ *
+ * GPL-3.0 License
+ *
+ * QES-Plume is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Plume is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Plume. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file PlumeOutputReceptors.h
+ * @brief This class handles saving output files for the concentration time series at receptors
+ * (points with a small sampling volume) instead of the full grid of collection boxes.
+ * This is a specialized output class derived and inheriting from QESNetCDFOutput.
+ *
+ * @note child of QESNetCDFOutput
+ * @sa QESNetCDFOutput
+ */
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+
+#include "PlumeInputData.hpp"
+
+#include "util/QESNetCDFOutput.h"
+#include "util/QEStime.h"
+
+class Plume;
+
+class PlumeOutputReceptors : public QESNetCDFOutput
+{
+public:
+  // specialized constructor
+  PlumeOutputReceptors(const PlumeInputData *PID, Plume *plume_ptr, std::string output_file);
+
+  // deconstructor
+  ~PlumeOutputReceptors()
+  {
+  }
+
+  // sample the particles at the receptors for the given time and save the time series
+  // at the end of each averaging period (every timestep by default)
+  void save(QEStime);
+
+  int nReceptors;// number of receptors
+  // receptor geometry (center and size of the sampling volume)
+  std::vector<float> xRec, yRec, zRec;
+  std::vector<float> xSize, ySize, zSize;
+  std::vector<char> names;// names of the receptors (nReceptors x nameLength characters)
+
+  // output storage variables
+  std::vector<int> pRec;// receptor particle counter
+  std::vector<float> conc;// concentration values (for output)
+
+private:
+  // default constructor
+  PlumeOutputReceptors() {}
+
+  // function assigning the particles to the receptors
+  void receptorCount();
+
+  // spatial hash of the receptors: uniform bins of the size of the largest receptor,
+  // each receptor is listed in the bins its sampling volume overlaps
+  long long binKey(const double &, const double &, const double &) const;
+  double binSize[3];
+  std::unordered_map<long long, std::vector<int>> bins;
+
+  // time averaging and output control
+  QEStime averagingStartTime;
+  float averagingPeriod;
+  float timeStep;
+  float ongoingAveragingTime = 0.0;
+  QEStime nextOutputTime;
+
+  // pointer to the class that save needs to use to get the data for the concentration calculation
+  Plume *m_plume;
+};
@@ -64,6 +64,13 @@ public:
 			       nearestCell - use value from the cell where the particle is 
 			       analyticalPowerLaw - use analytical solution from the power law
 			    */
+  bool timeInterpolation = false; /**< blend the wind and turbulence fields linearly in time
+				     between the two stored timesteps bracketing each particle substep */
+
+  int particleBudget = 0; /**< target number of active particles of the population control
+			     (co-located light particles are merged above it, heavy particles in the
+			     collection boxes are split below it), 0 turns the population control off */
+  int maxSplitGenerations = 3; /**< maximum number of times a released particle can be split */
 
   /**
    * Parse the input file for parameters.
@@ -81,6 +88,9 @@ public:
 
     interpMethod = "triLinear";
     parsePrimitive<std::string>(false, interpMethod, "interpolationMethod");
+    parsePrimitive<bool>(false, timeInterpolation, "timeInterpolation");
+    parsePrimitive<int>(false, particleBudget, "particleBudget");
+    parsePrimitive<int>(false, maxSplitGenerations, "maxSplitGenerations");
 
     // check some of the parsed values to see if they make sense
     checkParsedValues();
@@ -131,6 +141,20 @@ public:
       exit(EXIT_FAILURE);
     }
 
+    // make sure the population control variables are not negative
+    if (particleBudget < 0) {
+      std::cerr << "(SimulationParameters::checkParsedValues): "
+                << "input particleBudget must be zero or greater!";
+      std::cerr << " particleBudget = \"" << particleBudget << "\"" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (maxSplitGenerations < 0) {
+      std::cerr << "(SimulationParameters::checkParsedValues): "
+                << "input maxSplitGenerations must be zero or greater!";
+      std::cerr << " maxSplitGenerations = \"" << maxSplitGenerations << "\"" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+
 
     // make sure the input timestep is not greater than the simDur
     if (timeStep > simDur) {
@@ -0,0 +1,175 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Plume
+ *
+ * GPL-3.0 License
+ *
+ * QES-Plume is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Plume is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Plume. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file PopulationControl.cpp
+ * @brief Merging and splitting of the particles to keep the number of active particles near a budget
+ */
+
+#include "Plume.hpp"
+
+#include <algorithm>
+#include <map>
+
+#include "util/QESprofile.h"
+
+namespace {
+// mass carried by a particle (as counted in the concentration)
+double effectiveMass(const Particle *par_ptr)
+{
+  return par_ptr->m * par_ptr->wdecay;
+}
+
+// scales all the masses of a particle
+void scaleMass(Particle *par_ptr, const double &scale)
+{
+  par_ptr->m *= scale;
+  par_ptr->m_kg *= scale;
+  par_ptr->m_o *= scale;
+  par_ptr->m_kg_o *= scale;
+}
+}// namespace
+
+void Plume::controlPopulation()
+{
+  if (particleBudget <= 0) {
+    return;
+  }
+  QESprofile::Scope profile("population_control");
+
+  // in distributed mode, each process keeps its share of the budget
+  long budget = particleBudget / mpiSize;
+  long nActive = particleList.size();
+
+  // the particles are split only well below the budget, so that the merged
+  // particles are not split again at the next timestep
+  if (nActive > budget) {
+    long nMerged = mergeParticles(nActive - budget);
+    QESprofile::addCount("plume/particles_merged", nMerged);
+  } else if (nActive < 0.9 * budget) {
+    long nSplit = splitParticles(budget - nActive);
+    QESprofile::addCount("plume/particles_split", nSplit);
+  }
+}
+
+long Plume::mergeParticles(long excess)
+{
+  long nActive = particleList.size();
+
+  // groups of co-located particles: same cell of the QES grid and same source
+  // (the particles of a source share their physical properties)
+  std::map<long, std::vector<Particle *>> groups;
+  long nSources = std::max<long>(allSources.size(), 1);
+  for (auto &par_ptr : particleList) {
+    if (par_ptr->isActive) {
+      long cellId = interp->getCellId(par_ptr->xPos, par_ptr->yPos, par_ptr->zPos);
+      groups[cellId * nSources + par_ptr->sourceIdx].push_back(par_ptr);
+    }
+  }
+
+  long nMerged = 0;
+  for (auto &group : groups) {
+    std::vector<Particle *> &pars = group.second;
+    // only the lightest half of the group is merged, each group contributes
+    // in proportion of its number of particles
+    long quota = std::min<long>(pars.size() / 4, (excess * pars.size() + nActive - 1) / nActive);
+    quota = std::min(quota, excess - nMerged);
+    if (quota <= 0) {
+      continue;
+    }
+    std::sort(pars.begin(), pars.end(), [](const Particle *a, const Particle *b) {
+      return effectiveMass(a) < effectiveMass(b);
+    });
+
+    for (long q = 0; q < quota; ++q) {
+      Particle *keep = pars[2 * q];
+      Particle *drop = pars[2 * q + 1];
+      double mKeep = effectiveMass(keep);
+      double mDrop = effectiveMass(drop);
+
+      // the survivor is drawn with a probability proportional to its mass and carries the mass
+      // of the pair: the mass is conserved and the mean and variance of the velocities and
+      // positions of the population are unbiased
+#ifdef _OPENMP
+      double r = threadRNG[omp_get_thread_num()]->uniRan();
+#else
+      double r = RNG->uniRan();
+#endif
+      if (r * (mKeep + mDrop) >= mKeep) {
+        std::swap(keep, drop);
+        std::swap(mKeep, mDrop);
+      }
+      if (mKeep > 0.0) {
+        scaleMass(keep, (mKeep + mDrop) / mKeep);
+      }
+      keep->splitLevel = std::min(keep->splitLevel, drop->splitLevel);
+      drop->isActive = false;
+      nMerged++;
+    }
+
+    if (nMerged >= excess) {
+      break;
+    }
+  }
+
+  if (nMerged > 0) {
+    scrubParticleList();
+  }
+  return nMerged;
+}
+
+long Plume::splitParticles(long deficit)
+{
+  // particles in the region of interest that can still be split
+  std::vector<Particle *> candidates;
+  for (auto &par_ptr : particleList) {
+    if (par_ptr->isActive && par_ptr->splitLevel < maxSplitGenerations
+        && par_ptr->xPos >= roiBounds[0] && par_ptr->xPos <= roiBounds[1]
+        && par_ptr->yPos >= roiBounds[2] && par_ptr->yPos <= roiBounds[3]
+        && par_ptr->zPos >= roiBounds[4] && par_ptr->zPos <= roiBounds[5]
+        && effectiveMass(par_ptr) > 0.0) {
+      candidates.push_back(par_ptr);
+    }
+  }
+
+  // the heaviest particles are split first
+  long nSplit = std::min<long>(deficit, candidates.size());
+  std::partial_sort(candidates.begin(), candidates.begin() + nSplit, candidates.end(), [](const Particle *a, const Particle *b) {
+    return effectiveMass(a) > effectiveMass(b);
+  });
+
+  for (long n = 0; n < nSplit; ++n) {
+    // the two halves start from the same state and separate with their own random increments
+    Particle *par_ptr = candidates[n];
+    scaleMass(par_ptr, 0.5);
+    par_ptr->splitLevel++;
+    particleList.push_back(par_ptr->clone());
+  }
+  return nSplit;
+}
@@ -0,0 +1,112 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Plume
+ *
+ * GPL-3.0 License
+ *
+ * QES-Plume is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Plume is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Plume. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file ReceptorParameters.hpp
+ * @brief This class contains the receptors (monitor points/volumes) read from the xml,
+ * where the concentration is sampled as time series.
+ *
+ * @note Child of ParseInterface
+ * @sa ParseInterface
+ */
+
+#pragma once
+
+#include "util/ParseInterface.h"
+#include <string>
+#include <vector>
+
+class Receptor : public ParseInterface
+{
+private:
+public:
+  std::string name = "";// name of the receptor (optional)
+  float xPos{}, yPos{}, zPos{};// center of the receptor
+  // size of the sampling volume of the receptor (negative -> size set in receptorParameters)
+  float xSize = -1.0, ySize = -1.0, zSize = -1.0;
+
+  void parseValues() override
+  {
+    parsePrimitive<std::string>(false, name, "name");
+    parsePrimitive<float>(true, xPos, "xPos");
+    parsePrimitive<float>(true, yPos, "yPos");
+    parsePrimitive<float>(true, zPos, "zPos");
+    parsePrimitive<float>(false, xSize, "xSize");
+    parsePrimitive<float>(false, ySize, "ySize");
+    parsePrimitive<float>(false, zSize, "zSize");
+  }
+};
+
+class ReceptorParameters : public ParseInterface
+{
+private:
+public:
+  // default size of the sampling volumes
+  float xSize{}, ySize{}, zSize{};
+  // averaging period of the time series (0 -> every timestep)
+  float averagingPeriod = 0.0;
+  std::vector<Receptor *> receptors;
+
+  void parseValues() override
+  {
+    parsePrimitive<float>(true, xSize, "xSize");
+    parsePrimitive<float>(true, ySize, "ySize");
+    parsePrimitive<float>(true, zSize, "zSize");
+    parsePrimitive<float>(false, averagingPeriod, "timeAvgFreq");
+    parseMultiElements<Receptor>(true, receptors, "receptor");
+
+    // the receptors without a size get the default size
+    for (auto &r : receptors) {
+      if (r->xSize <= 0.0) r->xSize = xSize;
+      if (r->ySize <= 0.0) r->ySize = ySize;
+      if (r->zSize <= 0.0) r->zSize = zSize;
+    }
+
+    // check some of the parsed values to see if they make sense
+    checkParsedValues();
+  }
+
+  void checkParsedValues()
+  {
+    if (receptors.empty()) {
+      std::cerr << "(ReceptorParameters::checkParsedValues): at least one receptor is needed!" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (xSize <= 0 || ySize <= 0 || zSize <= 0) {
+      std::cerr << "(ReceptorParameters::checkParsedValues): input xSize, ySize, and zSize must be greater than zero!";
+      std::cerr << " xSize = \"" << xSize << "\", ySize = \"" << ySize << "\", zSize = \"" << zSize << "\"" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    if (averagingPeriod < 0) {
+      std::cerr << "(ReceptorParameters::checkParsedValues): input timeAvgFreq must be zero or greater!";
+      std::cerr << " timeAvgFreq = \"" << averagingPeriod << "\"" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+};
@@ -81,6 +81,12 @@ public:
                        double &,
                        double &,
                        double &) = 0;
+
+  // number of bounces on the walls since the last call (0 if the method does not count them)
+  virtual long takeBounceCount()
+  {
+    return 0;
+  }
 };
 
 class WallReflection_DoNothing : public WallReflection
@@ -35,6 +35,9 @@
 #include "WallReflection_StairStep.h"
 #include "Plume.hpp"
 
+#include <algorithm>
+#include <limits>
+
 bool WallReflection_StairStep::reflect(const WINDSGeneralData *WGD,
                                        const Plume *plume,
                                        double &xPos,
@@ -62,7 +65,8 @@ bool WallReflection_StairStep::reflect(const WINDSGeneralData *WGD,
    * - no valid surface for reflection 
    */
 
-  // linearized cell ID for end of the trajectory of the particle
+  // linearized cell ID for start and end of the trajectory of the particle
+  int cellIdOld = plume->interp->getCellId(xPos - disX, yPos - disY, zPos - disZ);
   int cellIdNew = plume->interp->getCellId(xPos, yPos, zPos);
   int cellFlag(0);
   try {
@@ -79,384 +83,164 @@ bool WallReflection_StairStep::reflect(const WINDSGeneralData *WGD,
     }
   }
 
-  if ((cellFlag != 0) && (cellFlag != 2)) {
-    // particle end trajectory outside solide -> no need for reflection
+  if ((cellIdNew == cellIdOld) && (cellFlag != 0) && (cellFlag != 2)) {
+    // particle trajectory within one fluid cell -> no need for reflection
     return true;
   } else {
-    // particle end trajectory inside solide -> need for reflection
+    // particle trajectory across at least one face -> the cells crossed are traversed
+    // (a thin solid can lie between two fluid cells)
 
     // position of the particle start of trajectory
     Vector3Double X = { xPos - disX, yPos - disY, zPos - disZ };
     // vector of the trajectory
     Vector3Double U = { disX, disY, disZ };
-    // postion of the particle end of trajectory
-    Vector3Double Xnew = X + U;
     // vector of fluctuations
     Vector3Double vecFluct = { uFluct, vFluct, wFluct };
 
-    double d = U.length();
-    double d1 = 0.0;
-    double d2 = U.length();
-
-    // normailzation of direction verctor for particle trajectory
-    U = U / U.length();
-    bool isActive = true;
-    trajectorySplit_recursive(WGD, plume, X, U, d, d1, d2, vecFluct, isActive);
-
-    if (isActive) {
-      // update output variable: particle position
-      xPos = X[0];
-      yPos = X[1];
-      zPos = X[2];
-      // update output variable: fluctuations
-      uFluct = vecFluct[0];
-      vFluct = vecFluct[1];
-      wFluct = vecFluct[2];
-      return true;
-    } else {
+    int count = 0;
+    if (!traverse(WGD, plume, X, U, vecFluct, count)) {
       return false;
     }
+    nBounces += count;
+
+    // update output variable: particle position
+    xPos = X[0];
+    yPos = X[1];
+    zPos = X[2];
+    // update output variable: fluctuations
+    uFluct = vecFluct[0];
+    vFluct = vecFluct[1];
+    wFluct = vecFluct[2];
+    return true;
   }
 
   // should never be there
   return false;
 }
 
-void WallReflection_StairStep::trajectorySplit_recursive(const WINDSGeneralData *WGD,
-                                                         const Plume *plume,
-                                                         Vector3Double &X,
-                                                         Vector3Double &u,
-                                                         const double &d,
-                                                         double &d1,
-                                                         double &d2,
-                                                         Vector3Double &vecFluct,
-                                                         bool &isActive)
+bool WallReflection_StairStep::traverse(const WINDSGeneralData *WGD,
+                                        const Plume *plume,
+                                        Vector3Double &X,
+                                        Vector3Double U,
+                                        Vector3Double &vecFluct,
+                                        int &count)
 {
   /*
-    - d total distance
-    - d1 total distance traveled so far
-    - d2 distance traveled this step 
-  */
-
-  if (std::abs(d1 - d) < 1.0E-3) {
-    //std::cerr << "END OF REGRESSION dist \t" << std::abs(d1 - d) << std::endl;
-    // isActive = true;
-    return;
-  } else if (!isActive) {
-    return;
-  } else {
-
-    Vector3Double Xold = X;
-    Vector3Double Xnew = X + d2 * u;
-
-    // linearized cell ID for origine of the trajectory of the particle
-    int cellIdOld = plume->interp->getCellId(Xold);
-    // i,j,k of cell index
-    Vector3Int cellIdxOld = plume->interp->getCellIndex(cellIdOld);
-
-    // linearized cell ID for origine of the trajectory of the particle
-    int cellIdNew = plume->interp->getCellId(Xnew);
-    // i,j,k of cell index
-    Vector3Int cellIdxNew = plume->interp->getCellIndex(cellIdNew);
-
-
-    if ((abs(cellIdxOld[0] - cellIdxNew[0]) > 1)
-        || (abs(cellIdxOld[1] - cellIdxNew[1]) > 1)
-        || (abs(cellIdxOld[2] - cellIdxNew[2]) > 1)) {
-      d2 = 0.5 * d2;
-      if (d2 < 0.125 * d) {
-        std::cerr << "END OF REGRESSION dist \t" << d2 / d << std::endl;
-        isActive = false;
-      }
-
-    } else {
-      d1 += d2;
-      //X = Xold + d2 * u;
-      oneReflection(WGD, plume, X, u, d2, vecFluct, isActive);
-    }
-    // regression
-    trajectorySplit_recursive(WGD, plume, X, u, d, d1, d2, vecFluct, isActive);
-
-    //isActive = true;
-    return;
-  }
-  return;
-}
+   * Cells crossed by the trajectory are visited in order (Amanatides & Woo, 1987):
+   * t is the fraction of the trajectory U travelled from X, tMax[a] the fraction at which
+   * the next face in direction a is crossed. When the next cell is solid, the particle
+   * bounces on the face: the rest of the trajectory and the fluctuation are mirrored
+   * and the traversal continues from the bounce point in the same (fluid) cell.
+   *
+   * - X        = in: origine of the trajectory, out: end of the trajectory after the bounces
+   * - U        = trajectory of the particle
+   * - vecFluct = fluctuation of the particle (mirrored at each bounce)
+   * - count    = number of bounces
+   */
 
-void WallReflection_StairStep::oneReflection(const WINDSGeneralData *WGD,
-                                             const Plume *plume,
-                                             Vector3Double &X,
-                                             Vector3Double &u,
-                                             const double &d,
-                                             Vector3Double &vecFluct,
-                                             bool &isActive)
-{
-  // some constants
-  const double eps_S = 0.001;
-  const int maxCount = 10;
+  // safety net for degenerate corners: the particle stops on the wall
+  const int maxCount = 100;
 
   // QES-winds grid information
   int nx = WGD->nx;
   int ny = WGD->ny;
-  //int nz = WGD->nz;
+  int nz = WGD->nz;
   double dx = WGD->dx;
   double dy = WGD->dy;
-  //double dz = WGD->dz;
-
-  // cartesian basis vectors
-  const Vector3Double e1 = { 1.0, 0.0, 0.0 }, e2 = { 0.0, 1.0, 0.0 }, e3 = { 0.0, 0.0, 1.0 };
-
-  /* Vector3 variables informations:
-     Xold     = origine of the trajectory of the particle  
-     Xnew     = end of the trajectory of the particle 
-     vecFluct = fluctuation of the particle
-     P        = position of the particle on the wall where bounce happens
-     S        = location of the wall
-     U        = trajectory of the particle
-     V1       = trajectory of the particle to the wall V1 = P - Xold
-     V2       = trajectory of the particle to the wall V1 = Xnew - P
-     R        = unit vector giving orentation of the reflection
-     N        = unit vector noraml to the surface
-  */
-  Vector3Double Xnew, Xold, U;
-  Vector3Double P, S, V1, V2;
-  Vector3Double R, N;
-
-  Xold = X;
-  U = d * u;
-  Xnew = Xold + U;
-
-  // i,j,k of cell index
-  int cellIdOld = plume->interp->getCellId(Xold);
-  Vector3Int cellIdxOld = plume->interp->getCellIndex(cellIdOld);
-
-  int cellIdNew = plume->interp->getCellId(Xnew);
-  Vector3Int cellIdxNew = plume->interp->getCellIndex(cellIdNew);
-
-  // icellFlag of the cell at the end of the trajectory of the particle
-  int cellFlagNew = WGD->icellflag.at(cellIdNew);
-
-
-  /* Working variables informations:
-     count       - number of reflections
-     f1,f2,f3    - sign of trajectory in each direction (+/-1)
-     l1,l2,l3    - ratio of distance to wall over total distance travel to closest surface in 
-     -             each direction: by definition positive, if < 1 -> reflection possible
-     -             if > 1 -> surface too far
-     validSuface - number of potential valid surface
-     s           - smallest ratio of dist. to wall over total dist. travel (once surface selected)
-     r           - distance travel after reflection
-  */
-  int count = 0;
-  double f1, f2, f3;
-  double l1, l2, l3;
-  int validSurface;
-  double s, r;
 
-  while ((cellFlagNew == 0 || cellFlagNew == 2) && (count < maxCount)) {
-
-    cellIdOld = plume->interp->getCellId(Xold);
-    cellIdxOld = plume->interp->getCellIndex(cellIdOld);
-    int i = cellIdxOld[0], j = cellIdxOld[1], k = cellIdxOld[2];
-
-    //set direction
-    f1 = (e1 * U);
-    f1 = f1 / std::abs(f1);
-    f2 = (e2 * U);
-    f2 = f2 / std::abs(f2);
-    f3 = (e3 * U);
-    f3 = f3 / std::abs(f3);
-
-    // reset smallest ratio
-    s = 100.0;
-    // reset number of potential valid surface
-    validSurface = 0;
-    // reset distance travel after all
-    r = 0.0;
-
-    // x-drection
-    N = -f1 * e1;
-    S = { WGD->x[i] + f1 * 0.50 * dx, double(WGD->y[j]), double(WGD->z[k]) };
-    l1 = -(Xold * N - S * N) / (U * N);
-
-    // y-drection
-    N = -f2 * e2;
-    S = { double(WGD->x[i]), WGD->y[j] + f2 * 0.50 * dy, double(WGD->z[k]) };
-    l2 = -(Xold * N - S * N) / (U * N);
-
-    // z-drection (dz can be variable with hieght)
-    N = -f3 * e3;
-    if (f3 >= 0.0) {
-      S = { double(WGD->x[i]), double(WGD->y[j]), double(WGD->z_face[k + 1]) };
-    } else {
-      S = { double(WGD->x[i]), double(WGD->y[j]), double(WGD->z_face[k]) };
-    }
-    l3 = -(Xold * N - S * N) / (U * N);
+  // cell of the origine of the trajectory
+  Vector3Int cellIdx = plume->interp->getCellIndex(X[0], X[1], X[2]);
+  int idx[3] = { cellIdx[0], cellIdx[1], cellIdx[2] };
+  if (idx[0] < 0 || idx[0] > nx - 2 || idx[1] < 0 || idx[1] > ny - 2 || idx[2] < 0 || idx[2] > nz - 2) {
+    return false;
+  }
+  int cellFlag = WGD->icellflag[idx[0] + idx[1] * (nx - 1) + idx[2] * (nx - 1) * (ny - 1)];
+  if (cellFlag == 0 || cellFlag == 2) {
+    return false;
+  }
 
-    // check with surface is a potential bounce (0 < li < 1.0)
-    // if li=1 -> particle in surface, -> cause problem as particle will stay
-    // on the surface, move the reflection point slightly.
-    // check for surface in the x-direction
-    if ((l1 >= -eps_S) && (l1 <= 1.0 - eps_S)) {
-      validSurface++;
-      s = l1;
-      N = -f1 * e1;
-    } else if ((l1 >= 1.0 - eps_S) && (l1 <= 1.0 + eps_S)) {
-      validSurface++;
-      l1 -= 2 * eps_S;
-      s = l1;
-      N = -f1 * e1;
-    }
-    // check for surface in the y-direction
-    if ((l2 >= -eps_S) && (l2 <= 1.0 - eps_S)) {
-      validSurface++;
-      s = l2;
-      N = -f2 * e2;
-    } else if ((l2 >= 1.0 - eps_S) && (l2 <= 1.0 + eps_S)) {
-      validSurface++;
-      l2 -= 2 * eps_S;
-      s = l2;
-      N = -f2 * e2;
-    }
-    // check for surface in the z-direction
-    if ((l3 >= -eps_S) && (l3 <= 1.0 - eps_S)) {
-      validSurface++;
-      s = l3;
-      N = -f3 * e3;
-    } else if ((l3 >= 1.0 - eps_S) && (l3 <= 1.0 + eps_S)) {
-      validSurface++;
-      l3 -= 2 * eps_S;
-      s = l3;
-      N = -f3 * e3;
+  // lower and upper faces of the current cell in each direction
+  // (the indices are local to the window of the domain held by WGD, x and y cover the whole domain)
+  double lo[3], hi[3];
+  auto cellFaces = [&]() {
+    lo[0] = WGD->x[idx[0] + WGD->windowI0] - 0.5 * dx;
+    hi[0] = WGD->x[idx[0] + WGD->windowI0] + 0.5 * dx;
+    lo[1] = WGD->y[idx[1] + WGD->windowJ0] - 0.5 * dy;
+    hi[1] = WGD->y[idx[1] + WGD->windowJ0] + 0.5 * dy;
+    lo[2] = WGD->z_face[idx[2]];
+    hi[2] = WGD->z_face[idx[2] + 1];
+  };
+  cellFaces();
+  // guard against the round-off placing the particle on the face of a solid cell
+  auto clampToCell = [&]() {
+    for (int b = 0; b < 3; ++b) {
+      double eps = 1.0e-6 * (hi[b] - lo[b]);
+      X[b] = std::min(std::max(X[b], lo[b] + eps), hi[b] - eps);
     }
-
-    // check if more than one surface is valid
-    if (validSurface == 0) {
-      // if 0 valid surface
-      std::cerr << "[WARNING]\tReflection problem: no valid surface" << std::endl;
-      //std::cerr << "\tReflection problem: no valid surface\n"
-      //          << "\t" << count << " " << U.length() << "->"
-      //          << "[" << l1 << "," << l2 << "," << l3 << "]"
-      //          << std::endl;
-      //exit(EXIT_FAILURE);
-      isActive = false;
-      return;
-    } else if (validSurface == 1) {
-      // only one surface -> s and N already set above
-      /* NOTE: the particle travel between fluid -> solid, if only one surface is valid
-       *       the surface detected above has to be the reflection surface.
-       */
-
-      // for debug
-      //std::cerr << "[x,x,x][" << l1 << "," << l2 << "," << l3 << "] " << std::endl;
-    } else if (validSurface > 1) {
-      // Here-> Multiple options to bounce
-      // need to find the best surface
-      /* NOTE: the particle travel between fluid -> solid, if only multiple surface is valid
-       *       that means that the particle travel across a face in more that one direction. 
-       *       Some cell might be fluid, at least one will be solid. Need to check icellflag.
-       */
-
-      // list of potential surface
-      // - ratio of dist. to wall over dist. total
-      std::vector<double> vl(3, 0.0);
-      // - normal vector for each surface
-      std::vector<Vector3Double> vN(3, { 0, 0, 0 });
-      // - linear index for icellflag check
-      std::vector<int> vn(3, 0);
-
-      // add potential surface to the list (valid only if 0 <= li <= 1.0)
-      // -> only executed if 2 valid surfaces exist
-      // surface in the x-direction
-      vl[0] = l1;
-      vN[0] = -f1 * e1;
-      vn[0] = f1;
-      // surface in the y-direction
-      vl[1] = l2;
-      vN[1] = -f2 * e2;
-      vn[1] = f2 * (nx - 1);
-      // surface in the z-direction
-      vl[2] = l3;
-      vN[2] = -f3 * e3;
-      vn[2] = f3 * (nx - 1) * (ny - 1);
-
-      // sort indices from smallest to largest (only indices are sorted)
-      std::vector<size_t> idx(vl.size());
-      std::iota(idx.begin(), idx.end(), 0);
-      std::sort(idx.begin(), idx.end(), [&vl](size_t i1, size_t i2) { return vl[i1] < vl[i2]; });
-
-      // for debug
-      //std::cerr << "[" << idx[0] << "," << idx[1] << "," << idx[2] << "]"
-      //          << "[" << vl[0] << "," << vl[1] << "," << vl[2] << "] " << std::endl;
-
-      // check if surface is valid (ie, next cell is solid)
-      if ((WGD->icellflag.at(cellIdOld + vn[idx[0]]) == 0)
-          || (WGD->icellflag.at(cellIdOld + vn[idx[0]]) == 2)) {
-        s = vl[idx[0]];
-        N = vN[idx[0]];
-      } else if ((WGD->icellflag.at(cellIdOld + vn[idx[0]] + vn[idx[1]]) == 0)
-                 || (WGD->icellflag.at(cellIdOld + vn[idx[0]] + vn[idx[1]]) == 2)) {
-        s = vl[idx[1]];
-        N = vN[idx[1]];
-      } else if ((WGD->icellflag.at(cellIdOld + vn[idx[0]] + vn[idx[1]] + vn[idx[2]]) == 0)
-                 || (WGD->icellflag.at(cellIdOld + vn[idx[0]] + vn[idx[1]] + vn[idx[2]]) == 2)) {
-        s = vl[idx[2]];
-        N = vN[idx[2]];
+  };
+
+  count = 0;
+  while (true) {
+    // fraction of the trajectory to the next face in each direction
+    double tMax[3];
+    for (int a = 0; a < 3; ++a) {
+      if (U[a] > 0.0) {
+        tMax[a] = (hi[a] - X[a]) / U[a];
+      } else if (U[a] < 0.0) {
+        tMax[a] = (lo[a] - X[a]) / U[a];
       } else {
-        // this should happend only if particle traj. more than 1 cell in each direction,
-        // -> should have been skipped at the beginning of the function
-        //std::cerr << "Reflection problem: no valid surface" << std::endl;
-        isActive = false;
-        return;
+        tMax[a] = std::numeric_limits<double>::infinity();
       }
     }
-    // no else -> only one valid surface
 
-    // vector from current postition to the wall
-    V1 = s * U;
-    // postion of reflection on the wall
-    P = Xold + V1;
-    // distance traveled after the wall
-    V2 = U - V1;
-    r = V2.length();
-    // reflection: normalizing V2 -> R is of norm 1
-    V2 = V2 / V2.length();
-    R = V2.reflect(N);
-    // update postion from surface reflection
-    Xnew = P + r * R;
-    // reflection of the Fluctuation
-    vecFluct = vecFluct.reflect(N);
-    //vecFluct_old = vecFluct_old.reflect(N);
-    // prepare variables for next bounce: particle position
-    Xold = P;
+    bool bounce = false;
+    while (!bounce) {
+      // next face crossed
+      int a = (tMax[0] < tMax[1]) ? 0 : 1;
+      a = (tMax[2] < tMax[a]) ? 2 : a;
+
+      if (tMax[a] >= 1.0) {
+        // the trajectory ends in the current (fluid) cell
+        X = X + U;
+        clampToCell();
+        return true;
+      }
 
-    // distance travelled by particle
-    U = Xnew - Xold;
+      int next[3] = { idx[0], idx[1], idx[2] };
+      next[a] += (U[a] > 0.0) ? 1 : -1;
 
-    // increment the reflection count
-    count = count + 1;
-    // update the icellflag
-    cellIdNew = plume->interp->getCellId(Xnew);
+      if (next[2] < 0) {
+        // below the domain: treated as terrain
+        cellFlag = 2;
+      } else if (next[0] < 0 || next[0] > nx - 2 || next[1] < 0 || next[1] > ny - 2 || next[2] > nz - 2) {
+        // the trajectory leaves the domain: the domain boundary conditions take over
+        X = X + U;
+        return true;
+      } else {
+        cellFlag = WGD->icellflag[next[0] + next[1] * (nx - 1) + next[2] * (nx - 1) * (ny - 1)];
+      }
 
-    try {
-      cellFlagNew = WGD->icellflag.at(cellIdNew);
-    } catch (const std::out_of_range &oor) {
-      // cell ID out of bound
-      //std::cerr << "Reflection problem: particle out of range after reflection" << std::endl;
-      isActive = false;
-      return;
+      if (cellFlag == 0 || cellFlag == 2) {
+        // bounce on the face, the rest of the trajectory is mirrored
+        X = X + tMax[a] * U;
+        U = (1.0 - tMax[a]) * U;
+        U[a] = -U[a];
+        vecFluct[a] = -vecFluct[a];
+        count++;
+        if (count >= maxCount) {
+          clampToCell();
+          return true;
+        }
+        bounce = true;
+      } else {
+        // step in the next cell
+        idx[a] = next[a];
+        cellFaces();
+        tMax[a] = (U[a] > 0.0) ? (hi[a] - X[a]) / U[a] : (lo[a] - X[a]) / U[a];
+      }
     }
-
-  }// end of: while( (cellFlagNew==0 || cellFlagNew==2) && (count < maxCount) )
-
-  if (count < maxCount) {
-    X = Xnew;
-    u = U / U.length();
-    isActive = true;
-    return;
-  } else {
-    X = Xold;
-    isActive = false;
-    return;
   }
+
+  // should never be there
+  return false;
 }
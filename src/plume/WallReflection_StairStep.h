@@ -40,6 +40,7 @@
 #include <list>
 #include <cmath>
 #include <cstring>
+#include <atomic>
 
 #include "util/QEStime.h"
 #include "util/calcTime.h"
@@ -84,22 +85,22 @@ public:
                        double &vFluct,
                        double &wFluct);
 
+  // number of bounces on the walls since the last call
+  virtual long takeBounceCount()
+  {
+    return nBounces.exchange(0);
+  }
+
 private:
-  void trajectorySplit_recursive(const WINDSGeneralData *,
-                                 const Plume *,
-                                 Vector3Double &,
-                                 Vector3Double &,
-                                 const double &,
-                                 double &,
-                                 double &,
-                                 Vector3Double &,
-                                 bool &);
+  // traversal of the cells crossed by the trajectory (Amanatides-Woo) with the bounces on the solid
+  // cells handled iteratively, return false if the trajectory does not start in a fluid cell
+  bool traverse(const WINDSGeneralData *,
+                const Plume *,
+                Vector3Double &,
+                Vector3Double,
+                Vector3Double &,
+                int &);
 
-  void oneReflection(const WINDSGeneralData *,
-                     const Plume *,
-                     Vector3Double &,
-                     Vector3Double &,
-                     const double &,
-                     Vector3Double &,
-                     bool &);
+  // total number of bounces (particles are advected concurrently)
+  std::atomic<long> nBounces{ 0 };
 };
@@ -0,0 +1,271 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Winds
+ *
+ * GPL-3.0 License
+ *
+ * QES-Winds is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Winds is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Winds. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file FieldCache.cpp */
+
+#include "FieldCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "QESout.h"
+
+const char FieldCache::magic[8] = { 'Q', 'E', 'S', 'F', 'C', 'A', 'C', 'H' };
+
+FieldCache::FieldCache(const std::string &cacheFile)
+  : filename(cacheFile)
+{
+  std::cout << "[FieldCache] \t Mapping " << filename << std::endl;
+
+  fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    QESout::error("FieldCache: cannot open " + filename);
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+    QESout::error("FieldCache: invalid cache file " + filename);
+  }
+  mappedSize = st.st_size;
+
+  // read-only shared mapping: pages are shared with every process mapping the same file
+  void *addr = mmap(nullptr, mappedSize, PROT_READ, MAP_SHARED, fd, 0);
+  if (addr == MAP_FAILED) {
+    QESout::error("FieldCache: cannot map " + filename);
+  }
+  mapped = static_cast<const char *>(addr);
+
+  Header header;
+  std::memcpy(&header, mapped, sizeof(Header));
+  if (std::memcmp(header.magic, magic, sizeof(magic)) != 0 || header.version != 1
+      || header.tableOffset + header.nFields * sizeof(Entry) > mappedSize) {
+    QESout::error("FieldCache: invalid cache file " + filename);
+  }
+
+  for (uint32_t i = 0; i < header.nFields; ++i) {
+    Entry entry;
+    std::memcpy(&entry, mapped + header.tableOffset + i * sizeof(Entry), sizeof(Entry));
+    entry.name[sizeof(entry.name) - 1] = '\0';
+    entries[std::make_pair(std::string(entry.name), entry.step)] = entry;
+  }
+}
+
+FieldCache::~FieldCache()
+{
+  if (mapped) {
+    munmap(const_cast<char *>(mapped), mappedSize);
+  }
+  if (fd >= 0) {
+    ::close(fd);
+  }
+}
+
+bool FieldCache::exists(const std::string &cacheFile, const std::string &sourceFile)
+{
+  std::ifstream infile(cacheFile, std::ios::binary);
+  if (!infile) {
+    return false;
+  }
+  struct stat cacheStat, sourceStat;
+  if (!sourceFile.empty() && stat(cacheFile.c_str(), &cacheStat) == 0 && stat(sourceFile.c_str(), &sourceStat) == 0
+      && sourceStat.st_mtime > cacheStat.st_mtime) {
+    // the workspace has been rewritten since the cache was created
+    return false;
+  }
+  Header header;
+  infile.read(reinterpret_cast<char *>(&header), sizeof(Header));
+  return infile && std::memcmp(header.magic, magic, sizeof(magic)) == 0 && header.version == 1;
+}
+
+bool FieldCache::hasVariable(const std::string &name, const int &step) const
+{
+  return entries.find(std::make_pair(name, step)) != entries.end();
+}
+
+const FieldCache::Entry &FieldCache::findEntry(const std::string &name,
+                                               const int &step,
+                                               const uint32_t &type,
+                                               const size_t &typeSize) const
+{
+  auto it = entries.find(std::make_pair(name, step));
+  if (it == entries.end()) {
+    QESout::error("FieldCache: no variable " + name + " at step " + std::to_string(step) + " in " + filename);
+  }
+  const Entry &entry = it->second;
+  if (entry.type != type || entry.offset + entry.count * typeSize > mappedSize) {
+    QESout::error("FieldCache: wrong type or size for variable " + name + " in " + filename);
+  }
+  return entry;
+}
+
+template<typename T>
+void FieldCache::copyVariable(const std::string &name, const int &step, const uint32_t &type, std::vector<T> &external) const
+{
+  const Entry &entry = findEntry(name, step, type, sizeof(T));
+  external.resize(entry.count);
+  std::memcpy(external.data(), mapped + entry.offset, entry.count * sizeof(T));
+}
+
+void FieldCache::getVariableData(const std::string &name, const int &step, std::vector<int> &external) const
+{
+  copyVariable(name, step, INT_FIELD, external);
+}
+
+void FieldCache::getVariableData(const std::string &name, const int &step, std::vector<float> &external) const
+{
+  copyVariable(name, step, FLOAT_FIELD, external);
+}
+
+void FieldCache::getVariableData(const std::string &name, const int &step, std::vector<double> &external) const
+{
+  copyVariable(name, step, DOUBLE_FIELD, external);
+}
+
+FieldView<float> FieldCache::getVariableView(const std::string &name, const int &step) const
+{
+  const Entry &entry = findEntry(name, step, FLOAT_FIELD, sizeof(float));
+  return FieldView<float>(reinterpret_cast<const float *>(mapped + entry.offset), entry.count);
+}
+
+void FieldCache::willNeed(const std::string &name, const int &step) const
+{
+  auto it = entries.find(std::make_pair(name, step));
+  if (it == entries.end()) {
+    return;
+  }
+  // the blocks are aligned on 4096 bytes, the pages can be larger
+  const Entry &entry = it->second;
+  size_t typeSize = (entry.type == DOUBLE_FIELD) ? sizeof(double) : sizeof(float);
+  size_t pageSize = sysconf(_SC_PAGESIZE);
+  size_t start = entry.offset / pageSize * pageSize;
+  size_t end = std::min<size_t>(entry.offset + entry.count * typeSize, mappedSize);
+  madvise(const_cast<char *>(mapped) + start, end - start, MADV_WILLNEED);
+}
+
+
+FieldCacheWriter::FieldCacheWriter(const std::string &cacheFile)
+  : filename(cacheFile), tmpFilename(cacheFile + ".tmp" + std::to_string(getpid()))
+{
+  std::cout << "[FieldCache] \t Writing " << filename << std::endl;
+
+  outfile.open(tmpFilename, std::ios::binary | std::ios::trunc);
+  if (!outfile) {
+    QESout::error("FieldCache: cannot create " + tmpFilename);
+  }
+
+  // header is rewritten by close() once the table is known
+  FieldCache::Header header;
+  std::memset(&header, 0, sizeof(header));
+  outfile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  position = sizeof(header);
+}
+
+FieldCacheWriter::~FieldCacheWriter()
+{
+  if (outfile.is_open()) {
+    // not closed properly: do not leave a partial cache behind
+    outfile.close();
+    std::remove(tmpFilename.c_str());
+  }
+}
+
+void FieldCacheWriter::addVariable(const std::string &name, const int &step, const std::vector<int> &data)
+{
+  addBlock(name, step, FieldCache::INT_FIELD, reinterpret_cast<const char *>(data.data()), data.size(), sizeof(int));
+}
+
+void FieldCacheWriter::addVariable(const std::string &name, const int &step, const std::vector<float> &data)
+{
+  addBlock(name, step, FieldCache::FLOAT_FIELD, reinterpret_cast<const char *>(data.data()), data.size(), sizeof(float));
+}
+
+void FieldCacheWriter::addVariable(const std::string &name, const int &step, const std::vector<double> &data)
+{
+  addBlock(name, step, FieldCache::DOUBLE_FIELD, reinterpret_cast<const char *>(data.data()), data.size(), sizeof(double));
+}
+
+void FieldCacheWriter::addBlock(const std::string &name,
+                                const int &step,
+                                const uint32_t &type,
+                                const char *data,
+                                const uint64_t &count,
+                                const size_t &typeSize)
+{
+  if (name.size() >= sizeof(FieldCache::Entry::name)) {
+    QESout::error("FieldCache: variable name too long " + name);
+  }
+
+  // pad to the next page boundary
+  uint64_t offset = (position + FieldCache::alignment - 1) / FieldCache::alignment * FieldCache::alignment;
+  std::vector<char> padding(offset - position, 0);
+  outfile.write(padding.data(), padding.size());
+  outfile.write(data, count * typeSize);
+  position = offset + count * typeSize;
+
+  FieldCache::Entry entry;
+  std::memset(&entry, 0, sizeof(entry));
+  std::strncpy(entry.name, name.c_str(), sizeof(entry.name) - 1);
+  entry.step = step;
+  entry.type = type;
+  entry.count = count;
+  entry.offset = offset;
+  entries.push_back(entry);
+}
+
+void FieldCacheWriter::close()
+{
+  FieldCache::Header header;
+  std::memcpy(header.magic, FieldCache::magic, sizeof(header.magic));
+  header.version = 1;
+  header.nFields = entries.size();
+  header.tableOffset = position;
+
+  outfile.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(FieldCache::Entry));
+  outfile.seekp(0);
+  outfile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  outfile.close();
+  if (!outfile) {
+    std::remove(tmpFilename.c_str());
+    QESout::error("FieldCache: failed writing " + tmpFilename);
+  }
+
+  // atomic on POSIX, readers either see no cache or a complete one
+  if (std::rename(tmpFilename.c_str(), filename.c_str()) != 0) {
+    std::remove(tmpFilename.c_str());
+    QESout::error("FieldCache: cannot rename " + tmpFilename + " to " + filename);
+  }
+}
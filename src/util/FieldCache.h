@@ -0,0 +1,160 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Winds
+ *
+ * GPL-3.0 License
+ *
+ * QES-Winds is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Winds is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Winds. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file FieldCache.h */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "FieldView.h"
+
+/**
+ * @class FieldCache
+ * @brief Read-only, memory-mapped store of time-dependent fields.
+ *
+ * The cache is a flat binary file written once from a QES NetCDF workspace
+ * (see FieldCacheWriter). Every field is stored at a page-aligned offset so
+ * the file can be mapped read-only and shared through the page cache by any
+ * number of processes reading the same winds/turbulence. Loading a time step
+ * is then a plain copy from the mapping, without NetCDF decoding, or no copy
+ * at all for the fields that are only read (see getVariableView).
+ *
+ * File layout: header | page-aligned field blocks | table of entries
+ */
+class FieldCache
+{
+public:
+  FieldCache(const std::string &);
+  ~FieldCache();
+
+  /**
+   * Checks if a valid cache file exists at the given path and, if a source
+   * file is given, that the cache is not older than the source.
+   */
+  static bool exists(const std::string &, const std::string & = "");
+
+  bool hasVariable(const std::string &, const int &) const;
+
+  // copy the field at a given time step into the vector (resized as needed)
+  void getVariableData(const std::string &, const int &, std::vector<int> &) const;
+  void getVariableData(const std::string &, const int &, std::vector<float> &) const;
+  void getVariableData(const std::string &, const int &, std::vector<double> &) const;
+
+  /**
+   * Read-only view of the field at a given time step, pointing directly into
+   * the mapping (valid as long as the cache exists).
+   */
+  FieldView<float> getVariableView(const std::string &, const int &) const;
+
+  /**
+   * Asks the kernel to read the pages of the field at a given time step ahead
+   * of their use (the read-only views fault them in otherwise).
+   */
+  void willNeed(const std::string &, const int &) const;
+
+  static const char magic[8]; /**< signature at the start of every cache file */
+  static const uint64_t alignment = 4096; /**< alignment of the field blocks in the file */
+
+  enum FieldType : uint32_t {
+    INT_FIELD = 0,
+    FLOAT_FIELD = 1,
+    DOUBLE_FIELD = 2
+  };
+
+  struct Header
+  {
+    char magic[8];
+    uint32_t version;
+    uint32_t nFields;
+    uint64_t tableOffset;
+  };
+
+  struct Entry
+  {
+    char name[48];
+    int32_t step;
+    uint32_t type;
+    uint64_t count;
+    uint64_t offset;
+  };
+
+private:
+  FieldCache() = default;
+
+  const Entry &findEntry(const std::string &, const int &, const uint32_t &, const size_t &) const;
+
+  template<typename T>
+  void copyVariable(const std::string &, const int &, const uint32_t &, std::vector<T> &) const;
+
+  std::string filename;
+  int fd = -1; /**< file descriptor of the cache */
+  size_t mappedSize = 0; /**< size of the mapping */
+  const char *mapped = nullptr; /**< start of the read-only mapping */
+
+  std::map<std::pair<std::string, int>, Entry> entries; /**< (name, step) -> entry */
+};
+
+/**
+ * @class FieldCacheWriter
+ * @brief Writes a FieldCache file, one field at a time.
+ *
+ * Fields are streamed to a temporary file as they are added, the table is
+ * written by close() and the file is then renamed into place, so concurrent
+ * readers never see a partial cache.
+ */
+class FieldCacheWriter
+{
+public:
+  FieldCacheWriter(const std::string &);
+  ~FieldCacheWriter();
+
+  void addVariable(const std::string &, const int &, const std::vector<int> &);
+  void addVariable(const std::string &, const int &, const std::vector<float> &);
+  void addVariable(const std::string &, const int &, const std::vector<double> &);
+
+  void close();
+
+private:
+  FieldCacheWriter() = default;
+
+  void addBlock(const std::string &, const int &, const uint32_t &, const char *, const uint64_t &, const size_t &);
+
+  std::string filename;
+  std::string tmpFilename;
+  std::ofstream outfile;
+  uint64_t position = 0;
+  std::vector<FieldCache::Entry> entries;
+};
@@ -0,0 +1,71 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Winds
+ *
+ * GPL-3.0 License
+ *
+ * QES-Winds is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Winds is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Winds. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file FieldView.h */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @class FieldView
+ * @brief Read-only, non-owning view of a field stored contiguously.
+ *
+ * The view points either into a std::vector or into the mapping of a
+ * FieldCache, so the fields that are only read (e.g. by the plume) are
+ * indexed in place instead of being copied. A vector converts implicitly to
+ * a view, the view is only valid as long as the storage it points to.
+ */
+template<typename T>
+class FieldView
+{
+public:
+  FieldView() = default;
+  FieldView(const T *data, const size_t &size)
+    : m_data(data), m_size(size)
+  {}
+  FieldView(const std::vector<T> &vec)
+    : m_data(vec.data()), m_size(vec.size())
+  {}
+
+  const T &operator[](const size_t &i) const { return m_data[i]; }
+
+  const T *data() const { return m_data; }
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  const T *begin() const { return m_data; }
+  const T *end() const { return m_data + m_size; }
+
+private:
+  const T *m_data = nullptr;
+  size_t m_size = 0;
+};
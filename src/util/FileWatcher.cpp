@@ -0,0 +1,141 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Winds
+ *
+ * GPL-3.0 License
+ *
+ * QES-Winds is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Winds is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Winds. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file FileWatcher.cpp */
+
+#include "FileWatcher.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include <unistd.h>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+#include "QESout.h"
+
+FileWatcher::FileWatcher(const std::string &filename)
+{
+  size_t pos = filename.rfind('/');
+  if (pos == std::string::npos) {
+    dirname = ".";
+    basename = filename;
+  } else {
+    dirname = (pos == 0) ? "/" : filename.substr(0, pos);
+    basename = filename.substr(pos + 1);
+  }
+
+#ifdef __linux__
+  fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd >= 0) {
+    wd = inotify_add_watch(fd, dirname.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+    if (wd < 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+#endif
+  if (fd < 0) {
+    QESout::warning("File notifications not available for " + filename + ", polling the file instead");
+  }
+}
+
+FileWatcher::~FileWatcher()
+{
+  if (fd >= 0) {
+    close(fd);
+  }
+}
+
+bool FileWatcher::readEvents()
+{
+  bool found = false;
+#ifdef __linux__
+  // buffer aligned for the event structures (the names follow each event)
+  alignas(struct inotify_event) char buffer[4096];
+  ssize_t len;
+  while ((len = read(fd, buffer, sizeof(buffer))) > 0) {
+    for (char *ptr = buffer; ptr < buffer + len;) {
+      const struct inotify_event *event = reinterpret_cast<const struct inotify_event *>(ptr);
+      if (event->len > 0 && basename == event->name) {
+        found = true;
+      }
+      ptr += sizeof(struct inotify_event) + event->len;
+    }
+  }
+#endif
+  return found;
+}
+
+void FileWatcher::clear()
+{
+  if (fd >= 0) {
+    readEvents();
+  }
+}
+
+bool FileWatcher::wait(const double &timeout, const double &settle)
+{
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+
+  if (fd < 0) {
+    std::this_thread::sleep_until(deadline);
+    return false;
+  }
+
+#ifdef __linux__
+  // notifications of the other files of the directory are skipped
+  bool modified = false;
+  while (true) {
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+    if (remaining.count() <= 0) {
+      return modified;
+    }
+    // once modified, only wait for the end of the burst of writes
+    int pollTime = (int)remaining.count();
+    if (modified) {
+      pollTime = std::min(pollTime, (int)(1000.0 * settle));
+    }
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    if (poll(&pfd, 1, pollTime) > 0) {
+      if (readEvents()) {
+        modified = true;
+      }
+    } else if (modified) {
+      return true;
+    }
+  }
+#else
+  return false;
+#endif
+}
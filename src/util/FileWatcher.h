@@ -0,0 +1,86 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Winds
+ *
+ * GPL-3.0 License
+ *
+ * QES-Winds is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Winds is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Winds. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file FileWatcher.h */
+
+#pragma once
+
+#include <string>
+
+/**
+ * @class FileWatcher
+ * @brief Waits for another process to write to a file.
+ *
+ * On Linux the directory of the file is watched with inotify, so a wait
+ * returns as soon as the file is written, closed or replaced (renamed into
+ * place). The directory is watched rather than the file itself so that the
+ * watch survives writers that recreate the file. On other systems, or if
+ * inotify is not available, a wait simply sleeps for the timeout and the
+ * caller has to check the file again (polling).
+ */
+class FileWatcher
+{
+public:
+  FileWatcher(const std::string &);
+  ~FileWatcher();
+
+  /**
+   * Blocks until the watched file is modified or the timeout expires.
+   *
+   * A burst of writes is coalesced: once notified, the wait returns when the
+   * file has not been written for settle seconds (or at the timeout).
+   *
+   * @param timeout maximum waiting time in seconds
+   * @param settle quiet time after the last write, in seconds
+   * @return true if the file was modified, false on timeout (or without inotify)
+   */
+  bool wait(const double &timeout, const double &settle = 0.05);
+
+  /**
+   * Discards the pending notifications (e.g. the ones caused by our own writes).
+   */
+  void clear();
+
+  /**
+   * @return true if the notifications are available (false -> polling)
+   */
+  bool isEventDriven() const { return fd >= 0; }
+
+private:
+  FileWatcher() = default;
+
+  // reads the pending notifications, true if one of them concerns the file
+  bool readEvents();
+
+  std::string dirname; /**< directory containing the file */
+  std::string basename; /**< name of the file in the directory */
+  int fd = -1; /**< inotify instance (-1 -> polling) */
+  int wd = -1; /**< watch on the directory */
+};
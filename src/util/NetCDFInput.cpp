@@ -38,6 +38,7 @@
 
 #include <iostream>
 #include "NetCDFInput.h"
+#include "NetCDFMutex.h"
 
 using namespace netCDF;
 using namespace netCDF::exceptions;
@@ -45,23 +46,27 @@ using namespace netCDF::exceptions;
 NetCDFInput ::NetCDFInput(std::string input_file)
 {
   std::cout << "[NetCDFInput] \t Reading " << input_file << std::endl;
+  std::lock_guard<std::mutex> lock(netCDFMutex());
   infile = new NcFile(input_file, NcFile::read);
 }
 
 void NetCDFInput ::getDimension(std::string name, NcDim &external)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   external = infile->getDim(name);
 }
 
 void NetCDFInput ::getDimensionSize(std::string name, int &external)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   external = infile->getDim(name).getSize();
 }
 
 void NetCDFInput ::getVariable(std::string name, NcVar &external)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   external = infile->getVar(name);
 }
@@ -69,18 +74,21 @@ void NetCDFInput ::getVariable(std::string name, NcVar &external)
 // 1D -> int
 void NetCDFInput ::getVariableData(std::string name, std::vector<int> &external)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   infile->getVar(name).getVar(&external[0]);
 }
 // 1D -> float
 void NetCDFInput ::getVariableData(std::string name, std::vector<float> &external)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   infile->getVar(name).getVar(&external[0]);
 }
 // 1D -> double
 void NetCDFInput ::getVariableData(std::string name, std::vector<double> &external)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   infile->getVar(name).getVar(&external[0]);
 }
@@ -88,18 +96,21 @@ void NetCDFInput ::getVariableData(std::string name, std::vector<double> &extern
 // *D -> int
 void NetCDFInput ::getVariableData(std::string name, const std::vector<size_t> start, std::vector<size_t> count, std::vector<int> &external)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   infile->getVar(name).getVar(start, count, &external[0]);
 }
 // *D -> float
 void NetCDFInput ::getVariableData(std::string name, const std::vector<size_t> start, std::vector<size_t> count, std::vector<float> &external)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   infile->getVar(name).getVar(start, count, &external[0]);
 }
 // *D -> double
 void NetCDFInput ::getVariableData(std::string name, const std::vector<size_t> start, std::vector<size_t> count, std::vector<double> &external)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   infile->getVar(name).getVar(start, count, &external[0]);
 }
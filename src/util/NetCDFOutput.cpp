@@ -34,23 +34,45 @@
  */
 
 #include "NetCDFOutput.h"
+#include "NetCDFMutex.h"
+#include "QESprofile.h"
 
 #include <iostream>
 
 using namespace netCDF;
 using namespace netCDF::exceptions;
 
+// number of bytes in a hyperslab of the given size (for the profiling report)
+static double sliceBytes(const std::vector<size_t> &size, size_t elementSize)
+{
+  double n = elementSize;
+  for (auto s : size) {
+    n *= s;
+  }
+  return n;
+}
+
 // constructor, linked to NetCDF file, replace mode only
+// (no file with an empty file name: the fields are defined but never written)
 NetCDFOutput ::NetCDFOutput(const std::string &output_file)
+  : outfile(nullptr)
 {
+  if (output_file.empty()) {
+    return;
+  }
   std::cout << "[NetCDFOutput] \t Writing to " << output_file << std::endl;
+  std::lock_guard<std::mutex> lock(netCDFMutex());
   outfile = new NcFile(output_file, NcFile::replace);
 }
 
 
 NcDim NetCDFOutput ::addDimension(const std::string &name, int size)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
+  if (!outfile) {
+    return NcDim();
+  }
   if (size) {
     return outfile->addDim(name, size);
   } else {
@@ -60,7 +82,11 @@ NcDim NetCDFOutput ::addDimension(const std::string &name, int size)
 
 NcDim NetCDFOutput ::getDimension(const std::string &name)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
+  if (!outfile) {
+    return NcDim();
+  }
   return outfile->getDim(name);
 }
 
@@ -70,9 +96,13 @@ void NetCDFOutput ::addField(const std::string &name,
                              std::vector<NcDim> dims,
                              NcType type)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   NcVar var;
 
+  if (!outfile) {
+    return;
+  }
   var = outfile->addVar(name, type, dims);
   var.putAtt("units", units);
   var.putAtt("long_name", long_name);
@@ -81,7 +111,11 @@ void NetCDFOutput ::addField(const std::string &name,
 
 void NetCDFOutput ::addAtt(const std::string &name, const std::string &att_name, const std::string &att_string)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
+  if (!outfile) {
+    return;
+  }
   NcVar var = fields[name];
 
   var.putAtt(att_name, att_string);
@@ -90,99 +124,119 @@ void NetCDFOutput ::addAtt(const std::string &name, const std::string &att_name,
 // 1D -> int
 void NetCDFOutput ::saveField1D(const std::string &name, const std::vector<size_t> &index, int *data)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   // write output data
   NcVar var = fields[name];
   var.putVar(index, data);
   outfile->sync();
+  QESprofile::addCount("output/bytes", sizeof(int));
 }
 
 // 1D -> float
 void NetCDFOutput ::saveField1D(const std::string &name, const std::vector<size_t> &index, float *data)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   // write output data
   NcVar var = fields[name];
   var.putVar(index, data);
   outfile->sync();
+  QESprofile::addCount("output/bytes", sizeof(float));
 }
 
 // 1D -> double
 void NetCDFOutput ::saveField1D(const std::string &name, const std::vector<size_t> &index, double *data)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   // write output data
   NcVar var = fields[name];
   var.putVar(index, data);
   outfile->sync();
+  QESprofile::addCount("output/bytes", sizeof(double));
 }
 
 // 2D -> int
 void NetCDFOutput ::saveField2D(const std::string &name, std::vector<int> &data)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   // write output data
   NcVar var = fields[name];
   var.putVar(&data[0]);
   outfile->sync();
+  QESprofile::addCount("output/bytes", data.size() * sizeof(int));
 }
 
 // 2D -> float
 void NetCDFOutput ::saveField2D(const std::string &name, std::vector<float> &data)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   // write output data
   NcVar var = fields[name];
   var.putVar(&data[0]);
   outfile->sync();
+  QESprofile::addCount("output/bytes", data.size() * sizeof(float));
 }
 
 // 2D -> double
 void NetCDFOutput ::saveField2D(const std::string &name, std::vector<double> &data)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   // write output data
   NcVar var = fields[name];
   var.putVar(&data[0]);
   outfile->sync();
+  QESprofile::addCount("output/bytes", data.size() * sizeof(double));
 }
 
 // *D -> int
 void NetCDFOutput ::saveField2D(const std::string &name, const std::vector<size_t> &index, const std::vector<size_t> &size, std::vector<int> &data)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   // write output data
   NcVar var = fields[name];
   var.putVar(index, size, &data[0]);
   outfile->sync();
+  QESprofile::addCount("output/bytes", sliceBytes(size, sizeof(int)));
 }
 
 // *D -> float
 void NetCDFOutput ::saveField2D(const std::string &name, const std::vector<size_t> &index, const std::vector<size_t> &size, std::vector<float> &data)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   // write output data
   NcVar var = fields[name];
   var.putVar(index, size, &data[0]);
   outfile->sync();
+  QESprofile::addCount("output/bytes", sliceBytes(size, sizeof(float)));
 }
 
 // *D -> double
 void NetCDFOutput ::saveField2D(const std::string &name, const std::vector<size_t> &index, const std::vector<size_t> &size, std::vector<double> &data)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   // write output data
   NcVar var = fields[name];
   var.putVar(index, size, &data[0]);
   outfile->sync();
+  QESprofile::addCount("output/bytes", sliceBytes(size, sizeof(double)));
 }
 
 // *D -> char
 void NetCDFOutput ::saveField2D(const std::string &name, const std::vector<size_t> &index, const std::vector<size_t> &size, std::vector<char> &data)
 {
+  std::lock_guard<std::mutex> lock(netCDFMutex());
 
   // write output data
   NcVar var = fields[name];
   var.putVar(index, size, &data[0]);
   outfile->sync();
+  QESprofile::addCount("output/bytes", sliceBytes(size, sizeof(char)));
 }
@@ -53,7 +53,7 @@ protected:
   std::map<std::string, NcVar> fields; /**< :document this: */
 
 public:
-  // initializer
+  // initializer (no file is created if the file name is empty)
   explicit NetCDFOutput(const std::string &);
   virtual ~NetCDFOutput() = default;
 
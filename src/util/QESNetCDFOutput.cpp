@@ -39,6 +39,7 @@
  */
 
 #include "QESNetCDFOutput.h"
+#include "QESprofile.h"
 
 QESNetCDFOutput::QESNetCDFOutput(const std::string &output_file)
   : NetCDFOutput(output_file)
@@ -181,6 +182,7 @@ void QESNetCDFOutput::addOutputFields()
 
     FMargairaz
   */
+  QESprofile::Scope profile("output");
 
   // create list of fields to save base on output_fields
   for (size_t i = 0; i < output_fields.size(); i++) {
@@ -376,6 +378,11 @@ void QESNetCDFOutput::saveOutputFields()
 
   // std::cout << fields["t"].getDim(0).getSize() << std::endl;
 
+  // output without file (see NetCDFOutput)
+  if (!outfile) {
+    return;
+  }
+
   if (output_counter == 0 && !flagStartTimeSet) {
     setStartTime(timeCurrent);
     time = 0.0;
@@ -518,6 +525,16 @@ void QESNetCDFOutput::saveOutputFields()
         vector_size.push_back(static_cast<unsigned long>(dim));
       }
     }
+    // if var not time dep -> use direct dimensions
+    else if (output_counter == 0) {
+      for (unsigned int d = 0; d < output_vector_char[i].dimensions.size(); d++) {
+        int dim = output_vector_char[i].dimensions[d].getSize();
+        vector_index.push_back(0);
+        vector_size.push_back(static_cast<unsigned long>(dim));
+      }
+    } else {
+      continue;
+    }
 
     saveField2D(output_vector_char[i].name, vector_index, vector_size, *output_vector_char[i].data);
   }
@@ -0,0 +1,283 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Winds
+ *
+ * GPL-3.0 License
+ *
+ * QES-Winds is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Winds is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Winds. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+/** @file QESprofile.cpp */
+
+#include "QESprofile.h"
+#include "QESout.h"
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+
+namespace QESprofile {
+namespace {
+  struct TimerStat
+  {
+    long calls = 0;
+    double seconds = 0.0;
+  };
+
+  struct StepStats
+  {
+    std::map<std::string, TimerStat> timers;
+    std::map<std::string, double> counters;
+    std::map<std::string, double> values;
+  };
+
+  bool enabled_flag = false;
+  int current_step = -1;
+  std::map<int, StepStats> steps;
+  std::mutex stats_mutex;
+
+  // path of the open scopes of each thread
+  thread_local std::string scope_path;
+
+  // JSON string (the names are plain identifiers, only quotes need care)
+  std::string quote(const std::string &str)
+  {
+    std::string out = "\"";
+    for (auto c : str) {
+      if (c == '"' || c == '\\') {
+        out += '\\';
+      }
+      out += c;
+    }
+    return out + "\"";
+  }
+
+  void writeJSON(std::ofstream &out)
+  {
+    StepStats totals;
+    for (const auto &step : steps) {
+      for (const auto &timer : step.second.timers) {
+        totals.timers[timer.first].calls += timer.second.calls;
+        totals.timers[timer.first].seconds += timer.second.seconds;
+      }
+      for (const auto &counter : step.second.counters) {
+        totals.counters[counter.first] += counter.second;
+      }
+    }
+
+    auto writeStats = [&out](const StepStats &stats, const std::string &indent) {
+      out << indent << "\"timers\": {";
+      std::string sep = "\n";
+      for (const auto &timer : stats.timers) {
+        out << sep << indent << "  " << quote(timer.first) << ": { \"calls\": " << timer.second.calls
+            << ", \"seconds\": " << timer.second.seconds << " }";
+        sep = ",\n";
+      }
+      out << "\n"
+          << indent << "},\n";
+      out << indent << "\"counters\": {";
+      sep = "\n";
+      for (const auto &counter : stats.counters) {
+        out << sep << indent << "  " << quote(counter.first) << ": " << counter.second;
+        sep = ",\n";
+      }
+      for (const auto &value : stats.values) {
+        out << sep << indent << "  " << quote(value.first) << ": " << value.second;
+        sep = ",\n";
+      }
+      out << "\n"
+          << indent << "}";
+    };
+
+    out.precision(9);
+    out << "{\n";
+    out << "  \"total\": {\n";
+    writeStats(totals, "    ");
+    out << "\n  },\n";
+    out << "  \"steps\": [";
+    std::string sep = "\n";
+    for (const auto &step : steps) {
+      out << sep << "    {\n      \"step\": " << step.first << ",\n";
+      writeStats(step.second, "      ");
+      out << "\n    }";
+      sep = ",\n";
+    }
+    out << "\n  ]\n}\n";
+  }
+
+  void writeCSV(std::ofstream &out)
+  {
+    out.precision(9);
+    out << "step,type,name,calls,value\n";
+    for (const auto &step : steps) {
+      for (const auto &timer : step.second.timers) {
+        out << step.first << ",timer," << timer.first << "," << timer.second.calls << "," << timer.second.seconds << "\n";
+      }
+      for (const auto &counter : step.second.counters) {
+        out << step.first << ",counter," << counter.first << ",," << counter.second << "\n";
+      }
+      for (const auto &value : step.second.values) {
+        out << step.first << ",value," << value.first << ",," << value.second << "\n";
+      }
+    }
+  }
+}// namespace
+
+void enable()
+{
+  enabled_flag = true;
+}
+
+bool enabled()
+{
+  return enabled_flag;
+}
+
+void beginStep(int step)
+{
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  current_step = step;
+}
+
+void addTime(const std::string &name, double seconds)
+{
+  if (!enabled_flag) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  TimerStat &stat = steps[current_step].timers[name];
+  stat.calls += 1;
+  stat.seconds += seconds;
+}
+
+void addCount(const std::string &name, double value)
+{
+  if (!enabled_flag) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  steps[current_step].counters[name] += value;
+}
+
+void setValue(const std::string &name, double value)
+{
+  if (!enabled_flag) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  steps[current_step].values[name] = value;
+}
+
+double totalCount(const std::string &name)
+{
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  double total = 0.0;
+  for (const auto &step : steps) {
+    auto it = step.second.counters.find(name);
+    if (it != step.second.counters.end()) {
+      total += it->second;
+    }
+  }
+  return total;
+}
+
+double totalTime(const std::string &name)
+{
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  double total = 0.0;
+  for (const auto &step : steps) {
+    auto it = step.second.timers.find(name);
+    if (it != step.second.timers.end()) {
+      total += it->second.seconds;
+    }
+  }
+  return total;
+}
+
+void reset()
+{
+  std::lock_guard<std::mutex> lock(stats_mutex);
+  steps.clear();
+}
+
+void writeReport(const std::string &fileName)
+{
+  if (!enabled_flag) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(stats_mutex);
+
+  std::ofstream out(fileName);
+  if (!out.is_open()) {
+    QESout::warning("cannot write the profiling report " + fileName);
+    return;
+  }
+  if (fileName.size() >= 4 && fileName.compare(fileName.size() - 4, 4, ".csv") == 0) {
+    writeCSV(out);
+  } else {
+    writeJSON(out);
+  }
+  std::cout << "[QES-Profile] \t Profiling report written to " << fileName << std::endl;
+}
+
+const std::string &currentPath()
+{
+  return scope_path;
+}
+
+Scope::Scope(const char *name)
+  : m_active(enabled_flag), m_parentLength(0)
+{
+  if (!m_active) {
+    return;
+  }
+  m_parentLength = scope_path.size();
+  if (!scope_path.empty()) {
+    scope_path += "/";
+  }
+  scope_path += name;
+  m_start = std::chrono::high_resolution_clock::now();
+}
+
+Scope::~Scope()
+{
+  stop();
+}
+
+void Scope::stop()
+{
+  if (!m_active) {
+    return;
+  }
+  addTime(scope_path, elapsed());
+  scope_path.resize(m_parentLength);
+  m_active = false;
+}
+
+double Scope::elapsed() const
+{
+  std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - m_start;
+  return elapsed.count();
+}
+};// namespace QESprofile
@@ -0,0 +1,117 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Winds
+ *
+ * GPL-3.0 License
+ *
+ * QES-Winds is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Winds is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Winds. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+/** @file QESprofile.h */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+
+/**
+ * Lightweight instrumentation shared by QES-Winds, QES-Turb and QES-Plume.
+ *
+ * Nested scoped timers and counters are aggregated per timestep (step -1
+ * holds the setup before the first timestep) and written as a JSON or CSV
+ * report at the end of the run. Everything is a no-op until enable() is
+ * called, so the instrumentation can stay in production builds.
+ */
+namespace QESprofile {
+  void enable();
+  bool enabled();
+
+  /**
+   * Starts aggregating the timers and counters of a new timestep.
+   */
+  void beginStep(int);
+
+  /**
+   * Adds an elapsed time (s) to a timer (path of nested names, "a/b/c").
+   */
+  void addTime(const std::string &, double);
+  /**
+   * Adds to a counter (summed over the timestep).
+   */
+  void addCount(const std::string &, double);
+  /**
+   * Sets a value (the last value of the timestep is kept), e.g. a rate.
+   */
+  void setValue(const std::string &, double);
+
+  /**
+   * Sum over all the timesteps of a counter (0 if never recorded).
+   */
+  double totalCount(const std::string &);
+  /**
+   * Sum over all the timesteps of a timer (s) (0 if never recorded).
+   */
+  double totalTime(const std::string &);
+  /**
+   * Drops everything recorded so far.
+   */
+  void reset();
+
+  /**
+   * Writes the report, as CSV if the file name ends with .csv and as JSON
+   * otherwise.
+   */
+  void writeReport(const std::string &);
+
+  /**
+   * Name of the innermost open scope of the calling thread ("" if none).
+   */
+  const std::string &currentPath();
+
+  /**
+   * Scoped timer: the time between construction and destruction is added to
+   * the timer named after the enclosing scopes of the same thread.
+   */
+  class Scope
+  {
+  public:
+    explicit Scope(const char *);
+    ~Scope();
+
+    /**
+     * Closes the scope before the end of the block (the destructor then
+     * does nothing). Scopes must be closed in reverse order of opening.
+     */
+    void stop();
+
+    /**
+     * Elapsed time (s) since the scope was opened.
+     */
+    double elapsed() const;
+
+  private:
+    bool m_active;
+    size_t m_parentLength;
+    std::chrono::time_point<std::chrono::high_resolution_clock> m_start;
+  };
+};// namespace QESprofile
@@ -153,6 +153,15 @@ public:
   {
   }
 
+  /**
+   * Horizontal distance (m) beyond the footprint over which the canopy wake
+   * modifies the fields (used to schedule the canopy elements in parallel).
+   */
+  virtual float wakeReach() const
+  {
+    return 0.0;
+  }
+
   virtual void streetCanyon(WINDSGeneralData *WGD)
   {
   }
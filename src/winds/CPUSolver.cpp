@@ -32,6 +32,8 @@
 
 #include "CPUSolver.h"
 
+#include "util/QESprofile.h"
+
 using std::cerr;
 using std::endl;
 using std::vector;
@@ -46,6 +48,7 @@ using std::cout;
  */
 void CPUSolver::solve(const WINDSInputData *WID, WINDSGeneralData *WGD, bool solveWind)
 {
+  QESprofile::Scope profile("solver");
   auto startOfSolveMethod = std::chrono::high_resolution_clock::now();// Start recording execution time
 
   /***************************************************************
@@ -138,6 +141,7 @@ void CPUSolver::solve(const WINDSInputData *WID, WINDSGeneralData *WGD, bool sol
           }
         }
       }
+      adaptOmega(iter, max_error);
       iter += 1;
     }
 
@@ -147,6 +151,7 @@ void CPUSolver::solve(const WINDSInputData *WID, WINDSGeneralData *WGD, bool sol
     // std::cout << "Error:" << max_error << "\n";
     // std::cout << "tol:" << tol << "\n";
     printf("[Solver]\t Residual after %d itertations: %2.9f\n", iter, max_error);
+    printf("[Solver]\t Over-relaxation factor: %1.4f\n", omega);
 
     /***************************************************************
      *** Update the velocity field using Euler-Lagrange equations **
@@ -212,6 +217,7 @@ void CPUSolver::solve(const WINDSInputData *WID, WINDSGeneralData *WGD, bool sol
     auto finish = std::chrono::high_resolution_clock::now();// Finish recording execution time
     std::chrono::duration<float> elapsedTotal = finish - startOfSolveMethod;
     std::chrono::duration<float> elapsedSolve = finish - startSolveSection;
+    recordSolveStats(WGD, iter, elapsedSolve.count());
     std::cout << "\t\t Elapsed time: " << elapsedTotal.count() << " s\n";// Print out elapsed execution time
     // std::cout << "Elapsed solve time: " << elapsedSolve.count() << " s\n";// Print out elapsed execution time
   }
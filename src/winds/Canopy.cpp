@@ -38,6 +38,8 @@
 
 #include "Canopy.h"
 
+#include <algorithm>
+
 #include "WINDSInputData.h"
 #include "WINDSGeneralData.h"
 
@@ -155,6 +157,10 @@ void Canopy::setCanopyElements(const WINDSInputData *WID, WINDSGeneralData *WGD)
   mergeSort(effective_height, allCanopiesV, canopy_id);
   std::cout << "[done]" << std::endl;
 
+  // the elements are applied in parallel by batches of non-overlapping elements
+  vegetationBatches = conflictFreeBatches(WGD, false);
+  wakeBatches = conflictFreeBatches(WGD, true);
+
   auto canopysetup_finish = std::chrono::high_resolution_clock::now();// Finish recording execution time
 
   std::chrono::duration<float> elapsed_cut = canopysetup_finish - canopysetup_start;
@@ -163,15 +169,52 @@ void Canopy::setCanopyElements(const WINDSInputData *WID, WINDSGeneralData *WGD)
   return;
 }
 
+std::vector<std::vector<size_t>> Canopy::conflictFreeBatches(WINDSGeneralData *WGD, bool wake)
+{
+  // padded footprint of each element (in cells), the canopy grid has one extra cell
+  // on each side and the parameterizations also modify the next face
+  std::vector<int> i0(canopy_id.size()), i1(canopy_id.size()), j0(canopy_id.size()), j1(canopy_id.size());
+  for (size_t n = 0; n < canopy_id.size(); ++n) {
+    Building *element = allCanopiesV[canopy_id[n]];
+    int pad = 2;
+    if (wake) {
+      pad += ceil(element->wakeReach() / std::min(WGD->dx, WGD->dy));
+    }
+    i0[n] = element->i_start - pad;
+    i1[n] = element->i_end + pad;
+    j0[n] = element->j_start - pad;
+    j1[n] = element->j_end + pad;
+  }
+
+  // an element goes in the batch after the last batch holding an element it overlaps
+  std::vector<size_t> level(canopy_id.size(), 0);
+  std::vector<std::vector<size_t>> batches;
+  for (size_t n = 0; n < canopy_id.size(); ++n) {
+    for (size_t m = 0; m < n; ++m) {
+      if (i0[m] <= i1[n] && i0[n] <= i1[m] && j0[m] <= j1[n] && j0[n] <= j1[m]) {
+        level[n] = std::max(level[n], level[m] + 1);
+      }
+    }
+    if (level[n] >= batches.size()) {
+      batches.resize(level[n] + 1);
+    }
+    batches[level[n]].push_back(n);
+  }
+
+  return batches;
+}
+
 void Canopy::applyCanopyVegetation(WINDSGeneralData *WGD)
 {
   // Call regression to define ustar and surface roughness of the canopy
   canopyRegression(WGD);
 
-  for (size_t i = 0; i < allCanopiesV.size(); ++i) {
-    // for now this does the canopy stuff for us
-    //allBuildingsV[building_id[i]]->canopyVegetation(this, building_id[i]);
-    allCanopiesV[canopy_id[i]]->canopyVegetation(WGD, canopy_id[i]);
+  for (auto const &batch : vegetationBatches) {
+#pragma omp parallel for schedule(dynamic) default(none) shared(WGD, batch)
+    for (size_t n = 0; n < batch.size(); ++n) {
+      // for now this does the canopy stuff for us
+      allCanopiesV[canopy_id[batch[n]]]->canopyVegetation(WGD, canopy_id[batch[n]]);
+    }
   }
 
   return;
@@ -181,17 +224,20 @@ void Canopy::applyCanopyWake(WINDSGeneralData *WGD)
 {
 
   if (wakeFlag == 1) {
-    for (size_t i = 0; i < allCanopiesV.size(); ++i) {
-      // for now this does the canopy stuff for us
-      //allBuildingsV[building_id[i]]->canopyVegetation(this, building_id[i]);
-      allCanopiesV[canopy_id[i]]->canopyWake(WGD, canopy_id[i]);
+    for (auto const &batch : wakeBatches) {
+#pragma omp parallel for schedule(dynamic) default(none) shared(WGD, batch)
+      for (size_t n = 0; n < batch.size(); ++n) {
+        allCanopiesV[canopy_id[batch[n]]]->canopyWake(WGD, canopy_id[batch[n]]);
+      }
     }
 
+#pragma omp parallel for default(none) shared(WGD)
     for (size_t id = 0u; id < wake_u_defect.size(); ++id) {
       WGD->u0[id] *= (1. - wake_u_defect[id]);
       wake_u_defect[id] = 0.0;
     }
 
+#pragma omp parallel for default(none) shared(WGD)
     for (size_t id = 0u; id < wake_v_defect.size(); ++id) {
       WGD->v0[id] *= (1. - wake_v_defect[id]);
       wake_v_defect[id] = 0.0;
@@ -205,10 +251,11 @@ void Canopy::applyCanopyTurbulenceWake(WINDSGeneralData *WGD, TURBGeneralData *T
 {
 
   if (wakeFlag == 1) {
-    for (size_t i = 0; i < allCanopiesV.size(); ++i) {
-      // for now this does the canopy stuff for us
-      //allBuildingsV[building_id[i]]->canopyVegetation(this, building_id[i]);
-      allCanopiesV[canopy_id[i]]->canopyTurbulenceWake(WGD, TGD, canopy_id[i]);
+    for (auto const &batch : wakeBatches) {
+#pragma omp parallel for schedule(dynamic) default(none) shared(WGD, TGD, batch)
+      for (size_t n = 0; n < batch.size(); ++n) {
+        allCanopiesV[canopy_id[batch[n]]]->canopyTurbulenceWake(WGD, TGD, canopy_id[batch[n]]);
+      }
     }
   }
 
@@ -219,10 +266,11 @@ void Canopy::applyCanopyStress(WINDSGeneralData *WGD, TURBGeneralData *TGD)
 {
 
   if (wakeFlag == 1) {
-    for (size_t i = 0; i < allCanopiesV.size(); ++i) {
-      // for now this does the canopy stuff for us
-      //allBuildingsV[building_id[i]]->canopyVegetation(this, building_id[i]);
-      allCanopiesV[canopy_id[i]]->canopyStress(WGD, TGD, canopy_id[i]);
+    for (auto const &batch : wakeBatches) {
+#pragma omp parallel for schedule(dynamic) default(none) shared(WGD, TGD, batch)
+      for (size_t n = 0; n < batch.size(); ++n) {
+        allCanopiesV[canopy_id[batch[n]]]->canopyStress(WGD, TGD, canopy_id[batch[n]]);
+      }
     }
   }
 
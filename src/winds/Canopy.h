@@ -157,6 +157,20 @@ protected:
   float canopyBisection(float ustar, float z0, float canopy_top, float canopy_atten, float vk, float psi_m);
 
 private:
+  /**
+   * Groups the canopy elements (in the order of canopy_id) into batches that can be
+   * applied concurrently: the padded footprints (extended by the wake reach if wake is
+   * true) of the elements of a batch do not overlap, and two overlapping elements keep
+   * their order (the later one is placed in a later batch).
+   *
+   * @param WGD WINDS general data (grid spacing)
+   * @param wake true to include the wake reach of the elements
+   */
+  std::vector<std::vector<size_t>> conflictFreeBatches(WINDSGeneralData *WGD, bool wake);
+
+  std::vector<std::vector<size_t>> vegetationBatches; /**< Batches of elements for the vegetation pass */
+  std::vector<std::vector<size_t>> wakeBatches; /**< Batches of elements for the wake passes */
+
   void mergeSort(std::vector<float> &effective_height, std::vector<Building *> allBuildingsV, std::vector<int> &tree_id);
 };
 
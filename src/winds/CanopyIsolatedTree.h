@@ -79,6 +79,8 @@ public:
   void setCellFlags(const WINDSInputData *WID, WINDSGeneralData *WGD, int building_number);
   void canopyVegetation(WINDSGeneralData *wgd, int building_id);
   void canopyWake(WINDSGeneralData *wgd, int building_id);
+  // wake length (wake_stream_coef * H) plus the half-span of the wake (see canopyWake)
+  float wakeReach() const { return 13.0 * H; }
 
   int getCellFlagCanopy();
   int getCellFlagWake();
@@ -58,6 +58,8 @@ public:
   void canopyWake(WINDSGeneralData *wgd, int building_id);
   void canopyTurbulenceWake(WINDSGeneralData *, TURBGeneralData *, int);
   void canopyStress(WINDSGeneralData *, TURBGeneralData *, int);
+  // length of the wake lines (7.5 * H, see canopyWake)
+  float wakeReach() const { return 7.5 * H; }
   int getCellFlagCanopy();
   int getCellFlagWake();
   float P2L(float[2], float[2], float[2]);
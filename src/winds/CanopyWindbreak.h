@@ -80,6 +80,8 @@ public:
 
   void canopyVegetation(WINDSGeneralData *wgd, int building_id);
   void canopyWake(WINDSGeneralData *wgd, int building_id);
+  // wake length (wake_stream_coef * H, see canopyWake)
+  float wakeReach() const { return 11.5 * H; }
 
   int getCellFlagCanopy();
   int getCellFlagWake();
@@ -1344,19 +1344,21 @@ void CutBuilding::setCutCellFlags(WINDSGeneralData *WGD, const PolyBuilding *Pol
       // Calculate distance of the cell center from the cut surface
       distance = sqrt(pow(distance_x, 2.0) + pow(distance_y, 2.0) + pow(distance_z, 2.0));
 
+      CutCellGeometry::Cell &cutGeometry = WGD->cutCellGeometry[cut_cell_id[id]];
+
       // If the cell center is not in solid
       if (WGD->center_id[cut_cell_id[id]] == 1) {
-	WGD->wall_distance[cut_cell_id[id]] = distance;
+	cutGeometry.wall_distance = distance;
       } else {// If the cell center is inside solid
-	WGD->wall_distance[cut_cell_id[id]] = -distance;
+	cutGeometry.wall_distance = -distance;
       }
 
       // Set the building volume fraction of the cell by subtracting the solid volume fraction of the cell
       WGD->building_volume_frac[cut_cell_id[id]] -= solid_V_frac;
 
-      WGD->ni[cut_cell_id[id]] = cut_points[id].ni;
-      WGD->nj[cut_cell_id[id]] = cut_points[id].nj;
-      WGD->nk[cut_cell_id[id]] = cut_points[id].nk;
+      cutGeometry.ni = cut_points[id].ni;
+      cutGeometry.nj = cut_points[id].nj;
+      cutGeometry.nk = cut_points[id].nk;
 
       if (WGD->building_volume_frac[cut_cell_id[id]] < 0.0) {
 	WGD->building_volume_frac[cut_cell_id[id]] = 0.0;
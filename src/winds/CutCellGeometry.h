@@ -0,0 +1,117 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Winds
+ *
+ * GPL-3.0 License
+ *
+ * QES-Winds is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Winds is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Winds. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file CutCellGeometry.h */
+
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+/**
+ * @class CutCellGeometry
+ * @brief Sparse storage of the cut-surface geometry of the cells.
+ *
+ * Normals, tangents and wall distances are only meaningful for the cut
+ * cells and the wall cells, which are a few percent of the domain. They
+ * are kept in a compact array indexed by a hash map on the cell-centered
+ * id instead of one full-domain array per component.
+ */
+class CutCellGeometry
+{
+public:
+  /**
+   * Geometry of one cell, zero for the cells that are not stored.
+   */
+  struct Cell
+  {
+    float ni = 0.0, nj = 0.0, nk = 0.0; /**< normal components of the cut surface */
+    float ti = 0.0, tj = 0.0, tk = 0.0; /**< tangential components of the cut surface */
+    float wall_distance = 0.0; /**< distance of the cell center from the cut face */
+  };
+
+  /**
+   * Access to the geometry of a cell, added (zeroed) if not stored yet.
+   *
+   * Not thread-safe when the cell is new.
+   *
+   * @param id cell-centered id of the cell
+   */
+  Cell &operator[](int id)
+  {
+    auto it = m_index.find(id);
+    if (it != m_index.end()) {
+      return m_cells[it->second];
+    }
+    m_index[id] = m_cells.size();
+    m_ids.push_back(id);
+    m_cells.emplace_back();
+    return m_cells.back();
+  }
+
+  /**
+   * Read-only access to the geometry of a cell (zero if not stored).
+   *
+   * @param id cell-centered id of the cell
+   */
+  const Cell &at(int id) const
+  {
+    static const Cell empty;
+    auto it = m_index.find(id);
+    return (it != m_index.end()) ? m_cells[it->second] : empty;
+  }
+
+  bool contains(int id) const { return m_index.count(id) > 0; }
+  size_t size() const { return m_cells.size(); }
+
+  /** cell-centered ids of the stored cells, in storage order */
+  const std::vector<int> &ids() const { return m_ids; }
+  /** geometry of the stored cells, in storage order */
+  const std::vector<Cell> &cells() const { return m_cells; }
+
+  void clear()
+  {
+    m_index.clear();
+    m_ids.clear();
+    m_cells.clear();
+  }
+
+  void reserve(size_t count)
+  {
+    m_index.reserve(count);
+    m_ids.reserve(count);
+    m_cells.reserve(count);
+  }
+
+private:
+  std::unordered_map<int, int> m_index; /**< cell-centered id -> position in m_cells */
+  std::vector<int> m_ids;
+  std::vector<Cell> m_cells;
+};
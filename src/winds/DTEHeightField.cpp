@@ -42,6 +42,12 @@
 #include "WINDSInputData.h"
 #include "WINDSGeneralData.h"
 
+#include <functional>
+#include <sstream>
+#include <unistd.h>
+
+#include "util/FieldCache.h"
+
 #define PBSTR "||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||"
 #define PBWIDTH 60
 #define LIMIT 99999999.0f
@@ -628,6 +634,14 @@ void DTEHeightField::setCells(WINDSGeneralData *WGD, const WINDSInputData *WID)
 
   printf("[DTEHeightField] Setting Cell Data...\n");
 
+  // same DEM, domain and grid as a previous run -> reuse the cut-cells
+  std::string cacheFile = cutCellCacheFile(WGD, WID);
+  if (!cacheFile.empty() && FieldCache::exists(cacheFile, m_filename)) {
+    std::cout << "[DTEHeightField] Using cut-cells cached in " << cacheFile << std::endl;
+    loadCutCells(cacheFile, WGD);
+    return;
+  }
+
   std::vector<int> cutCells;
 
   int ii = WID->simParams->halo_x / WGD->dx;
@@ -635,6 +649,8 @@ void DTEHeightField::setCells(WINDSGeneralData *WGD, const WINDSInputData *WID)
   int i_domain_end = ii + (m_nXSize * pixelSizeX) / WGD->dx;
   int j_domain_end = jj + (m_nYSize * pixelSizeY) / WGD->dy;
 
+  // the columns are independent (each one only writes its own cells)
+#pragma omp parallel for schedule(dynamic) default(none) shared(WGD, cutCells, ii, jj, i_domain_end, j_domain_end)
   for (int i = 0; i < WGD->nx - 2; i++)
     for (int j = 0; j < WGD->ny - 2; j++) {
 
@@ -671,9 +687,104 @@ void DTEHeightField::setCells(WINDSGeneralData *WGD, const WINDSInputData *WID)
 
       setCellPoints(i, j, WGD->nx, WGD->ny, WGD->nz, WGD->dz_array, WGD->z_face, corners, cutCells, WGD);
     }
+
+  if (!cacheFile.empty()) {
+    saveCutCells(cacheFile, WGD);
+  }
+}
+
+std::string DTEHeightField::cutCellCacheFile(const WINDSGeneralData *WGD, const WINDSInputData *WID) const
+{
+  // no DEM file (e.g. terrain from WRF) -> nothing to key the cache on
+  if (m_filename.empty()) {
+    return "";
+  }
+
+  // everything the cut-cells depend on: DEM, domain and grid
+  std::ostringstream key;
+  key.precision(9);
+  key << m_filename << " " << m_nXSize << " " << m_nYSize << " " << pixelSizeX << " " << pixelSizeY
+      << " " << adfMinMax[0] << " " << min[2] << " " << max[2]
+      << " " << originFlag << " " << DEMDistancex << " " << DEMDistancey
+      << " " << WID->simParams->halo_x << " " << WID->simParams->halo_y
+      << " " << WGD->nx << " " << WGD->ny << " " << WGD->nz << " " << WGD->dx << " " << WGD->dy;
+  for (auto dz : WGD->dz_array) {
+    key << " " << dz;
+  }
+  // layout of the cache (2: sparse cut-cell geometry)
+  key << " layout 2";
+
+  std::ostringstream cacheFile;
+  cacheFile << m_filename << ".cutcells_" << std::hex << std::hash<std::string>()(key.str()) << ".fcache";
+  return cacheFile.str();
+}
+
+void DTEHeightField::saveCutCells(const std::string &cacheFile, const WINDSGeneralData *WGD) const
+{
+  // the cache is written next to the DEM, skip it if that is not possible
+  size_t sep = cacheFile.find_last_of('/');
+  std::string folder = (sep == std::string::npos) ? "." : cacheFile.substr(0, sep + 1);
+  if (access(folder.c_str(), W_OK) != 0) {
+    std::cout << "[DTEHeightField] Cannot write the cut-cell cache in " << folder << std::endl;
+    return;
+  }
+
+  FieldCacheWriter writer(cacheFile);
+  writer.addVariable("icellflag", 0, WGD->icellflag);
+  writer.addVariable("e", 0, WGD->e);
+  writer.addVariable("f", 0, WGD->f);
+  writer.addVariable("g", 0, WGD->g);
+  writer.addVariable("h", 0, WGD->h);
+  writer.addVariable("m", 0, WGD->m);
+  writer.addVariable("n", 0, WGD->n);
+  // sparse cut-cell geometry, one entry per stored cell
+  size_t nCut = WGD->cutCellGeometry.size();
+  std::vector<float> ni(nCut), nj(nCut), nk(nCut), wall_distance(nCut);
+  for (size_t c = 0; c < nCut; c++) {
+    ni[c] = WGD->cutCellGeometry.cells()[c].ni;
+    nj[c] = WGD->cutCellGeometry.cells()[c].nj;
+    nk[c] = WGD->cutCellGeometry.cells()[c].nk;
+    wall_distance[c] = WGD->cutCellGeometry.cells()[c].wall_distance;
+  }
+  writer.addVariable("cut_id", 0, WGD->cutCellGeometry.ids());
+  writer.addVariable("ni", 0, ni);
+  writer.addVariable("nj", 0, nj);
+  writer.addVariable("nk", 0, nk);
+  writer.addVariable("wall_distance", 0, wall_distance);
+  writer.addVariable("terrain_volume_frac", 0, WGD->terrain_volume_frac);
+  writer.close();
+}
+
+void DTEHeightField::loadCutCells(const std::string &cacheFile, WINDSGeneralData *WGD) const
+{
+  FieldCache cache(cacheFile);
+  cache.getVariableData("icellflag", 0, WGD->icellflag);
+  cache.getVariableData("e", 0, WGD->e);
+  cache.getVariableData("f", 0, WGD->f);
+  cache.getVariableData("g", 0, WGD->g);
+  cache.getVariableData("h", 0, WGD->h);
+  cache.getVariableData("m", 0, WGD->m);
+  cache.getVariableData("n", 0, WGD->n);
+  std::vector<int> cut_id;
+  std::vector<float> ni, nj, nk, wall_distance;
+  cache.getVariableData("cut_id", 0, cut_id);
+  cache.getVariableData("ni", 0, ni);
+  cache.getVariableData("nj", 0, nj);
+  cache.getVariableData("nk", 0, nk);
+  cache.getVariableData("wall_distance", 0, wall_distance);
+  WGD->cutCellGeometry.clear();
+  WGD->cutCellGeometry.reserve(cut_id.size());
+  for (size_t c = 0; c < cut_id.size(); c++) {
+    CutCellGeometry::Cell &cutGeometry = WGD->cutCellGeometry[cut_id[c]];
+    cutGeometry.ni = ni[c];
+    cutGeometry.nj = nj[c];
+    cutGeometry.nk = nk[c];
+    cutGeometry.wall_distance = wall_distance[c];
+  }
+  cache.getVariableData("terrain_volume_frac", 0, WGD->terrain_volume_frac);
 }
 
-void DTEHeightField::setCellPoints(int i, int j, int nx, int ny, int nz, std::vector<float> &dz_array, std::vector<float> z_face, Vector3 corners[], std::vector<int> &cutCells, WINDSGeneralData *WGD)
+void DTEHeightField::setCellPoints(int i, int j, int nx, int ny, int nz, std::vector<float> &dz_array, const std::vector<float> &z_face, Vector3 corners[], std::vector<int> &cutCells, WINDSGeneralData *WGD)
 {
   float coordsMin, coordsMax;
   coordsMin = coordsMax = corners[0][2];
@@ -939,18 +1050,13 @@ void DTEHeightField::setCellPoints(int i, int j, int nx, int ny, int nz, std::ve
        * also should not matter.
        */
 
-      terrainPoints.clear();
-      terrainEdges.clear();
-      for (size_t i = 0; i < pointsInCell.size(); i++)
-        terrainPoints.push_back(pointsInCell[i]);
-      for (size_t i = 0; i < edgesInCell.size(); i++)
-        terrainEdges.push_back(edgesInCell[i]);
-      location = Vector3(corners[0][0], corners[0][1], cellBot);
-      dimensions = Vector3(corners[1][0] - corners[0][0], corners[0][1] - corners[3][1], dz_array[k]);
+      // per-cell geometry (local, the columns are processed in parallel)
+      std::vector<Vector3> terrainPoints(pointsInCell);
+      std::vector<Edge<int>> terrainEdges(edgesInCell);
+      Vector3 location(corners[0][0], corners[0][1], cellBot);
+      Vector3 dimensions(corners[1][0] - corners[0][0], corners[0][1] - corners[3][1], dz_array[k]);
+      std::vector<Vector3> fluidFacePoints[6];
 
-      for (int i = 0; i < 6; i++) {
-        fluidFacePoints[i].clear();
-      }
       // set fluid points for the XZ and YZ faces
       for (int i = 0; i < 4; i++) {
         int firstC, secondC;
@@ -1008,7 +1114,6 @@ void DTEHeightField::setCellPoints(int i, int j, int nx, int ny, int nz, std::ve
           fluidFacePoints[i].clear();
       }
 
-      count += 1;
       float S_front, S_behind, S_right, S_left, S_below, S_above;
       float S_cut;
       float ni, nj, nk;
@@ -1128,19 +1233,24 @@ void DTEHeightField::setCellPoints(int i, int j, int nx, int ny, int nz, std::ve
 
       distance = sqrt(pow(distance_x, 2.0) + pow(distance_y, 2.0) + pow(distance_z, 2.0));
 
-      // If the cell center is not in solid
-      if (WGD->center_id[cutcell_index] == 1) {
-        WGD->wall_distance[cutcell_index] = distance;
-      } else {// If the cell center is inside solid
-        WGD->wall_distance[cutcell_index] = -distance;
+      // the columns are processed in parallel, the sparse storage is shared
+#pragma omp critical(cutCellGeometry)
+      {
+        CutCellGeometry::Cell &cutGeometry = WGD->cutCellGeometry[cutcell_index];
+        // If the cell center is not in solid
+        if (WGD->center_id[cutcell_index] == 1) {
+          cutGeometry.wall_distance = distance;
+        } else {// If the cell center is inside solid
+          cutGeometry.wall_distance = -distance;
+        }
+
+        cutGeometry.ni = ni;
+        cutGeometry.nj = nj;
+        cutGeometry.nk = nk;
       }
 
       WGD->terrain_volume_frac[cutcell_index] -= solid_V_frac;
 
-      WGD->ni[cutcell_index] = ni;
-      WGD->nj[cutcell_index] = nj;
-      WGD->nk[cutcell_index] = nk;
-
       if (WGD->terrain_volume_frac[cutcell_index] < 0.0) {
         WGD->terrain_volume_frac[cutcell_index] = 0.0;
       }
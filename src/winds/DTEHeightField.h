@@ -201,13 +201,6 @@ public:
   double adfMinMax[2]; /**< :document this: */
 
 private:
-  std::vector<Vector3> terrainPoints; /**< List of terrain points */
-  std::vector<Edge<int>> terrainEdges; /**< List of edges that connect the terrain points */
-  std::vector<Vector3> fluidFacePoints[6]; /**< :document this: */
-  Vector3 location; /**< XYZ location of the cell */
-  Vector3 dimensions; /**< Size of the cell in xyz directions */
-  int count = 0;
-
   /**
    * Given the height of the DEM file at each of it's corners and uses
    * them to calculate at what points cells are intersected by the quad the corners form.
@@ -225,7 +218,19 @@ private:
    * @param cutCells List of all cells which the terrain goes through
    */
   //void setCellPoints(Cell *cells, int i, int j, int nx, int ny, int nz, std::vector<float> &dz_array, std::vector<float> z_face, Vector3 corners[], std::vector<int> &cutCells, WINDSGeneralData *WGD);
-  void setCellPoints(int i, int j, int nx, int ny, int nz, std::vector<float> &dz_array, std::vector<float> z_face, Vector3 corners[], std::vector<int> &cutCells, WINDSGeneralData *WGD);
+  void setCellPoints(int i, int j, int nx, int ny, int nz, std::vector<float> &dz_array, const std::vector<float> &z_face, Vector3 corners[], std::vector<int> &cutCells, WINDSGeneralData *WGD);
+
+  /**
+   * Name of the cut-cell cache for this DEM, domain and grid (next to the
+   * DEM file), empty if the cut-cells cannot be cached.
+   */
+  std::string cutCellCacheFile(const WINDSGeneralData *WGD, const WINDSInputData *WID) const;
+
+  /**
+   * Stores/restores the cell data set by setCells in/from a field cache.
+   */
+  void saveCutCells(const std::string &cacheFile, const WINDSGeneralData *WGD) const;
+  void loadCutCells(const std::string &cacheFile, WINDSGeneralData *WGD) const;
 
   /**
    * :document this:
@@ -33,6 +33,7 @@
 #pragma once
 
 #include "util/ParseInterface.h"
+#include "VisualizationSlices.h"
 #include <string>
 #include <vector>
 
@@ -51,6 +52,7 @@ public:
   bool massConservedFlag;
   bool sensorVelocityFlag;
   bool staggerdVelocityFlag;
+  VisualizationSlices *visuSlices = nullptr; /**< Reduced outputs of the visualization file (optional) */
 
   FileOptions()
   {
@@ -67,5 +69,6 @@ public:
     parsePrimitive<bool>(false, massConservedFlag, "massConservedFlag");
     parsePrimitive<bool>(false, sensorVelocityFlag, "sensorVelocityFlag");
     parsePrimitive<bool>(false, staggerdVelocityFlag, "staggerdVelocityFlag");
+    parseElement<VisualizationSlices>(false, visuSlices, "visualizationSlices");
   }
 };
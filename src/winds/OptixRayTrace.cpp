@@ -327,7 +327,7 @@ void OptixRayTrace::convertVecMeshType(std::vector<Triangle *> &tris, std::vecto
 }
 
 
-void OptixRayTrace::calculateMixingLength(int numSamples, int dimX, int dimY, int dimZ, float dx, float dy, float dz, const std::vector<int> &icellflag, std::vector<double> &mixingLengths)
+void OptixRayTrace::calculateMixingLength(int numSamples, int dimX, int dimY, int dimZ, float dx, float dy, float dz, const std::vector<int> &icellflag, std::vector<float> &mixingLengths)
 {
 
   // Initialize variables used in called functions below
@@ -265,7 +265,7 @@ public:
    * @param icellflag Cell type
    * @param mixingLengths Array of mixinglengths for all cells that will be updated
    */
-  void calculateMixingLength(int numSamples, int dimX, int dimY, int dimZ, float dx, float dy, float dz, const std::vector<int> &icellflag, std::vector<double> &mixingLengths);
+  void calculateMixingLength(int numSamples, int dimX, int dimY, int dimZ, float dx, float dy, float dz, const std::vector<int> &icellflag, std::vector<float> &mixingLengths);
 
 private:
   OptixRayTrace();// cannot have an empty constructor (have to pass in a mesh to build)
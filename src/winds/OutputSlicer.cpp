@@ -0,0 +1,113 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Winds
+ *
+ * GPL-3.0 License
+ *
+ * QES-Winds is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Winds is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Winds. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/**
+ * @file OutputSlicer.cpp
+ * @brief Samples cell-centered fields on the reduced outputs of the visualization.
+ */
+
+#include "OutputSlicer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+OutputSlicer::OutputSlicer(const VisualizationSlices *slices, const WINDSGeneralData *WGD)
+  : nx(WGD->nx), ny(WGD->ny), nz(WGD->nz)
+{
+  const long layer = (long)(nx - 1) * (ny - 1);
+
+  // horizontal slices following the terrain: linear interpolation between the
+  // cell centers around terrain + height (first and last layers excluded)
+  for (auto height : slices->sliceHeights) {
+    for (int j = 0; j < ny - 1; j++) {
+      for (int i = 0; i < nx - 1; i++) {
+        long id2D = i + j * (nx - 1);
+        float zAbs = WGD->terrain[id2D] + height;
+
+        // last cell center below zAbs
+        int k = std::upper_bound(WGD->z.begin() + 1, WGD->z.begin() + nz - 1, zAbs) - WGD->z.begin() - 1;
+        k = std::max(1, std::min(k, nz - 3));
+        float t = (zAbs - WGD->z[k]) / (WGD->z[k + 1] - WGD->z[k]);
+        t = std::max(0.0f, std::min(t, 1.0f));
+
+        hSlice.push_back({ id2D + k * layer, id2D + (k + 1) * layer, t });
+      }
+    }
+  }
+
+  // vertical cross-sections: cells containing the position
+  for (auto xPos : slices->xSections) {
+    int i = (int)floor(xPos / WGD->dx);
+    if (i < 0 || i > nx - 2) {
+      std::cerr << "[ERROR] visualizationSlices: cross-section x = " << xPos << " outside of the domain" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    for (int k = 1; k < nz - 1; k++) {
+      for (int j = 0; j < ny - 1; j++) {
+        long id = i + j * (nx - 1) + k * layer;
+        xSection.push_back({ id, id, 0.0f });
+      }
+    }
+  }
+  for (auto yPos : slices->ySections) {
+    int j = (int)floor(yPos / WGD->dy);
+    if (j < 0 || j > ny - 2) {
+      std::cerr << "[ERROR] visualizationSlices: cross-section y = " << yPos << " outside of the domain" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+    for (int k = 1; k < nz - 1; k++) {
+      for (int i = 0; i < nx - 1; i++) {
+        long id = i + j * (nx - 1) + k * layer;
+        ySection.push_back({ id, id, 0.0f });
+      }
+    }
+  }
+
+  // decimated volume: one cell every stride cells in each direction
+  if (slices->stride > 0) {
+    const int s = slices->stride;
+    for (int i = 0; i < nx - 1; i += s) {
+      xCoarse.push_back(WGD->x[i]);
+    }
+    for (int j = 0; j < ny - 1; j += s) {
+      yCoarse.push_back(WGD->y[j]);
+    }
+    for (int k = 1; k < nz - 1; k += s) {
+      zCoarse.push_back(WGD->z[k]);
+      for (int j = 0; j < ny - 1; j += s) {
+        for (int i = 0; i < nx - 1; i += s) {
+          long id = i + j * (nx - 1) + k * layer;
+          coarse.push_back({ id, id, 0.0f });
+        }
+      }
+    }
+  }
+}
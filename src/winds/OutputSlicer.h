@@ -0,0 +1,119 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Winds
+ *
+ * GPL-3.0 License
+ *
+ * QES-Winds is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Winds is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Winds. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file OutputSlicer.h */
+
+#pragma once
+
+#include <vector>
+
+#include "WINDSGeneralData.h"
+#include "VisualizationSlices.h"
+
+/**
+ * @class OutputSlicer
+ * @brief Samples cell-centered fields on the reduced outputs of the visualization.
+ *
+ * The geometry of each reduced output (horizontal slices, cross-sections and
+ * decimated volume) is computed once as a list of samples in the cell-centered
+ * grid of WINDSGeneralData, so extracting a field at each timestep is a single
+ * parallel pass over the samples.
+ *
+ * @sa VisualizationSlices
+ */
+class OutputSlicer
+{
+public:
+  /**
+   * Sample of a reduced output: linear interpolation between two cells
+   * (cell-centered indices of WINDSGeneralData).
+   */
+  struct Sample
+  {
+    long id0, id1;
+    float t;
+  };
+
+  OutputSlicer(const VisualizationSlices *, const WINDSGeneralData *);
+  ~OutputSlicer()
+  {}
+
+  /**
+   * Extracts a field on a list of samples.
+   *
+   * The field is cell-centered, the first layer stored being kOffset (1 for
+   * the visualization fields, which skip the ghost cells below the ground).
+   * Integer fields (cell flags) take the value of the closest cell.
+   *
+   * @param samples samples of the reduced output
+   * @param field cell-centered field
+   * @param kOffset first vertical layer stored in the field
+   * @param out values at the samples
+   */
+  template<typename T>
+  void extract(const std::vector<Sample> &samples, const std::vector<T> &field, const int &kOffset, std::vector<T> &out) const
+  {
+    const long offset = (long)kOffset * (nx - 1) * (ny - 1);
+    const long nSamples = samples.size();
+    out.resize(nSamples);
+#pragma omp parallel for default(none) shared(samples, field, out, offset, nSamples)
+    for (long p = 0; p < nSamples; ++p) {
+      const Sample &s = samples[p];
+      out[p] = blend(field[s.id0 - offset], field[s.id1 - offset], s.t);
+    }
+  }
+
+  ///@{
+  /** Samples of the reduced outputs (ordered as the dimensions of the output variables) */
+  std::vector<Sample> hSlice; /**< (slice, y, x) */
+  std::vector<Sample> xSection; /**< (section, z, y) */
+  std::vector<Sample> ySection; /**< (section, z, x) */
+  std::vector<Sample> coarse; /**< (z, y, x) every stride cells */
+  ///@}
+
+  ///@{
+  /** Coordinates of the decimated volume */
+  std::vector<float> xCoarse, yCoarse, zCoarse;
+  ///@}
+
+private:
+  OutputSlicer() {}
+
+  static float blend(const float &a, const float &b, const float &t)
+  {
+    return (1.0f - t) * a + t * b;
+  }
+  static int blend(const int &a, const int &b, const float &t)
+  {
+    return (t < 0.5f) ? a : b;
+  }
+
+  int nx, ny, nz;
+};
@@ -230,7 +230,7 @@ void PolyBuilding::setCellFlags(const WINDSInputData *WID, WINDSGeneralData *WGD
     }
   }
 
-  if (mesh_type_flag == 1 && WID->simParams->readCoefficientsFlag == 0)// Cut-cell method for buildings
+  if (mesh_type_flag == 1 && WID->simParams->readCoefficientsFlag == 0 && !WGD->domainCacheHit)// Cut-cell method for buildings
   {
     cutBuilding->setCutCellFlags(WGD, this, building_number);
   }
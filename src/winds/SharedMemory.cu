@@ -40,6 +40,8 @@
 
 #include "SharedMemory.h"
 
+#include "util/QESprofile.h"
+
 using namespace std::chrono;
 using namespace std;
 using std::ofstream;
@@ -203,6 +205,7 @@ __global__ void finalVelocityShared(float *d_lambda, float *d_u, float *d_v, flo
 
 void SharedMemory::solve(const WINDSInputData *WID, WINDSGeneralData *WGD, bool solveWind)
 {
+  QESprofile::Scope profile("solver");
   itermax = WID->simParams->maxIterations;
   int numblocks = (WGD->numcell_cent / BLOCKSIZE) + 1;
   R.resize(WGD->numcell_cent, 0.0);
@@ -272,19 +275,25 @@ void SharedMemory::solve(const WINDSInputData *WID, WINDSGeneralData *WGD, bool
   cudaMemcpy(d_error, max_error.data(), 1 * sizeof(float), cudaMemcpyHostToDevice);
 
 
+  // over-relaxation factors of the red and black passes (Chebyshev acceleration)
+  float omegaRed = 1.0f;
+  float omegaBlack = 1.0f;
+
   // Main solver loop
   while ((iter < itermax) && (max_error[0] > tol)) {
+    omegaRed = chebyshevOmega(2 * iter, omegaBlack);
+    omegaBlack = chebyshevOmega(2 * iter + 1, omegaRed);
     // Save previous iteration values for error calculation
 
     saveLambdaShared<<<numberOfBlocks, numberOfThreadsPerBlock>>>(d_lambda, d_lambda_old, WGD->nx, WGD->ny, WGD->nz);
     cudaCheck(cudaGetLastError());
     // cudaMemcpy(d_lambda , lambda.data() , WGD->numcell_cent * sizeof(float) , cudaMemcpyHostToDevice);
     int offset = 0;// Red nodes pass
-    SOR_RB_Shared<<<numberOfBlocks, numberOfThreadsPerBlock>>>(d_lambda, WGD->nx, WGD->ny, WGD->nz, omega, A, B, d_e, d_f, d_g, d_h, d_m, d_n, d_R, offset);
+    SOR_RB_Shared<<<numberOfBlocks, numberOfThreadsPerBlock>>>(d_lambda, WGD->nx, WGD->ny, WGD->nz, omegaRed, A, B, d_e, d_f, d_g, d_h, d_m, d_n, d_R, offset);
     cudaCheck(cudaGetLastError());
 
     offset = 1;// Black nodes pass
-    SOR_RB_Shared<<<numberOfBlocks, numberOfThreadsPerBlock>>>(d_lambda, WGD->nx, WGD->ny, WGD->nz, omega, A, B, d_e, d_f, d_g, d_h, d_m, d_n, d_R, offset);
+    SOR_RB_Shared<<<numberOfBlocks, numberOfThreadsPerBlock>>>(d_lambda, WGD->nx, WGD->ny, WGD->nz, omegaBlack, A, B, d_e, d_f, d_g, d_h, d_m, d_n, d_R, offset);
     cudaCheck(cudaGetLastError());
 
     dim3 numberOfBlocks2(ceil(((WGD->nx - 1) * (WGD->ny - 1)) / (float)(BLOCKSIZE)), 1, 1);
@@ -293,10 +302,12 @@ void SharedMemory::solve(const WINDSInputData *WID, WINDSGeneralData *WGD, bool
 
     calculateErrorShared<<<numberOfBlocks, numberOfThreadsPerBlock>>>(d_lambda, d_lambda_old, WGD->nx, WGD->ny, WGD->nz, d_value, d_bvalue, d_error);
     cudaMemcpy(max_error.data(), d_error, 1 * sizeof(float), cudaMemcpyDeviceToHost);
+    adaptOmega(iter, max_error[0]);
     iter += 1;
   }
 
   printf("[Solver]\t Residual after %d itertations: %2.9f\n", iter, max_error[0]);
+  printf("[Solver]\t Over-relaxation factor: %1.4f\n", omega);
   // std::cout << "Error:" << max_error[0] << "\n";
   // std::cout << "Number of iterations:" << iter << "\n";// Print the number of iterations
 
@@ -330,5 +341,6 @@ void SharedMemory::solve(const WINDSInputData *WID, WINDSGeneralData *WGD, bool
   auto finish = std::chrono::high_resolution_clock::now();// Finish recording execution time
 
   std::chrono::duration<float> elapsed = finish - start;
+  recordSolveStats(WGD, iter, elapsed.count());
   std::cout << "\t\t Elapsed time: " << elapsed.count() << " s\n";// Print out elapsed execution time
 }
@@ -62,6 +62,7 @@ public:
   int logLawFlag = 0; /**< :Log Law flag to apply the log law (0-off (default), 1-on): */
   int maxIterations = 500; /**< :Maximum number of iterations (default = 500): */
   double tolerance = 1e-9; /**< :Convergence criteria, error threshold (default = 1e-9): */
+  float SORomega = 0.0; /**< :Over-relaxation factor of the SOR solvers (0-adapted to the domain (default)): */
   int meshTypeFlag = 0; /**< :Type of meshing scheme (0-Stair step (original QES) (default), 1-Cut-cell method: */
   float domainRotation = 0; /**< :Rotation angle of domain relative to true north: */
   int originFlag = 0; /**< :Origin flag (0- DEM coordinates (default), 1- UTM coordinates): */
@@ -77,6 +78,7 @@ public:
 
   int readCoefficientsFlag = 0; /**< :Reading solver coefficients flag (0-calculate coefficients (default), 1-read coefficients from the file): */
   std::string coeffFile; /**< :Address to coefficients file location: */
+  std::string domainCache; /**< :Folder of the preprocessed-domain cache (empty = no cache): */
 
   // DTE - digital elevation model details
   std::string demFile; /**< DEM file name */
@@ -166,6 +168,11 @@ public:
     parsePrimitive<int>(false, logLawFlag, "logLawFlag");
     parsePrimitive<int>(false, maxIterations, "maxIterations");
     parsePrimitive<double>(false, tolerance, "tolerance");
+    parsePrimitive<float>(false, SORomega, "SORomega");
+    if (SORomega != 0.0 && (SORomega <= 0.0 || SORomega >= 2.0)) {
+      std::cerr << "[ERROR] SORomega has to be in (0,2)" << std::endl;
+      exit(EXIT_FAILURE);
+    }
     parsePrimitive<int>(false, meshTypeFlag, "meshTypeFlag");
     parsePrimitive<float>(false, domainRotation, "domainRotation");
     parsePrimitive<int>(false, originFlag, "originFlag");
@@ -183,6 +190,9 @@ public:
     coeffFile = "";
     parsePrimitive<std::string>(false, coeffFile, "COEFF");
 
+    domainCache = "";
+    parsePrimitive<std::string>(false, domainCache, "domainCache");
+
     demFile = "";
     parsePrimitive<std::string>(false, demFile, "DEM");
 
@@ -219,6 +229,8 @@ public:
       wrfFile = QESfs::get_absolute_path(wrfFile);
     if (coeffFile != "")
       coeffFile = QESfs::get_absolute_path(coeffFile);
+    if (domainCache != "")
+      domainCache = QESfs::get_absolute_path(domainCache);
 
     //
     // Process the data files based on the state determined above
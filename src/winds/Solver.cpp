@@ -45,6 +45,8 @@
 
 #include "Solver.h"
 
+#include "util/QESprofile.h"
+
 using std::cerr;
 using std::endl;
 using std::vector;
@@ -69,6 +71,93 @@ void Solver::printProgress(float percentage)
   fflush(stdout);
 }
 
+void Solver::recordSolveStats(const WINDSGeneralData *WGD, int iter, double seconds, int nRHS)
+{
+  if (!QESprofile::enabled())
+    return;
+
+  double cellUpdates = (double)iter * (double)WGD->numcell_cent * nRHS;
+  QESprofile::addCount("winds/solver/iterations", iter);
+  QESprofile::addCount("winds/solver/cell_updates", cellUpdates);
+  if (seconds > 0.0)
+    QESprofile::setValue("winds/solver/cells_per_second", cellUpdates / seconds);
+  QESprofile::setValue("winds/solver/omega", omega);
+}
+
+void Solver::estimateOmega(const WINDSGeneralData *WGD)
+{
+  // weights of the neighbors in the SOR formulation (uniform coefficients)
+  float cx = 1.0f / (WGD->dx * WGD->dx);
+  float cy = 1.0f / (WGD->dy * WGD->dy);
+  float cz = 0.0f;
+  for (int k = 1; k < WGD->nz - 1; ++k) {
+    cz += 1.0f / (WGD->dz_array[k] * WGD->dz_array[k]);
+  }
+  cz /= std::max(WGD->nz - 2, 1);
+
+  // fixed lambda on the sides and the top, mirror condition at the ground
+  const float pi = 3.14159265f;
+  rhoJacobi = (cx * std::cos(pi / std::max(WGD->nx - 2, 2))
+               + cy * std::cos(pi / std::max(WGD->ny - 2, 2))
+               + cz * std::cos(pi / (2 * std::max(WGD->nz - 2, 1))))
+              / (cx + cy + cz);
+  omega = 2.0f / (1.0f + std::sqrt(1.0f - rhoJacobi * rhoJacobi));
+}
+
+void Solver::adaptOmega(int iter, float max_error)
+{
+  const int window = 10;
+  if (!adaptiveOmega || iter % window != 0) {
+    return;
+  }
+  if (iter == 0) {
+    firstError = max_error;
+  }
+  // near the round-off floor the measured factor is meaningless
+  if (max_error < 1.0e-3f * firstError) {
+    return;
+  }
+  if (iter == 0 || windowError <= 0.0f || max_error <= 0.0f) {
+    windowError = max_error;
+    windowRatio = -1.0f;
+    return;
+  }
+
+  // mean convergence factor over the window
+  float mu = std::pow(max_error / windowError, 1.0f / window);
+  windowError = max_error;
+  bool steady = (windowRatio > 0.0f && std::fabs(mu - windowRatio) < 0.01f * mu);
+  windowRatio = mu;
+
+  // mu close to omega - 1 means that omega is (at least) optimal
+  if (!steady || mu >= 1.0f || mu <= omega - 1.0f + 0.01f) {
+    return;
+  }
+
+  // Young's relation: (mu + omega - 1)^2 = mu * omega^2 * rho^2
+  float rho2 = (mu + omega - 1.0f) * (mu + omega - 1.0f) / (mu * omega * omega);
+  if (rho2 >= 1.0f || rho2 <= rhoJacobi * rhoJacobi) {
+    return;
+  }
+  rhoJacobi = std::sqrt(rho2);
+  omega = std::min(2.0f / (1.0f + std::sqrt(1.0f - rho2)), 1.99f);
+  // the factor has to be measured again with the new omega
+  windowRatio = -1.0f;
+}
+
+float Solver::chebyshevOmega(int halfStep, float previous) const
+{
+  if (!adaptiveOmega) {
+    return omega;
+  }
+  float rho2 = rhoJacobi * rhoJacobi;
+  if (halfStep == 0) {
+    return 1.0f;
+  } else if (halfStep == 1) {
+    return 1.0f / (1.0f - 0.5f * rho2);
+  }
+  return std::min(1.0f / (1.0f - 0.25f * rho2 * previous), omega);
+}
 
 /**
  * Assigns values read by WINDSInputData to variables
@@ -89,7 +178,146 @@ Solver::Solver(const WINDSInputData *WID, WINDSGeneralData *WGD)
 {
   tol = WID->simParams->tolerance;
 
+  if (WID->simParams->SORomega > 0.0f) {
+    omega = WID->simParams->SORomega;
+    adaptiveOmega = false;
+  } else {
+    estimateOmega(WGD);
+  }
+
   lambda.resize(WGD->numcell_cent, 0.0);
   lambda_old.resize(WGD->numcell_cent, 0.0);
   R.resize(WGD->numcell_cent, 0.0);
 }
+
+Solver::Solver()
+  : alpha1(1),
+    alpha2(1),
+    eta(pow((alpha1 / alpha2), 2.0)),
+    A(0.0),
+    B(0.0)
+{
+}
+
+/**
+ * Divergence of the initial velocity field (u0, v0, w0) of WGD, stored at
+ * rhs[icell_cent * stride + offset] (stride > 1 for the interleaved right-hand
+ * sides of the batched solve).
+ */
+void Solver::computeDivergence(WINDSGeneralData *WGD, std::vector<float> &rhs, int stride, int offset)
+{
+  int icell_face;// cell-face index
+  int icell_cent;// cell-centered index
+
+#pragma omp parallel private(icell_cent, icell_face) default(none) shared(WGD, rhs, stride, offset)
+  {
+#pragma omp for
+    for (int k = 1; k < WGD->nz - 2; ++k) {
+      for (int j = 0; j < WGD->ny - 1; ++j) {
+        for (int i = 0; i < WGD->nx - 1; ++i) {
+          icell_cent = i + j * (WGD->nx - 1) + k * (WGD->nx - 1) * (WGD->ny - 1);
+          icell_face = i + j * WGD->nx + k * WGD->nx * WGD->ny;
+
+          // Calculate divergence of initial velocity field
+          rhs[icell_cent * stride + offset] = (-2.0f * pow(alpha1, 2.0)) * (((WGD->e[icell_cent] * WGD->u0[icell_face + 1] - WGD->f[icell_cent] * WGD->u0[icell_face]) * WGD->dx) + ((WGD->g[icell_cent] * WGD->v0[icell_face + WGD->nx] - WGD->h[icell_cent] * WGD->v0[icell_face]) * WGD->dy) + ((WGD->m[icell_cent] * WGD->dz_array[k] * 0.5 * (WGD->dz_array[k] + WGD->dz_array[k + 1]) * WGD->w0[icell_face + WGD->nx * WGD->ny] - WGD->n[icell_cent] * WGD->dz_array[k] * 0.5f * (WGD->dz_array[k] + WGD->dz_array[k - 1]) * WGD->w0[icell_face])));
+        }
+      }
+    }
+  }
+}
+
+/**
+ * Final velocity field of WGD from its initial field (u0, v0, w0) and the
+ * Lagrange multipliers lam[icell_cent * stride + offset] (Euler-Lagrange
+ * equations), velocities set to zero inside the buildings and the terrain.
+ */
+void Solver::updateVelocity(WINDSGeneralData *WGD, const std::vector<float> &lam, int stride, int offset)
+{
+  int icell_face;// cell-face index
+  int icell_cent;// cell-centered index
+
+#pragma omp parallel private(icell_cent, icell_face) default(none) shared(WGD, lam, stride, offset)
+  {
+    // Update the velocity field using Euler-Lagrange equations
+#pragma omp for
+    for (auto k = 0u; k < WGD->u.size(); ++k) {
+      WGD->u[k] = WGD->u0[k];
+    }
+    // end of omp for (with implicit barrier)
+#pragma omp for
+    for (auto k = 0u; k < WGD->v.size(); ++k) {
+      WGD->v[k] = WGD->v0[k];
+    }
+    // end of omp for (with implicit barrier)
+#pragma omp for
+    for (auto k = 0u; k < WGD->w.size(); ++k) {
+      WGD->w[k] = WGD->w0[k];
+    }
+    // end of omp for (with implicit barrier)
+
+    // Update the velocity field using Euler equations
+#pragma omp for
+    for (int k = 1; k < WGD->nz - 2; ++k) {
+      for (int j = 1; j < WGD->ny - 1; ++j) {
+        for (int i = 1; i < WGD->nx - 1; ++i) {
+          icell_cent = i + j * (WGD->nx - 1) + k * (WGD->nx - 1) * (WGD->ny - 1);
+          icell_face = i + j * WGD->nx + k * WGD->nx * WGD->ny;
+          WGD->u[icell_face] = WGD->u0[icell_face]
+                               + (1.0f / (2.0f * (float)pow(alpha1, 2.0))) * WGD->f[icell_cent] * WGD->dx
+                                   * (lam[icell_cent * stride + offset] - lam[(icell_cent - 1) * stride + offset]);
+        }
+      }
+    }
+    // end of omp for (with implicit barrier)
+
+#pragma omp for
+    for (int k = 1; k < WGD->nz - 2; ++k) {
+      for (int j = 1; j < WGD->ny - 1; ++j) {
+        for (int i = 1; i < WGD->nx - 1; ++i) {
+          icell_cent = i + j * (WGD->nx - 1) + k * (WGD->nx - 1) * (WGD->ny - 1);
+          icell_face = i + j * WGD->nx + k * WGD->nx * WGD->ny;
+          WGD->v[icell_face] = WGD->v0[icell_face]
+                               + (1.0f / (2.0f * (float)pow(alpha1, 2.0))) * WGD->h[icell_cent] * WGD->dy
+                                   * (lam[icell_cent * stride + offset] - lam[(icell_cent - (WGD->nx - 1)) * stride + offset]);
+        }
+      }
+    }
+    // end of omp for (with implicit barrier)
+
+#pragma omp for
+    for (int k = 1; k < WGD->nz - 2; ++k) {
+      for (int j = 1; j < WGD->ny - 1; ++j) {
+        for (int i = 1; i < WGD->nx - 1; ++i) {
+          icell_cent = i + j * (WGD->nx - 1) + k * (WGD->nx - 1) * (WGD->ny - 1);
+          icell_face = i + j * WGD->nx + k * WGD->nx * WGD->ny;
+          WGD->w[icell_face] = WGD->w0[icell_face]
+                               + (1.0f / (2.0f * (float)pow(alpha2, 2.0))) * WGD->n[icell_cent] * WGD->dz_array[k]
+                                   * (lam[icell_cent * stride + offset] - lam[(icell_cent - (WGD->nx - 1) * (WGD->ny - 1)) * stride + offset]);
+        }
+      }
+    }
+    // end of omp for (with implicit barrier)
+
+#pragma omp for
+    for (int k = 1; k < WGD->nz - 1; ++k) {
+      for (int j = 0; j < WGD->ny - 1; ++j) {
+        for (int i = 0; i < WGD->nx - 1; ++i) {
+          icell_cent = i + j * (WGD->nx - 1) + k * (WGD->nx - 1) * (WGD->ny - 1);// Lineralized index for cell centered values
+          icell_face = i + j * WGD->nx + k * WGD->nx * WGD->ny;// Lineralized index for cell faced values
+
+          // If we are inside a building, set velocities to 0.0
+          if (WGD->icellflag[icell_cent] == 0 || WGD->icellflag[icell_cent] == 2) {
+            // Setting velocity field inside the building to zero
+            WGD->u[icell_face] = 0;
+            WGD->u[icell_face + 1] = 0;
+            WGD->v[icell_face] = 0;
+            WGD->v[icell_face + WGD->nx] = 0;
+            WGD->w[icell_face] = 0;
+            WGD->w[icell_face + WGD->nx * WGD->ny] = 0;
+          }
+        }
+      }
+    }
+    // end of omp for (with implicit barrier)
+  }
+}
@@ -36,7 +36,9 @@
 #include <fstream>
 #include <cstdlib>
 #include <math.h>
+#include <cmath>
 #include <vector>
+#include <algorithm>
 #include <chrono>
 #include <limits>
 
@@ -71,7 +73,12 @@ protected:
   const float B; /**< :document this: */
 
   float tol; /**< Error tolerance */
-  const float omega = 1.78f; /**< Over-relaxation factor */
+  float omega = 1.78f; /**< Over-relaxation factor */
+  bool adaptiveOmega = true; /**< Adapt omega to the estimated spectral radius (off if omega is set in the input file) */
+  float rhoJacobi = 0.0f; /**< Estimated spectral radius of the Jacobi iteration */
+  float windowError = 0.0f; /**< Error at the start of the current estimation window */
+  float windowRatio = -1.0f; /**< Convergence factor measured over the previous window */
+  float firstError = 0.0f; /**< Error of the first iteration of the solve */
 
   int itermax; /**< Maximum number of iterations */
 
@@ -80,6 +87,12 @@ protected:
   std::vector<float> lambda, lambda_old; /**< :document these as group or indiv: */
 
   Solver(const WINDSInputData *WID, WINDSGeneralData *WGD);
+  /**
+   * Solver of a process that does not hold the domain (see Solver_MPI):
+   * the parameters are set by the derived class and no field is allocated.
+   */
+  Solver();
+
   /**
    * Prints out the current amount that a process
    * has finished with a progress bar.
@@ -88,6 +101,54 @@ protected:
    */
   void printProgress(float percentage);
 
+  /**
+   * Adds the iteration count and throughput of one solve to the
+   * profiling report (no-op when profiling is disabled).
+   *
+   * @param WGD winds data, used for the number of cells
+   * @param iter number of iterations done by the solver
+   * @param seconds wall-clock time spent iterating
+   * @param nRHS number of right-hand sides solved together (batched solve)
+   */
+  void recordSolveStats(const WINDSGeneralData *WGD, int iter, double seconds, int nRHS = 1);
+
+  /**
+   * First estimate of the spectral radius of the Jacobi iteration from
+   * the grid (solids ignored) and the corresponding optimal omega.
+   *
+   * @param WGD winds data, used for the grid size and resolution
+   */
+  void estimateOmega(const WINDSGeneralData *WGD);
+
+  /**
+   * Adaptive over-relaxation (Carre's method): the convergence factor of
+   * the iterations is measured over windows of a few iterations and, once
+   * steady, gives a new estimate of the spectral radius through Young's
+   * relation. Omega is only ever increased toward its optimum.
+   *
+   * @param iter iteration number (0 at the start of the solve)
+   * @param max_error maximum change of lambda over the last iteration
+   */
+  void adaptOmega(int iter, float max_error);
+
+  /**
+   * Chebyshev acceleration of the red/black ordering: over-relaxation
+   * factor of a half-sweep, converging to the optimal omega.
+   *
+   * @param halfStep index of the half-sweep since the start of the solve
+   * @param previous factor used by the previous half-sweep
+   */
+  float chebyshevOmega(int halfStep, float previous) const;
+
+  /**
+   * Divergence of the initial velocity field, stored at rhs[icell * stride + offset].
+   */
+  void computeDivergence(WINDSGeneralData *WGD, std::vector<float> &rhs, int stride, int offset);
+
+  /**
+   * Final velocity field from the Lagrange multipliers lam[icell * stride + offset].
+   */
+  void updateVelocity(WINDSGeneralData *WGD, const std::vector<float> &lam, int stride, int offset);
 
 public:
   void resetLambda();
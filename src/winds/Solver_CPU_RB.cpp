@@ -32,6 +32,8 @@
 
 #include "Solver_CPU_RB.h"
 
+#include "util/QESprofile.h"
+
 /** :document this:
  * Start by writing a one sentence description here
  *
@@ -40,13 +42,13 @@
  */
 void Solver_CPU_RB::solve(const WINDSInputData *WID, WINDSGeneralData *WGD, bool solveWind)
 {
+  QESprofile::Scope profile("solver");
   auto startOfSolveMethod = std::chrono::high_resolution_clock::now();// Start recording execution time
 
   /***************************************************************
    *********   Divergence of the initial velocity field   ********
    ***************************************************************/
   itermax = WID->simParams->maxIterations;
-  int icell_face;// cell-face index
   int icell_cent;// cell-centered index
 
   // R.resize(WGD->numcell_cent, 0.0);
@@ -54,21 +56,7 @@ void Solver_CPU_RB::solve(const WINDSInputData *WID, WINDSGeneralData *WGD, bool
   // lambda_old.resize(WGD->numcell_cent, 0.0);
 
   auto startSolveSection = std::chrono::high_resolution_clock::now();
-#pragma omp parallel private(icell_cent, icell_face) default(none) shared(WGD, R)
-  {
-#pragma omp for
-    for (int k = 1; k < WGD->nz - 2; ++k) {
-      for (int j = 0; j < WGD->ny - 1; ++j) {
-        for (int i = 0; i < WGD->nx - 1; ++i) {
-          icell_cent = i + j * (WGD->nx - 1) + k * (WGD->nx - 1) * (WGD->ny - 1);
-          icell_face = i + j * WGD->nx + k * WGD->nx * WGD->ny;
-
-          // Calculate divergence of initial velocity field
-          R[icell_cent] = (-2.0f * pow(alpha1, 2.0)) * (((WGD->e[icell_cent] * WGD->u0[icell_face + 1] - WGD->f[icell_cent] * WGD->u0[icell_face]) * WGD->dx) + ((WGD->g[icell_cent] * WGD->v0[icell_face + WGD->nx] - WGD->h[icell_cent] * WGD->v0[icell_face]) * WGD->dy) + ((WGD->m[icell_cent] * WGD->dz_array[k] * 0.5 * (WGD->dz_array[k] + WGD->dz_array[k + 1]) * WGD->w0[icell_face + WGD->nx * WGD->ny] - WGD->n[icell_cent] * WGD->dz_array[k] * 0.5f * (WGD->dz_array[k] + WGD->dz_array[k - 1]) * WGD->w0[icell_face])));
-        }
-      }
-    }
-  }
+  computeDivergence(WGD, R, 1, 0);
   // INSERT CANOPY CODE
 
   /***************************************************************
@@ -80,12 +68,18 @@ void Solver_CPU_RB::solve(const WINDSInputData *WID, WINDSGeneralData *WGD, bool
   float max_error = 1.0;
   // int i_max, j_max, k_max;
 
+  // over-relaxation factors of the red and black passes (Chebyshev acceleration)
+  float omegaRed = 1.0f;
+  float omegaBlack = 1.0f;
+
   std::cout << "[Solver]\t Running Red/Black CPU Solver ..." << std::endl;
 
   while (iter < itermax && max_error > tol) {
+    omegaRed = chebyshevOmega(2 * iter, omegaBlack);
+    omegaBlack = chebyshevOmega(2 * iter + 1, omegaRed);
 
 // Save previous iteration values for error calculation
-#pragma omp parallel private(icell_cent, icell_face, error) default(none) shared(WGD, lambda, lambda_old, max_error, R)
+#pragma omp parallel private(icell_cent, error) default(none) shared(WGD, lambda, lambda_old, max_error, R, omegaRed, omegaBlack)
     {
 #pragma omp for
       for (auto k = 0u; k < lambda.size(); ++k) {
@@ -104,14 +98,14 @@ void Solver_CPU_RB::solve(const WINDSInputData *WID, WINDSGeneralData *WGD, bool
 
             if (((i + j + k) % 2) == 0) {
               icell_cent = i + j * (WGD->nx - 1) + k * (WGD->nx - 1) * (WGD->ny - 1);
-              lambda[icell_cent] = (omega / (WGD->e[icell_cent] + WGD->f[icell_cent] + WGD->g[icell_cent] + WGD->h[icell_cent] + WGD->m[icell_cent] + WGD->n[icell_cent]))
+              lambda[icell_cent] = (omegaRed / (WGD->e[icell_cent] + WGD->f[icell_cent] + WGD->g[icell_cent] + WGD->h[icell_cent] + WGD->m[icell_cent] + WGD->n[icell_cent]))
                                      * (WGD->e[icell_cent] * lambda[icell_cent + 1]
                                         + WGD->f[icell_cent] * lambda[icell_cent - 1]
                                         + WGD->g[icell_cent] * lambda[icell_cent + (WGD->nx - 1)]
                                         + WGD->h[icell_cent] * lambda[icell_cent - (WGD->nx - 1)]
                                         + WGD->m[icell_cent] * lambda[icell_cent + (WGD->nx - 1) * (WGD->ny - 1)]
                                         + WGD->n[icell_cent] * lambda[icell_cent - (WGD->nx - 1) * (WGD->ny - 1)] - R[icell_cent])
-                                   + (1.0f - omega) * lambda[icell_cent];// SOR formulation
+                                   + (1.0f - omegaRed) * lambda[icell_cent];// SOR formulation
             }
           }
         }
@@ -125,14 +119,14 @@ void Solver_CPU_RB::solve(const WINDSInputData *WID, WINDSGeneralData *WGD, bool
           for (int i = 1; i < WGD->nx - 2; ++i) {
             if (((i + j + k) % 2) == 1) {
               icell_cent = i + j * (WGD->nx - 1) + k * (WGD->nx - 1) * (WGD->ny - 1);
-              lambda[icell_cent] = (omega / (WGD->e[icell_cent] + WGD->f[icell_cent] + WGD->g[icell_cent] + WGD->h[icell_cent] + WGD->m[icell_cent] + WGD->n[icell_cent]))
+              lambda[icell_cent] = (omegaBlack / (WGD->e[icell_cent] + WGD->f[icell_cent] + WGD->g[icell_cent] + WGD->h[icell_cent] + WGD->m[icell_cent] + WGD->n[icell_cent]))
                                      * (WGD->e[icell_cent] * lambda[icell_cent + 1]
                                         + WGD->f[icell_cent] * lambda[icell_cent - 1]
                                         + WGD->g[icell_cent] * lambda[icell_cent + (WGD->nx - 1)]
                                         + WGD->h[icell_cent] * lambda[icell_cent - (WGD->nx - 1)]
                                         + WGD->m[icell_cent] * lambda[icell_cent + (WGD->nx - 1) * (WGD->ny - 1)]
                                         + WGD->n[icell_cent] * lambda[icell_cent - (WGD->nx - 1) * (WGD->ny - 1)] - R[icell_cent])
-                                   + (1.0f - omega) * lambda[icell_cent];// SOR formulation
+                                   + (1.0f - omegaBlack) * lambda[icell_cent];// SOR formulation
             }
           }
         }
@@ -167,6 +161,7 @@ void Solver_CPU_RB::solve(const WINDSInputData *WID, WINDSGeneralData *WGD, bool
       // end of omp for (with implicit barrier)
     }
     // end of omp parallel workshare
+    adaptOmega(iter, max_error);
     iter += 1;
   }
 
@@ -176,94 +171,127 @@ void Solver_CPU_RB::solve(const WINDSInputData *WID, WINDSGeneralData *WGD, bool
   // std::cout << "Error:" << max_error << "\n";
   // std::cout << "tol:" << tol << "\n";
   printf("[Solver]\t Residual after %d itertations: %2.9f\n", iter, max_error);
+  printf("[Solver]\t Over-relaxation factor: %1.4f\n", omega);
 
-#pragma omp parallel private(icell_cent, icell_face) default(none) shared(WGD, lambda)
-  {
-    // Update the velocity field using Euler-Lagrange equations
-#pragma omp for
-    for (auto k = 0u; k < WGD->u.size(); ++k) {
-      WGD->u[k] = WGD->u0[k];
-    }
-    // end of omp for (with implicit barrier)
-#pragma omp for
-    for (auto k = 0u; k < WGD->v.size(); ++k) {
-      WGD->v[k] = WGD->v0[k];
-    }
-    // end of omp for (with implicit barrier)
-#pragma omp for
-    for (auto k = 0u; k < WGD->w.size(); ++k) {
-      WGD->w[k] = WGD->w0[k];
-    }
-    // end of omp for (with implicit barrier)
+  updateVelocity(WGD, lambda, 1, 0);
 
-    // Update the velocity field using Euler equations
-#pragma omp for
-    for (int k = 1; k < WGD->nz - 2; ++k) {
-      for (int j = 1; j < WGD->ny - 1; ++j) {
-        for (int i = 1; i < WGD->nx - 1; ++i) {
-          icell_cent = i + j * (WGD->nx - 1) + k * (WGD->nx - 1) * (WGD->ny - 1);
-          icell_face = i + j * WGD->nx + k * WGD->nx * WGD->ny;
-          WGD->u[icell_face] = WGD->u0[icell_face]
-                               + (1.0f / (2.0f * (float)pow(alpha1, 2.0))) * WGD->f[icell_cent] * WGD->dx
-                                   * (lambda[icell_cent] - lambda[icell_cent - 1]);
-        }
-      }
-    }
-    // end of omp for (with implicit barrier)
+  auto finish = std::chrono::high_resolution_clock::now();// Finish recording execution time
+  std::chrono::duration<float> elapsedTotal = finish - startOfSolveMethod;
+  std::chrono::duration<float> elapsedSolve = finish - startSolveSection;
+  recordSolveStats(WGD, iter, elapsedSolve.count());
+  std::cout << "\t\t Elapsed time: " << elapsedTotal.count() << " s\n";// Print out elapsed execution time
+  // std::cout << "Elapsed solve time: " << elapsedSolve.count() << " s\n";// Print out elapsed execution time
+}
 
-#pragma omp for
-    for (int k = 1; k < WGD->nz - 2; ++k) {
-      for (int j = 1; j < WGD->ny - 1; ++j) {
-        for (int i = 1; i < WGD->nx - 1; ++i) {
-          icell_cent = i + j * (WGD->nx - 1) + k * (WGD->nx - 1) * (WGD->ny - 1);
-          icell_face = i + j * WGD->nx + k * WGD->nx * WGD->ny;
-          WGD->v[icell_face] = WGD->v0[icell_face]
-                               + (1.0f / (2.0f * (float)pow(alpha1, 2.0))) * WGD->h[icell_cent] * WGD->dy
-                                   * (lambda[icell_cent] - lambda[icell_cent - (WGD->nx - 1)]);
-        }
-      }
+void Solver_CPU_RB::setBatchSize(WINDSGeneralData *WGD, int K)
+{
+  batchSize = K;
+  batchR.assign(WGD->numcell_cent * K, 0.0f);
+  batchLambda.assign(WGD->numcell_cent * K, 0.0f);
+  std::cout << "[Solver]\t Batched solve of up to " << K << " timesteps" << std::endl;
+}
+
+void Solver_CPU_RB::storeBatchRHS(WINDSGeneralData *WGD, int k)
+{
+  computeDivergence(WGD, batchR, batchSize, k);
+}
+
+/**
+ * Same red/black SOR iterations as solve(), on all the right-hand sides at once:
+ * the multipliers of a cell are contiguous for the timesteps of the batch, so the
+ * inner loop over the timesteps reuses the six coefficients and the neighbours'
+ * cache lines. The iterations stop when every right-hand side has converged
+ * (the error is the maximum over the batch).
+ */
+void Solver_CPU_RB::solveBatch(const WINDSInputData *WID, WINDSGeneralData *WGD, int nRHS, int first)
+{
+  QESprofile::Scope profile("solver");
+  auto startOfSolveMethod = std::chrono::high_resolution_clock::now();// Start recording execution time
+
+  itermax = WID->simParams->maxIterations;
+  const int K = batchSize;
+  const long row = WGD->nx - 1;
+  const long layer = (WGD->nx - 1) * (WGD->ny - 1);
+
+  const int last = first + nRHS;
+
+  // only the multipliers of the solved slots are reset (the other slots may be
+  // filled or applied at the same time in the pipelined mode)
+  for (long icell_cent = 0; icell_cent < WGD->numcell_cent; ++icell_cent) {
+    for (int t = first; t < last; ++t) {
+      batchLambda[icell_cent * K + t] = 0.0f;
     }
-    // end of omp for (with implicit barrier)
+  }
 
-#pragma omp for
-    for (int k = 1; k < WGD->nz - 2; ++k) {
-      for (int j = 1; j < WGD->ny - 1; ++j) {
-        for (int i = 1; i < WGD->nx - 1; ++i) {
-          icell_cent = i + j * (WGD->nx - 1) + k * (WGD->nx - 1) * (WGD->ny - 1);
-          icell_face = i + j * WGD->nx + k * WGD->nx * WGD->ny;
-          WGD->w[icell_face] = WGD->w0[icell_face]
-                               + (1.0f / (2.0f * (float)pow(alpha2, 2.0))) * WGD->n[icell_cent] * WGD->dz_array[k]
-                                   * (lambda[icell_cent] - lambda[icell_cent - (WGD->nx - 1) * (WGD->ny - 1)]);
+  int iter = 0;
+  float max_error = 1.0;
+
+  // over-relaxation factors of the red and black passes (Chebyshev acceleration)
+  float omegaRed = 1.0f;
+  float omegaBlack = 1.0f;
+
+  std::cout << "[Solver]\t Running Red/Black CPU Solver on " << nRHS << " timesteps ..." << std::endl;
+
+  while (iter < itermax && max_error > tol) {
+    omegaRed = chebyshevOmega(2 * iter, omegaBlack);
+    omegaBlack = chebyshevOmega(2 * iter + 1, omegaRed);
+
+    max_error = 0.0;// Reset error value before error calculation
+#pragma omp parallel default(none) shared(WGD, max_error, omegaRed, omegaBlack, first, last, K, row, layer)
+    {
+      for (int color = 0; color < 2; ++color) {
+        const float omg = (color == 0) ? omegaRed : omegaBlack;
+
+        // Red (color 0) then black (color 1) nodes pass
+#pragma omp for reduction(max \
+                          : max_error)
+        for (int k = 1; k < WGD->nz - 2; ++k) {
+          for (int j = 1; j < WGD->ny - 2; ++j) {
+            for (int i = 2 - (j + k + color) % 2; i < WGD->nx - 2; i += 2) {
+              long icell_cent = i + j * row + k * layer;
+              const float e = WGD->e[icell_cent], f = WGD->f[icell_cent], g = WGD->g[icell_cent];
+              const float h = WGD->h[icell_cent], m = WGD->m[icell_cent], n = WGD->n[icell_cent];
+              const float diag = omg / (e + f + g + h + m + n);
+              float *lam = &batchLambda[icell_cent * K];
+              const float *rhs = &batchR[icell_cent * K];
+              for (int t = first; t < last; ++t) {
+                float old = lam[t];
+                float val = diag * (e * lam[t + K] + f * lam[t - K] + g * lam[t + row * K] + h * lam[t - row * K] + m * lam[t + layer * K] + n * lam[t - layer * K] - rhs[t])
+                            + (1.0f - omg) * old;// SOR formulation
+                lam[t] = val;
+                max_error = std::max(max_error, std::fabs(val - old));
+              }
+            }
+          }
         }
+        // end of omp for (with implicit barrier)
       }
-    }
-    // end of omp for (with implicit barrier)
 
+      // Mirror boundary condition (lambda (@k=0) = lambda (@k=1))
 #pragma omp for
-    for (int k = 1; k < WGD->nz - 1; ++k) {
-      for (int j = 0; j < WGD->ny - 1; ++j) {
-        for (int i = 0; i < WGD->nx - 1; ++i) {
-          icell_cent = i + j * (WGD->nx - 1) + k * (WGD->nx - 1) * (WGD->ny - 1);// Lineralized index for cell centered values
-          icell_face = i + j * WGD->nx + k * WGD->nx * WGD->ny;// Lineralized index for cell faced values
-
-          // If we are inside a building, set velocities to 0.0
-          if (WGD->icellflag[icell_cent] == 0 || WGD->icellflag[icell_cent] == 2) {
-            // Setting velocity field inside the building to zero
-            WGD->u[icell_face] = 0;
-            WGD->u[icell_face + 1] = 0;
-            WGD->v[icell_face] = 0;
-            WGD->v[icell_face + WGD->nx] = 0;
-            WGD->w[icell_face] = 0;
-            WGD->w[icell_face + WGD->nx * WGD->ny] = 0;
-          }
+      for (long icell_cent = 0; icell_cent < layer; ++icell_cent) {
+        for (int t = first; t < last; ++t) {
+          batchLambda[icell_cent * K + t] = batchLambda[(icell_cent + layer) * K + t];
         }
       }
+      // end of omp for (with implicit barrier)
     }
-    // end of omp for (with implicit barrier)
+    // end of omp parallel workshare
+    adaptOmega(iter, max_error);
+    iter += 1;
   }
+
+  printf("[Solver]\t Residual after %d itertations: %2.9f\n", iter, max_error);
+  printf("[Solver]\t Over-relaxation factor: %1.4f\n", omega);
+
   auto finish = std::chrono::high_resolution_clock::now();// Finish recording execution time
   std::chrono::duration<float> elapsedTotal = finish - startOfSolveMethod;
-  std::chrono::duration<float> elapsedSolve = finish - startSolveSection;
+  recordSolveStats(WGD, iter, elapsedTotal.count(), nRHS);
+  QESprofile::addCount("winds/solver/batched_timesteps", nRHS);
   std::cout << "\t\t Elapsed time: " << elapsedTotal.count() << " s\n";// Print out elapsed execution time
-  // std::cout << "Elapsed solve time: " << elapsedSolve.count() << " s\n";// Print out elapsed execution time
+}
+
+void Solver_CPU_RB::applyBatch(WINDSGeneralData *WGD, int k)
+{
+  updateVelocity(WGD, batchLambda, batchSize, k);
 }
@@ -74,4 +74,55 @@ protected:
    * @param solveWind :document this:
    */
   void solve(const WINDSInputData *WID, WINDSGeneralData *WGD, bool solveWind) override;
+
+public:
+  /**
+   * Allocates the storage of a batched solve of up to K timesteps.
+   *
+   * @param WGD winds data, used for the grid size
+   * @param K maximum number of right-hand sides solved together
+   */
+  void setBatchSize(WINDSGeneralData *WGD, int K);
+
+  /**
+   * Stores the divergence of the current initial field of WGD (after the wind
+   * profile and the parametrizations) as the right-hand side k of the batch.
+   *
+   * @param WGD winds data
+   * @param k index of the timestep in the batch
+   */
+  void storeBatchRHS(WINDSGeneralData *WGD, int k);
+
+  /**
+   * Solves the stored right-hand sides first to first + nRHS - 1 together: the
+   * operator only depends on the geometry, so each coefficient loaded is reused
+   * for all of them (Lagrange multipliers interleaved by timestep).
+   *
+   * The other slots of the batch are not touched, they can be stored or applied
+   * by another thread during the solve.
+   *
+   * @param WID input data, used for the maximum number of iterations
+   * @param WGD winds data, used for the geometry (not modified)
+   * @param nRHS number of right-hand sides in the batch
+   * @param first index of the first right-hand side solved
+   */
+  void solveBatch(const WINDSInputData *WID, WINDSGeneralData *WGD, int nRHS, int first = 0);
+
+  /**
+   * Computes the final velocity field of the timestep k of the batch.
+   *
+   * WGD has to hold the initial field of this timestep again: the caller sets
+   * it up (wind profile and parametrizations) before the call, which also
+   * restores the per-timestep state of the parametrizations read later by the
+   * turbulence model (canopy wake direction, canopy ustar, ...).
+   *
+   * @param WGD winds data
+   * @param k index of the timestep in the batch
+   */
+  void applyBatch(WINDSGeneralData *WGD, int k);
+
+protected:
+  int batchSize = 0; /**< Maximum number of right-hand sides of a batch */
+  std::vector<float> batchR; /**< Right-hand sides of the batch (interleaved: icell * batchSize + k) */
+  std::vector<float> batchLambda; /**< Lagrange multipliers of the batch (interleaved) */
 };
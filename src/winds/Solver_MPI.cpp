@@ -0,0 +1,419 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Winds
+ *
+ * GPL-3.0 License
+ *
+ * QES-Winds is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Winds is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Winds. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file Solver_MPI.cpp */
+
+#include "Solver_MPI.h"
+
+#include "util/QESout.h"
+#include "util/QESprofile.h"
+
+Solver_MPI::Solver_MPI(const WINDSInputData *WID, WINDSGeneralData *WGD)
+  : Solver(WID, WGD)
+{
+  nxc = WGD->nx - 1;
+  nyc = WGD->ny - 1;
+  nzc = WGD->nz - 1;
+
+  // size of the domain and parameters of the solver for the other processes
+  int sizes[4] = { nxc, nyc, nzc, adaptiveOmega };
+  float params[3] = { tol, omega, rhoJacobi };
+  MPI_Bcast(sizes, 4, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Bcast(params, 3, MPI_FLOAT, 0, MPI_COMM_WORLD);
+
+  setupTiles();
+  loadCoefficients(WGD);
+
+  // lambda_old is not used by the distributed passes
+  std::vector<float>().swap(lambda_old);
+
+  std::cout << "-------------------------------------------------------------------" << std::endl;
+  std::cout << "[Solver]\t Initializing Distributed Red/Black Solver (MPI) ..." << std::endl;
+  std::cout << "[Solver]\t " << nRanks << " processes, " << dims[0] << " x " << dims[1] << " tiles" << std::endl;
+}
+
+Solver_MPI::Solver_MPI()
+  : Solver()
+{
+  int sizes[4];
+  float params[3];
+  MPI_Bcast(sizes, 4, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Bcast(params, 3, MPI_FLOAT, 0, MPI_COMM_WORLD);
+  nxc = sizes[0];
+  nyc = sizes[1];
+  nzc = sizes[2];
+  adaptiveOmega = sizes[3];
+  tol = params[0];
+  omega = params[1];
+  rhoJacobi = params[2];
+
+  setupTiles();
+  loadCoefficients(nullptr);
+}
+
+Solver_MPI::~Solver_MPI()
+{
+  MPI_Comm_free(&cartComm);
+}
+
+int Solver_MPI::blockStart(int n, int parts, int b)
+{
+  // the first (n % parts) blocks get one more cell
+  return b * (n / parts) + std::min(b, n % parts);
+}
+
+void Solver_MPI::setupTiles()
+{
+  MPI_Comm_size(MPI_COMM_WORLD, &nRanks);
+
+  // process grid: the longest horizontal direction gets the most tiles
+  dims[0] = 0;
+  dims[1] = 0;
+  MPI_Dims_create(nRanks, 2, dims);
+  if ((nxc < nyc) == (dims[0] > dims[1])) {
+    std::swap(dims[0], dims[1]);
+  }
+  if (dims[0] > nxc || dims[1] > nyc) {
+    QESout::error("Domain too small to be split over " + std::to_string(nRanks) + " processes");
+  }
+
+  int periods[2] = { 0, 0 };
+  MPI_Cart_create(MPI_COMM_WORLD, 2, dims, periods, 0, &cartComm);
+  MPI_Comm_rank(cartComm, &rank);
+  MPI_Cart_coords(cartComm, rank, 2, coords);
+  MPI_Cart_shift(cartComm, 0, 1, &west, &east);
+  MPI_Cart_shift(cartComm, 1, 1, &south, &north);
+
+  int b[4];
+  tileBounds(rank, b);
+  i0 = b[0];
+  i1 = b[1];
+  j0 = b[2];
+  j1 = b[3];
+  nxt = i1 - i0 + 2;
+  nyt = j1 - j0 + 2;
+
+  size_t tileSize = (size_t)nxt * nyt * nzc;
+  eT.resize(tileSize, 0.0);
+  fT.resize(tileSize, 0.0);
+  gT.resize(tileSize, 0.0);
+  hT.resize(tileSize, 0.0);
+  mT.resize(tileSize, 0.0);
+  nT.resize(tileSize, 0.0);
+  RT.resize(tileSize, 0.0);
+  lambdaT.resize(tileSize, 0.0);
+
+  // the largest face of the halo
+  sendBuf.resize((size_t)std::max(nxt, nyt) * nzc);
+  recvBuf.resize(sendBuf.size());
+
+  // buffer of the tiles sent to and received from the other processes (the
+  // first process packs the tiles with halo of all the processes in it)
+  size_t bufSize = tileSize;
+  if (rank == 0) {
+    for (int r = 0; r < nRanks; ++r) {
+      tileBounds(r, b);
+      bufSize = std::max(bufSize, (size_t)(b[1] - b[0] + 2) * (b[3] - b[2] + 2) * nzc);
+    }
+  }
+  tileBuf.resize(bufSize);
+}
+
+void Solver_MPI::tileBounds(int r, int b[4]) const
+{
+  int c[2];
+  MPI_Cart_coords(cartComm, r, 2, c);
+  b[0] = blockStart(nxc, dims[0], c[0]);
+  b[1] = blockStart(nxc, dims[0], c[0] + 1);
+  b[2] = blockStart(nyc, dims[1], c[1]);
+  b[3] = blockStart(nyc, dims[1], c[1] + 1);
+}
+
+void Solver_MPI::scatterTile(const float *field, std::vector<float> &tile)
+{
+  if (rank != 0) {
+    MPI_Recv(tile.data(), (int)tile.size(), MPI_FLOAT, 0, 4, cartComm, MPI_STATUS_IGNORE);
+    return;
+  }
+
+  for (int r = 0; r < nRanks; ++r) {
+    int b[4];
+    tileBounds(r, b);
+    int rnx = b[1] - b[0] + 2, rny = b[3] - b[2] + 2;
+    // the tile of the first process is filled in place
+    float *buf = (r == 0) ? tile.data() : tileBuf.data();
+
+#pragma omp parallel for default(none) shared(field, b, rnx, rny, buf)
+    for (int k = 0; k < nzc; ++k) {
+      for (int j = b[2] - 1; j < b[3] + 1; ++j) {
+        for (int i = b[0] - 1; i < b[1] + 1; ++i) {
+          bool inside = (i >= 0 && i < nxc && j >= 0 && j < nyc);
+          buf[(i - b[0] + 1) + (j - b[2] + 1) * rnx + k * rnx * rny] = inside ? field[i + j * nxc + k * nxc * nyc] : 0.0f;
+        }
+      }
+    }
+
+    if (r != 0) {
+      MPI_Send(buf, rnx * rny * nzc, MPI_FLOAT, r, 4, cartComm);
+    }
+  }
+}
+
+void Solver_MPI::loadCoefficients(WINDSGeneralData *WGD)
+{
+  scatterTile(rank == 0 ? WGD->e.data() : nullptr, eT);
+  scatterTile(rank == 0 ? WGD->f.data() : nullptr, fT);
+  scatterTile(rank == 0 ? WGD->g.data() : nullptr, gT);
+  scatterTile(rank == 0 ? WGD->h.data() : nullptr, hT);
+  scatterTile(rank == 0 ? WGD->m.data() : nullptr, mT);
+  scatterTile(rank == 0 ? WGD->n.data() : nullptr, nT);
+}
+
+void Solver_MPI::loadTiles(WINDSGeneralData *WGD)
+{
+  if (rank == 0) {
+    computeDivergence(WGD, R, 1, 0);
+  }
+
+  scatterTile(rank == 0 ? R.data() : nullptr, RT);
+  scatterTile(rank == 0 ? lambda.data() : nullptr, lambdaT);
+}
+
+float Solver_MPI::sweep(int color, float omegaPass)
+{
+  // updated cells: the boundary cells of the domain are fixed
+  int ilo = std::max(i0, 1), ihi = std::min(i1, nxc - 1);
+  int jlo = std::max(j0, 1), jhi = std::min(j1, nyc - 1);
+  int sx = 1, sy = nxt, sz = nxt * nyt;
+
+  float max_change = 0.0;
+#pragma omp parallel for default(none) shared(color, omegaPass, ilo, ihi, jlo, jhi, sx, sy, sz) reduction(max \
+                                                                                                         : max_change)
+  for (int k = 1; k < nzc - 1; ++k) {
+    for (int j = jlo; j < jhi; ++j) {
+      // first cell of the color on the row
+      int istart = ilo + ((ilo + j + k + color) % 2);
+      for (int i = istart; i < ihi; i += 2) {
+        int id = tileId(i, j, k);
+        float old = lambdaT[id];
+        lambdaT[id] = (omegaPass / (eT[id] + fT[id] + gT[id] + hT[id] + mT[id] + nT[id]))
+                        * (eT[id] * lambdaT[id + sx]
+                           + fT[id] * lambdaT[id - sx]
+                           + gT[id] * lambdaT[id + sy]
+                           + hT[id] * lambdaT[id - sy]
+                           + mT[id] * lambdaT[id + sz]
+                           + nT[id] * lambdaT[id - sz] - RT[id])
+                      + (1.0f - omegaPass) * old;// SOR formulation
+        max_change = std::max(max_change, std::fabs(lambdaT[id] - old));
+      }
+    }
+  }
+  return max_change;
+}
+
+void Solver_MPI::exchangeHalo()
+{
+  int ny = j1 - j0;
+  MPI_Status status;
+
+  // x direction: columns of the tile (without the corners)
+  auto packColumn = [&](int i) {
+    for (int k = 0; k < nzc; ++k)
+      for (int j = j0; j < j1; ++j)
+        sendBuf[j - j0 + k * ny] = lambdaT[tileId(i, j, k)];
+  };
+  auto unpackColumn = [&](int i) {
+    for (int k = 0; k < nzc; ++k)
+      for (int j = j0; j < j1; ++j)
+        lambdaT[tileId(i, j, k)] = recvBuf[j - j0 + k * ny];
+  };
+  int count = ny * nzc;
+
+  packColumn(i0);
+  MPI_Sendrecv(sendBuf.data(), count, MPI_FLOAT, west, 0, recvBuf.data(), count, MPI_FLOAT, east, 0, cartComm, &status);
+  if (east != MPI_PROC_NULL) unpackColumn(i1);
+
+  packColumn(i1 - 1);
+  MPI_Sendrecv(sendBuf.data(), count, MPI_FLOAT, east, 1, recvBuf.data(), count, MPI_FLOAT, west, 1, cartComm, &status);
+  if (west != MPI_PROC_NULL) unpackColumn(i0 - 1);
+
+  // y direction: rows of the tile including the x halo
+  auto packRow = [&](int j) {
+    for (int k = 0; k < nzc; ++k)
+      for (int i = i0 - 1; i < i1 + 1; ++i)
+        sendBuf[i - i0 + 1 + k * nxt] = lambdaT[tileId(i, j, k)];
+  };
+  auto unpackRow = [&](int j) {
+    for (int k = 0; k < nzc; ++k)
+      for (int i = i0 - 1; i < i1 + 1; ++i)
+        lambdaT[tileId(i, j, k)] = recvBuf[i - i0 + 1 + k * nxt];
+  };
+  count = nxt * nzc;
+
+  packRow(j0);
+  MPI_Sendrecv(sendBuf.data(), count, MPI_FLOAT, south, 2, recvBuf.data(), count, MPI_FLOAT, north, 2, cartComm, &status);
+  if (north != MPI_PROC_NULL) unpackRow(j1);
+
+  packRow(j1 - 1);
+  MPI_Sendrecv(sendBuf.data(), count, MPI_FLOAT, north, 3, recvBuf.data(), count, MPI_FLOAT, south, 3, cartComm, &status);
+  if (south != MPI_PROC_NULL) unpackRow(j0 - 1);
+}
+
+void Solver_MPI::gatherLambda()
+{
+  if (rank != 0) {
+    int n = 0;
+    for (int k = 0; k < nzc; ++k)
+      for (int j = j0; j < j1; ++j)
+        for (int i = i0; i < i1; ++i)
+          tileBuf[n++] = lambdaT[tileId(i, j, k)];
+    MPI_Send(tileBuf.data(), n, MPI_FLOAT, 0, 5, cartComm);
+    return;
+  }
+
+  for (int k = 0; k < nzc; ++k)
+    for (int j = j0; j < j1; ++j)
+      for (int i = i0; i < i1; ++i)
+        lambda[i + j * nxc + k * nxc * nyc] = lambdaT[tileId(i, j, k)];
+
+  for (int r = 1; r < nRanks; ++r) {
+    int b[4];
+    tileBounds(r, b);
+    MPI_Recv(tileBuf.data(), (b[1] - b[0]) * (b[3] - b[2]) * nzc, MPI_FLOAT, r, 5, cartComm, MPI_STATUS_IGNORE);
+    int n = 0;
+    for (int k = 0; k < nzc; ++k)
+      for (int j = b[2]; j < b[3]; ++j)
+        for (int i = b[0]; i < b[1]; ++i)
+          lambda[i + j * nxc + k * nxc * nyc] = tileBuf[n++];
+  }
+}
+
+/**
+ * The red and black passes follow Solver_CPU_RB on each tile. The colors
+ * are defined from the global cell indices so that the ordering, and thus
+ * the solution, does not depend on the number of processes. The change of
+ * lambda is measured during the passes and reduced over all the processes,
+ * so that every process runs the same number of iterations with the same
+ * over-relaxation factors.
+ */
+int Solver_MPI::iterate(float &max_error)
+{
+  int iter = 0;
+  max_error = 1.0;
+
+  // over-relaxation factors of the red and black passes (Chebyshev acceleration)
+  float omegaRed = 1.0f;
+  float omegaBlack = 1.0f;
+
+  while (iter < itermax && max_error > tol) {
+    omegaRed = chebyshevOmega(2 * iter, omegaBlack);
+    omegaBlack = chebyshevOmega(2 * iter + 1, omegaRed);
+
+    // Red nodes pass
+    float local_error = sweep(0, omegaRed);
+    exchangeHalo();
+
+    // Black nodes pass
+    local_error = std::max(local_error, sweep(1, omegaBlack));
+
+    // Mirror boundary condition (lambda (@k=0) = lambda (@k=1))
+    for (int j = j0; j < j1; ++j) {
+      for (int i = i0; i < i1; ++i) {
+        lambdaT[tileId(i, j, 0)] = lambdaT[tileId(i, j, 1)];
+      }
+    }
+    exchangeHalo();
+
+    // Error calculation over all the tiles
+    MPI_Allreduce(&local_error, &max_error, 1, MPI_FLOAT, MPI_MAX, cartComm);
+
+    adaptOmega(iter, max_error);
+    iter += 1;
+  }
+  return iter;
+}
+
+void Solver_MPI::solve(const WINDSInputData *WID, WINDSGeneralData *WGD, bool solveWind)
+{
+  QESprofile::Scope profile("solver");
+  auto startOfSolveMethod = std::chrono::high_resolution_clock::now();// Start recording execution time
+
+  itermax = WID->simParams->maxIterations;
+  int command[2] = { SOLVE, itermax };
+  MPI_Bcast(command, 2, MPI_INT, 0, cartComm);
+
+  auto startSolveSection = std::chrono::high_resolution_clock::now();
+  loadTiles(WGD);
+
+  /***************************************************************
+   **********************   SOR Solver   *************************
+   ***************************************************************/
+
+  std::cout << "[Solver]\t Running Distributed Red/Black Solver (MPI) ..." << std::endl;
+
+  float max_error;
+  int iter = iterate(max_error);
+
+  gatherLambda();
+
+  printf("[Solver]\t Residual after %d itertations: %2.9f\n", iter, max_error);
+  printf("[Solver]\t Over-relaxation factor: %1.4f\n", omega);
+
+  updateVelocity(WGD, lambda, 1, 0);
+
+  auto finish = std::chrono::high_resolution_clock::now();// Finish recording execution time
+  std::chrono::duration<float> elapsedTotal = finish - startOfSolveMethod;
+  std::chrono::duration<float> elapsedSolve = finish - startSolveSection;
+  recordSolveStats(WGD, iter, elapsedSolve.count());
+  std::cout << "\t\t Elapsed time: " << elapsedTotal.count() << " s\n";// Print out elapsed execution time
+}
+
+void Solver_MPI::serve()
+{
+  int command[2];
+  while (true) {
+    MPI_Bcast(command, 2, MPI_INT, 0, cartComm);
+    if (command[0] == STOP) {
+      break;
+    }
+    itermax = command[1];
+
+    loadTiles(nullptr);
+    float max_error;
+    iterate(max_error);
+    gatherLambda();
+  }
+}
+
+void Solver_MPI::stop()
+{
+  int command[2] = { STOP, 0 };
+  MPI_Bcast(command, 2, MPI_INT, 0, cartComm);
+}
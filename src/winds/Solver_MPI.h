@@ -0,0 +1,217 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Winds
+ *
+ * GPL-3.0 License
+ *
+ * QES-Winds is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Winds is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Winds. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file Solver_MPI.h */
+
+#pragma once
+
+#include <cstdio>
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <chrono>
+
+#include <mpi.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "WINDSInputData.h"
+#include "Solver.h"
+
+/**
+ * @class Solver_MPI
+ * @brief Child class of the Solver that runs the red/black convergence
+ * algorithm distributed over several MPI processes.
+ *
+ * The horizontal domain is split into rectangular tiles, one per process.
+ * Each process holds the coefficients, the divergence and lambda of its tile
+ * plus a halo of one cell. The coefficients are sent to the processes once,
+ * when the solver is built; at each solve the first process computes the
+ * divergence and only sends the divergence and lambda of the tiles. The halo
+ * is exchanged with the neighboring tiles after each red and black pass and
+ * the convergence norm is reduced over all the processes. At the end of the
+ * solve lambda is gathered on the first process, which updates the velocity
+ * field. Within a tile the passes are multithreaded with OpenMP.
+ *
+ * Only the red/black iterations are distributed: the first process still
+ * builds and holds the whole domain (WINDSGeneralData, the divergence and
+ * lambda), so the size of the domain remains limited by the memory of the
+ * first process. The other processes construct the solver without the
+ * domain and take part in the solves of the first process through serve().
+ *
+ * @sa Solver_CPU_RB
+ */
+class Solver_MPI : public Solver
+{
+public:
+  /**
+   * Solver of the first process, which holds the domain.
+   */
+  Solver_MPI(const WINDSInputData *WID, WINDSGeneralData *WGD);
+
+  /**
+   * Solver of the other processes, which only hold their tile (the
+   * size of the domain and the parameters are sent by the first process).
+   */
+  Solver_MPI();
+  ~Solver_MPI();
+
+  /**
+   * Takes part in the solves of the first process until it calls stop()
+   * (other processes only).
+   */
+  void serve();
+
+  /**
+   * Releases the other processes from serve() (first process only).
+   */
+  void stop();
+
+protected:
+  /**
+   * Solves the wind field with the domain distributed over the processes.
+   *
+   * The solved lambda is gathered on the first process, which updates the
+   * velocity field of WINDSGeneralData.
+   *
+   * @param WID input data of the simulation
+   * @param WGD winds data
+   * @param solveWind unused, kept for the common solver interface
+   */
+  void solve(const WINDSInputData *WID, WINDSGeneralData *WGD, bool solveWind) override;
+
+private:
+  /**
+   * Commands sent by the first process to the others.
+   */
+  enum Command {
+    SOLVE = 0,
+    STOP = 1
+  };
+
+  /**
+   * Splits n cells into parts blocks and returns the first cell of block b.
+   */
+  static int blockStart(int n, int parts, int b);
+
+  /**
+   * Builds the process grid and allocates the tile and the buffers of the
+   * halo exchange and of the transfers with the first process.
+   */
+  void setupTiles();
+
+  /**
+   * Cells [b[0],b[1]) x [b[2],b[3]) of the tile of process r.
+   */
+  void tileBounds(int r, int b[4]) const;
+
+  /**
+   * Sends to each process its tile, halo included, of a cell-centered field
+   * of the whole domain (only read on the first process). The halo cells
+   * outside the domain are set to zero.
+   */
+  void scatterTile(const float *field, std::vector<float> &tile);
+
+  /**
+   * Scatters the coefficients of the tiles (once, when the solver is built).
+   *
+   * @param WGD winds data (nullptr on the other processes)
+   */
+  void loadCoefficients(WINDSGeneralData *WGD);
+
+  /**
+   * Computes the divergence and scatters the divergence and lambda of the tiles.
+   *
+   * @param WGD winds data (nullptr on the other processes)
+   */
+  void loadTiles(WINDSGeneralData *WGD);
+
+  /**
+   * Red/black iterations of the solve on the tile of the process.
+   *
+   * @param max_error maximum change of lambda over the last iteration (all the tiles)
+   * @return number of iterations
+   */
+  int iterate(float &max_error);
+
+  /**
+   * Red or black pass over the cells of the tile.
+   *
+   * @param color 0 for the red cells, 1 for the black cells
+   * @param omegaPass over-relaxation factor of the pass
+   * @return maximum change of lambda over the pass
+   */
+  float sweep(int color, float omegaPass);
+
+  /**
+   * Exchanges the halo of lambda with the neighboring tiles.
+   */
+  void exchangeHalo();
+
+  /**
+   * Gathers the lambda of all the tiles in the (full) lambda of the first process.
+   */
+  void gatherLambda();
+
+  int rank; /**< rank of the process */
+  int nRanks; /**< number of processes */
+  int dims[2]; /**< number of tiles in the x and y directions */
+  int coords[2]; /**< coordinates of the tile of the process */
+  MPI_Comm cartComm; /**< communicator of the cartesian process grid */
+  int west, east, south, north; /**< ranks of the neighboring tiles (MPI_PROC_NULL at the domain edge) */
+
+  int nxc, nyc, nzc; /**< number of cells of the whole domain */
+  int i0, i1, j0, j1; /**< cells [i0,i1) x [j0,j1) of the tile */
+  int nxt, nyt; /**< size of the tile including the halo */
+
+  ///@{
+  /** fields of the tile including the halo */
+  std::vector<float> eT, fT, gT, hT, mT, nT;
+  std::vector<float> RT, lambdaT;
+  ///@}
+
+  ///@{
+  /** buffers of the halo exchange */
+  std::vector<float> sendBuf, recvBuf;
+  ///@}
+
+  std::vector<float> tileBuf; /**< buffer of the tiles sent to and received from the first process */
+
+  /**
+   * Index of the cell (i,j,k) (global i and j) in the fields of the tile.
+   */
+  int tileId(int i, int j, int k) const
+  {
+    return (i - i0 + 1) + (j - j0 + 1) * nxt + k * nxt * nyt;
+  }
+};
@@ -35,9 +35,14 @@
 
 #include "TURBGeneralData.h"
 
+#include "util/QESprofile.h"
+
+#include <unistd.h>
+
 // TURBGeneralData::TURBGeneralData(Args* arguments, URBGeneralData* WGD){
 TURBGeneralData::TURBGeneralData(const WINDSInputData *WID, WINDSGeneralData *WGDin)
 {
+  QESprofile::Scope profile("turbulence_setup");
 
   auto StartTime = std::chrono::high_resolution_clock::now();
   std::cout << "-------------------------------------------------------------------" << std::endl;
@@ -154,7 +159,27 @@ TURBGeneralData::TURBGeneralData(const WINDSInputData *WID, WINDSGeneralData *WG
     // this should not happen (checked in TURBParams)
   }
 
-  localMixing->defineMixingLength(WID, m_WGD);
+  // the computed mixing lengths only depend on the geometry, keep them
+  // next to the preprocessed-domain cache (unless they are saved to file)
+  std::string mixingCacheFile;
+  if (!m_WGD->domainCacheFile.empty() && !WID->turbParams->save2file
+      && (WID->turbParams->methodLocalMixing == 1 || WID->turbParams->methodLocalMixing == 3)) {
+    mixingCacheFile = m_WGD->domainCacheFile.substr(0, m_WGD->domainCacheFile.rfind(".fcache"))
+                      + "_mixing" + std::to_string(WID->turbParams->methodLocalMixing) + ".fcache";
+  }
+  if (!mixingCacheFile.empty() && FieldCache::exists(mixingCacheFile)) {
+    std::cout << "[QES-TURB]\t Using mixing length cached in " << mixingCacheFile << std::endl;
+    FieldCache cache(mixingCacheFile);
+    cache.getVariableData("mixingLengths", 0, m_WGD->mixingLengths);
+  } else {
+    localMixing->defineMixingLength(WID, m_WGD);
+    if (!mixingCacheFile.empty()
+        && access(m_WGD->domainCacheFile.substr(0, m_WGD->domainCacheFile.find_last_of('/') + 1).c_str(), W_OK) == 0) {
+      FieldCacheWriter writer(mixingCacheFile);
+      writer.addVariable("mixingLengths", 0, m_WGD->mixingLengths);
+      writer.close();
+    }
+  }
 
   Lm.resize(numcell_cent, 0.0);
   // make a copy as mixing length will be modifiy by non local
@@ -272,6 +297,7 @@ TURBGeneralData::TURBGeneralData(const std::string inputFile, WINDSGeneralData *
   m_WGD = WGDin;
 
   // fullname passed to WINDSGeneralData
+  inputFileName = inputFile;
   input = new NetCDFInput(inputFile);
 
   // nx,ny - face centered value (consistant with QES-Winds)
@@ -482,39 +508,149 @@ void TURBGeneralData::loadNetCDFData(int stepin)
 {
   std::cout << "[QES-TURB]\t loading data at step " << stepin << std::endl;
 
+  // wait for the background reader (if any) before touching the back buffer
+  if (prefetchThread.joinable()) {
+    prefetchThread.join();
+  }
+  if (fieldCache) {
+    // the fields are only read: index the mapping in place (no copy)
+    mapped.txx = fieldCache->getVariableView("txx", stepin);
+    mapped.txy = fieldCache->getVariableView("txy", stepin);
+    mapped.txz = fieldCache->getVariableView("txz", stepin);
+    mapped.tyy = fieldCache->getVariableView("tyy", stepin);
+    mapped.tyz = fieldCache->getVariableView("tyz", stepin);
+    mapped.tzz = fieldCache->getVariableView("tzz", stepin);
+    mapped.tke = fieldCache->getVariableView("tke", stepin);
+    mapped.CoEps = fieldCache->getVariableView("CoEps", stepin);
+    for (auto *field : { &txx, &txy, &txz, &tyy, &tyz, &tzz, &tke, &CoEps }) {
+      std::vector<float>().swap(*field);
+    }
+  } else {
+    if (nextStep.step != stepin) {
+      readNetCDFData(stepin, nextStep);
+    }
+
+    // swap the back buffer in (cheap, no copy)
+    txx.swap(nextStep.txx);
+    txy.swap(nextStep.txy);
+    txz.swap(nextStep.txz);
+    tyy.swap(nextStep.tyy);
+    tyz.swap(nextStep.tyz);
+    tzz.swap(nextStep.tzz);
+    tke.swap(nextStep.tke);
+    CoEps.swap(nextStep.CoEps);
+  }
+  nextStep.step = -1;
+
+  divergenceStress();
+
+  return;
+}
+
+void TURBGeneralData::prefetchNetCDFData(int stepin)
+{
+  if (stepin < 0 || stepin >= nt) {
+    return;
+  }
+  if (prefetchThread.joinable()) {
+    prefetchThread.join();
+  }
+  prefetchThread = std::thread(&TURBGeneralData::readNetCDFData, this, stepin, std::ref(nextStep));
+}
+
+void TURBGeneralData::readNetCDFData(int stepin, NetCDFStepBuffer &buffer)
+{
   // netCDF variables
   std::vector<size_t> start;
   std::vector<size_t> count_cc;
-  std::vector<size_t> count_fc;
 
-  start = { static_cast<unsigned long>(stepin), 0, 0, 0 };
+  // the fields may only be held on a window of the domain (see WINDSGeneralData)
+  start = { static_cast<unsigned long>(stepin),
+            0,
+            static_cast<unsigned long>(m_WGD->windowJ0),
+            static_cast<unsigned long>(m_WGD->windowI0) };
   count_cc = { 1,
                static_cast<unsigned long>(nz - 1),
                static_cast<unsigned long>(ny - 1),
                static_cast<unsigned long>(nx - 1) };
 
-  // stress tensor
-  input->getVariableData("txx", start, count_cc, txx);
-  input->getVariableData("txy", start, count_cc, txy);
-  input->getVariableData("txz", start, count_cc, txz);
-  input->getVariableData("tyy", start, count_cc, tyy);
-  input->getVariableData("tyz", start, count_cc, tyz);
-  input->getVariableData("tzz", start, count_cc, tzz);
+  if (fieldCache) {
+    // read in place by loadNetCDFData, only page them in ahead
+    for (const std::string name : { "txx", "txy", "txz", "tyy", "tyz", "tzz", "tke", "CoEps" }) {
+      fieldCache->willNeed(name, stepin);
+    }
+  } else {
+    for (auto *field : { &buffer.txx, &buffer.txy, &buffer.txz, &buffer.tyy, &buffer.tyz, &buffer.tzz, &buffer.tke, &buffer.CoEps }) {
+      field->resize(numcell_cent);
+    }
 
-  // face-center variables
-  input->getVariableData("tke", start, count_cc, tke);
-  input->getVariableData("CoEps", start, count_cc, CoEps);
+    // stress tensor
+    input->getVariableData("txx", start, count_cc, buffer.txx);
+    input->getVariableData("txy", start, count_cc, buffer.txy);
+    input->getVariableData("txz", start, count_cc, buffer.txz);
+    input->getVariableData("tyy", start, count_cc, buffer.tyy);
+    input->getVariableData("tyz", start, count_cc, buffer.tyz);
+    input->getVariableData("tzz", start, count_cc, buffer.tzz);
+
+    // derived turbulence quantities
+    input->getVariableData("tke", start, count_cc, buffer.tke);
+    input->getVariableData("CoEps", start, count_cc, buffer.CoEps);
+  }
 
-  divergenceStress();
+  buffer.step = stepin;
+}
 
-  return;
-  // std::cout << "\t\t Memory allocation completed.\n";
-  std::cout << "[QES-TURB]\t Initialization of turbulence model completed.\n";
+void TURBGeneralData::attachFieldCache(const std::string &cacheFile)
+{
+  // the cache maps the fields of the whole domain
+  if (nx != (int)m_WGD->x.size() + 1 || ny != (int)m_WGD->y.size() + 1) {
+    QESout::error("The field cache cannot be used with a window of the domain");
+  }
+
+  // the background reader must not switch source in the middle of a step
+  if (prefetchThread.joinable()) {
+    prefetchThread.join();
+  }
+
+  if (!FieldCache::exists(cacheFile, inputFileName)) {
+    writeFieldCache(cacheFile);
+  }
+  // the views of the previous cache (if any) are released with it
+  mapped = MappedStep();
+  delete fieldCache;
+  fieldCache = new FieldCache(cacheFile);
+}
+
+void TURBGeneralData::writeFieldCache(const std::string &cacheFile)
+{
+  auto startTime = std::chrono::high_resolution_clock::now();
+
+  std::vector<size_t> count_cc = { 1,
+                                   static_cast<unsigned long>(nz - 1),
+                                   static_cast<unsigned long>(ny - 1),
+                                   static_cast<unsigned long>(nx - 1) };
+  std::vector<float> cellVar(numcell_cent);
+
+  FieldCacheWriter writer(cacheFile);
+  for (int k = 0; k < nt; ++k) {
+    std::vector<size_t> start = { static_cast<unsigned long>(k), 0, 0, 0 };
+    for (const auto &name : { "txx", "txy", "txz", "tyy", "tyz", "tzz", "tke", "CoEps" }) {
+      input->getVariableData(name, start, count_cc, cellVar);
+      writer.addVariable(name, k, cellVar);
+    }
+  }
+  writer.close();
+
+  auto endTime = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> elapsed = endTime - startTime;
+  std::cout << "[TURB Data] \t Field cache written (" << nt << " steps) in "
+            << elapsed.count() << " s" << std::endl;
 }
 
 // compute turbulence fields
 void TURBGeneralData::run()
 {
+  QESprofile::Scope profile("turbulence");
 
   auto StartTime = std::chrono::high_resolution_clock::now();
   std::cout << "-------------------------------------------------------------------" << std::endl;
@@ -963,22 +1099,22 @@ void TURBGeneralData::divergenceStress()
 
   // x-comp of the divergence of the stress tensor
   // div(tau)_x = dtxxdx + dtxydy + dtxzdz
-  derivativeStress(txx, txy, txz, div_tau_x);
+  derivativeStress(txxView(), txyView(), txzView(), div_tau_x);
 
   // y-comp of the divergence of the stress tensor
   // div(tau)_y = dtxzdx + dtyydy + dtyzdz
-  derivativeStress(txy, tyy, tyz, div_tau_y);
+  derivativeStress(txyView(), tyyView(), tyzView(), div_tau_y);
 
   // z-comp of the divergence of the stress tensor
   // div(tau)_z = dtxzdx + dtyzdy + dtzzdz
-  derivativeStress(txz, tyz, tzz, div_tau_z);
+  derivativeStress(txzView(), tyzView(), tzzView(), div_tau_z);
 
   return;
 }
 
-void TURBGeneralData::derivativeStress(const std::vector<float> &tox,
-                                       const std::vector<float> &toy,
-                                       const std::vector<float> &toz,
+void TURBGeneralData::derivativeStress(const FieldView<float> &tox,
+                                       const FieldView<float> &toy,
+                                       const FieldView<float> &toz,
                                        std::vector<float> &div_tau_o)
 {
   // o-comp of the divergence of the stress tensor
@@ -34,6 +34,7 @@
 
 #include <math.h>
 #include <vector>
+#include <thread>
 
 #include "WINDSInputData.h"
 #include "WINDSGeneralData.h"
@@ -60,11 +61,30 @@ public:
   TURBGeneralData(const std::string, WINDSGeneralData *);
   TURBGeneralData(WINDSGeneralData *);
   virtual ~TURBGeneralData()
-  {}
+  {
+    if (prefetchThread.joinable()) {
+      prefetchThread.join();
+    }
+    delete fieldCache;
+  }
 
   virtual void run();
 
   void loadNetCDFData(int);
+  /**
+   * Starts reading the fields of a given step of the QES-Turb file on a
+   * background thread (see WINDSGeneralData::prefetchNetCDFData).
+   *
+   * @param stepin index of the time step to read ahead
+   */
+  void prefetchNetCDFData(int);
+  /**
+   * Reads the time-dependent fields from a memory-mapped field cache instead
+   * of the NetCDF file (see WINDSGeneralData::attachFieldCache).
+   *
+   * @param cacheFile path of the field cache
+   */
+  void attachFieldCache(const std::string &);
   void divergenceStress();
 
   // General QUIC Domain Data
@@ -142,8 +162,23 @@ public:
   std::vector<float> tke; /**< turbulence kinetic energy */
   std::vector<float> CoEps; /**< dissipation rate */
 
+  ///@{
+  /**
+   * Read-only views of the stress tensor, tke and CoEps. With a field cache
+   * attached, they point into its mapping and the vectors are left empty.
+   */
+  FieldView<float> txxView() const { return mapped.txx.empty() ? FieldView<float>(txx) : mapped.txx; }
+  FieldView<float> txyView() const { return mapped.txy.empty() ? FieldView<float>(txy) : mapped.txy; }
+  FieldView<float> txzView() const { return mapped.txz.empty() ? FieldView<float>(txz) : mapped.txz; }
+  FieldView<float> tyyView() const { return mapped.tyy.empty() ? FieldView<float>(tyy) : mapped.tyy; }
+  FieldView<float> tyzView() const { return mapped.tyz.empty() ? FieldView<float>(tyz) : mapped.tyz; }
+  FieldView<float> tzzView() const { return mapped.tzz.empty() ? FieldView<float>(tzz) : mapped.tzz; }
+  FieldView<float> tkeView() const { return mapped.tke.empty() ? FieldView<float>(tke) : mapped.tke; }
+  FieldView<float> CoEpsView() const { return mapped.CoEps.empty() ? FieldView<float>(CoEps) : mapped.CoEps; }
+  ///@}
+
   LocalMixing *localMixing; /**< mixing length class */
-  std::vector<double> mixingLengths; /**< distance to the wall */
+  std::vector<float> mixingLengths; /**< distance to the wall */
 
 
   void invert3(double &A_11,
@@ -202,9 +237,9 @@ protected:
   void getTurbulentViscosity();
   void stressTensor();
 
-  void derivativeStress(const std::vector<float> &,
-                        const std::vector<float> &,
-                        const std::vector<float> &,
+  void derivativeStress(const FieldView<float> &,
+                        const FieldView<float> &,
+                        const FieldView<float> &,
                         std::vector<float> &);
 
   void addBackgroundMixing();
@@ -226,6 +261,33 @@ private:
 
   // input: store here for multiple time instance.
   NetCDFInput *input;
+  std::string inputFileName; /**< path of the QES-Turb file */
+  FieldCache *fieldCache = nullptr; /**< read-only mapped fields (optional) */
+
+  /**
+   * Time-dependent fields of one step of the QES-Turb file (back buffer).
+   */
+  struct NetCDFStepBuffer
+  {
+    int step = -1;
+    std::vector<float> txx, txy, txz, tyy, tyz, tzz;
+    std::vector<float> tke, CoEps;
+  };
+  NetCDFStepBuffer nextStep; /**< back buffer filled by prefetchNetCDFData */
+
+  /**
+   * Fields of the loaded step in the field cache (empty without cache).
+   */
+  struct MappedStep
+  {
+    FieldView<float> txx, txy, txz, tyy, tyz, tzz;
+    FieldView<float> tke, CoEps;
+  };
+  MappedStep mapped;
+  std::thread prefetchThread; /**< background reader of the back buffer */
+
+  void readNetCDFData(int, NetCDFStepBuffer &);
+  void writeFieldCache(const std::string &);
 
   bool flagUniformZGrid = true; /**< :document this: */
   bool flagNonLocalMixing; /**< :document this: */
@@ -306,9 +306,9 @@ void TURBWall::comp_velocity_deriv_finitediff_stairstep(WINDSGeneralData *WGD, T
 
 void TURBWall::comp_stress_deriv_finitediff_stairstep(WINDSGeneralData *WGD,
                                                       TURBGeneralData *TGD,
-                                                      const std::vector<float> &tox,
-                                                      const std::vector<float> &toy,
-                                                      const std::vector<float> &toz)
+                                                      const FieldView<float> &tox,
+                                                      const FieldView<float> &toy,
+                                                      const FieldView<float> &toz)
 {
   int nx = WGD->nx;
   int ny = WGD->ny;
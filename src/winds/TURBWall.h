@@ -68,9 +68,9 @@ public:
   virtual void setWallsVelocityDeriv(WINDSGeneralData *, TURBGeneralData *) = 0;
   virtual void setWallsStressDeriv(WINDSGeneralData *,
                                    TURBGeneralData *,
-                                   const std::vector<float> &,
-                                   const std::vector<float> &,
-                                   const std::vector<float> &) = 0;
+                                   const FieldView<float> &,
+                                   const FieldView<float> &,
+                                   const FieldView<float> &) = 0;
 
 protected:
   void get_stairstep_wall_id(WINDSGeneralData *, int);
@@ -85,9 +85,9 @@ protected:
   void comp_velocity_deriv_finitediff_stairstep(WINDSGeneralData *, TURBGeneralData *);
   void comp_stress_deriv_finitediff_stairstep(WINDSGeneralData *,
                                               TURBGeneralData *,
-                                              const std::vector<float> &,
-                                              const std::vector<float> &,
-                                              const std::vector<float> &);
+                                              const FieldView<float> &,
+                                              const FieldView<float> &,
+                                              const FieldView<float> &);
 
   // cell
   std::vector<pairCellFaceID> wall_right_indices; /**< Indices of the cells with wall to right boundary condition */
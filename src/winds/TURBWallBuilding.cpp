@@ -77,9 +77,9 @@ void TURBWallBuilding::setWallsVelocityDeriv(WINDSGeneralData *WGD, TURBGeneralD
 
 void TURBWallBuilding::setWallsStressDeriv(WINDSGeneralData *WGD,
                                            TURBGeneralData *TGD,
-                                           const std::vector<float> &tox,
-                                           const std::vector<float> &toy,
-                                           const std::vector<float> &toz)
+                                           const FieldView<float> &tox,
+                                           const FieldView<float> &toy,
+                                           const FieldView<float> &toz)
 {
   if (comp_wall_stress_deriv) (this->*comp_wall_stress_deriv)(WGD, TGD, tox, toy, toz);
 }
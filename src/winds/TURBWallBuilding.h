@@ -59,9 +59,9 @@ protected:
   void (TURBWallBuilding::*comp_wall_velocity_deriv)(WINDSGeneralData *, TURBGeneralData *);
   void (TURBWallBuilding::*comp_wall_stress_deriv)(WINDSGeneralData *,
                                                    TURBGeneralData *,
-                                                   const std::vector<float> &,
-                                                   const std::vector<float> &,
-                                                   const std::vector<float> &);
+                                                   const FieldView<float> &,
+                                                   const FieldView<float> &,
+                                                   const FieldView<float> &);
 
   void set_loglaw_stairstep(WINDSGeneralData *, TURBGeneralData *);
 
@@ -73,9 +73,9 @@ public:
   void setWallsVelocityDeriv(WINDSGeneralData *, TURBGeneralData *);
   void setWallsStressDeriv(WINDSGeneralData *,
                            TURBGeneralData *,
-                           const std::vector<float> &,
-                           const std::vector<float> &,
-                           const std::vector<float> &);
+                           const FieldView<float> &,
+                           const FieldView<float> &,
+                           const FieldView<float> &);
 
 private:
   TURBWallBuilding()
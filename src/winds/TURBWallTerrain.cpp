@@ -78,9 +78,9 @@ void TURBWallTerrain::setWallsVelocityDeriv(WINDSGeneralData *WGD, TURBGeneralDa
 
 void TURBWallTerrain::setWallsStressDeriv(WINDSGeneralData *WGD,
                                           TURBGeneralData *TGD,
-                                          const std::vector<float> &tox,
-                                          const std::vector<float> &toy,
-                                          const std::vector<float> &toz)
+                                          const FieldView<float> &tox,
+                                          const FieldView<float> &toy,
+                                          const FieldView<float> &toz)
 {
   if (comp_wall_stress_deriv) (this->*comp_wall_stress_deriv)(WGD, TGD, tox, toy, toz);
 }
@@ -0,0 +1,86 @@
+/****************************************************************************
+ * Copyright (c) 2024 University of Utah
+ * Copyright (c) 2024 University of Minnesota Duluth
+ *
+ * Copyright (c) 2024 Behnam Bozorgmehr
+ * Copyright (c) 2024 Jeremy A. Gibbs
+ * Copyright (c) 2024 Fabien Margairaz
+ * Copyright (c) 2024 Eric R. Pardyjak
+ * Copyright (c) 2024 Zachary Patterson
+ * Copyright (c) 2024 Rob Stoll
+ * Copyright (c) 2024 Lucas Ulmer
+ * Copyright (c) 2024 Pete Willemsen
+ *
+ * This file is part of QES-Winds
+ *
+ * GPL-3.0 License
+ *
+ * QES-Winds is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3 of the License.
+ *
+ * QES-Winds is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with QES-Winds. If not, see <https://www.gnu.org/licenses/>.
+ ****************************************************************************/
+
+/** @file VisualizationSlices.h */
+
+#pragma once
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "util/ParseInterface.h"
+
+/**
+ * @class VisualizationSlices
+ * @brief Reduced outputs of the visualization file (read from the fileOptions).
+ *
+ * Each reduced output is written as separate small variables:
+ *   - horizontal slices at fixed heights above the terrain (terrain-following),
+ *   - vertical cross-sections at fixed x or y positions,
+ *   - a decimated volume keeping one cell every stride cells in each direction.
+ * The full 3D fields can be turned off to keep only the reduced outputs.
+ *
+ * @sa ParseInterface
+ */
+class VisualizationSlices : public ParseInterface
+{
+private:
+public:
+  std::vector<float> sliceHeights; /**< Heights of the horizontal slices above the terrain (m) */
+  std::vector<float> xSections; /**< x-positions of the vertical cross-sections (m) */
+  std::vector<float> ySections; /**< y-positions of the vertical cross-sections (m) */
+  int stride = 0; /**< Stride of the decimated volume (0 -> no decimated volume) */
+  bool fullVolume = true; /**< Output of the full 3D fields */
+
+  VisualizationSlices()
+  {}
+
+  virtual void parseValues()
+  {
+    parseMultiPrimitives<float>(false, sliceHeights, "sliceHeight");
+    parseMultiPrimitives<float>(false, xSections, "xSection");
+    parseMultiPrimitives<float>(false, ySections, "ySection");
+    parsePrimitive<int>(false, stride, "stride");
+    parsePrimitive<bool>(false, fullVolume, "fullVolume");
+
+    for (auto h : sliceHeights) {
+      if (h < 0.0) {
+        std::cerr << "[ERROR] visualizationSlices: slice heights must be positive" << std::endl;
+        exit(EXIT_FAILURE);
+      }
+    }
+    if (stride < 0) {
+      std::cerr << "[ERROR] visualizationSlices: stride must be positive (0 -> no decimated volume)" << std::endl;
+      exit(EXIT_FAILURE);
+    }
+  }
+};
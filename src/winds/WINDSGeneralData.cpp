@@ -35,12 +35,20 @@
 
 #include "WINDSGeneralData.h"
 
+#include "util/QESprofile.h"
+
+#include <functional>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #define PBSTR "||||||||||||||||||||||||||||||||||||||||||||||||||||||||||||"
 #define PBWIDTH 60
 #define LIMIT 99999999.0f
 
 WINDSGeneralData::WINDSGeneralData(const WINDSInputData *WID, int solverType)
 {
+  QESprofile::Scope profile("winds_setup");
   std::cout << "-------------------------------------------------------------------" << std::endl;
   std::cout << "[QES-WINDS]\t Initialization of wind model...\n";
 
@@ -252,7 +260,8 @@ WINDSGeneralData::WINDSGeneralData(const WINDSInputData *WID, int solverType)
        - does not support halo for lon/lat coord (site coord == 3)
     */
 
-    if (solverType == 1) {
+    // CPU solvers: red/black (1) and distributed red/black (5)
+    if (solverType == 1 || solverType == 5) {
       windProfiler = new WindProfilerBarnCPU();
 #ifdef HAS_CUDA
     } else {
@@ -399,6 +408,13 @@ WINDSGeneralData::WINDSGeneralData(const WINDSInputData *WID, int solverType)
   halo_index_y = (WID->simParams->halo_y / dy);
   halo_y = halo_index_y * dy;
 
+  // same grid, terrain and buildings as a previous run -> restore the preprocessing
+  domainCacheFile = domainCacheFileName(WID);
+  domainCacheHit = !domainCacheFile.empty() && FieldCache::exists(domainCacheFile);
+  if (domainCacheHit) {
+    std::cout << "[QES-WINDS]	 Using preprocessed domain cached in " << domainCacheFile << std::endl;
+  }
+
   ////////////////////////////////////////////////////////
   //////              Apply Terrain code             /////
   ///////////////////////////////////////////////////////
@@ -583,7 +599,7 @@ WINDSGeneralData::WINDSGeneralData(const WINDSInputData *WID, int solverType)
       }
     }
 
-    if (WID->simParams->meshTypeFlag == 0 && WID->simParams->readCoefficientsFlag == 0) {
+    if (WID->simParams->meshTypeFlag == 0 && WID->simParams->readCoefficientsFlag == 0 && !domainCacheHit) {
       ///////////////////////////////////
       // Stair-step (original QUIC)    //
       ///////////////////////////////////
@@ -612,7 +628,7 @@ WINDSGeneralData::WINDSGeneralData(const WINDSInputData *WID, int solverType)
       std::cout << "\t\t elapsed time: " << elapsed_stair.count() << " s\n";
     }
 
-    if (WID->simParams->meshTypeFlag == 1 && WID->simParams->readCoefficientsFlag == 0) {
+    if (WID->simParams->meshTypeFlag == 1 && WID->simParams->readCoefficientsFlag == 0 && !domainCacheHit) {
       //////////////////////////////////
       //        Cut-cell method       //
       //////////////////////////////////
@@ -811,9 +827,14 @@ WINDSGeneralData::WINDSGeneralData(const WINDSInputData *WID, int solverType)
 
   std::cout << "[QES-WINDS]\t Defining solid walls..." << std::flush;
   wall = new Wall();
-  // Boundary condition for building edges
-  wall->defineWalls(this);
-  wall->solverCoefficients(this);
+  if (domainCacheHit) {
+    // cell flags, coefficients and walls of the whole preprocessing
+    loadDomainCache(domainCacheFile);
+  } else {
+    // Boundary condition for building edges
+    wall->defineWalls(this);
+    wall->solverCoefficients(this);
+  }
   std::cout << "\r[QES-WINDS]\t Defining solid walls... [DONE]" << std::endl;
 
   auto wallsetup_finish = std::chrono::high_resolution_clock::now();// Finish recording execution time
@@ -824,6 +845,10 @@ WINDSGeneralData::WINDSGeneralData(const WINDSInputData *WID, int solverType)
     icellflag_initial[id] = icellflag[id];
   }
 
+  if (!domainCacheFile.empty() && !domainCacheHit) {
+    saveDomainCache(domainCacheFile);
+  }
+
   /////////////////////////////////////////////////////////
   /////       Read coefficients from a file            ////
   /////////////////////////////////////////////////////////
@@ -863,13 +888,14 @@ WINDSGeneralData::WINDSGeneralData(const WINDSInputData *WID, int solverType)
 }
 
 
-WINDSGeneralData::WINDSGeneralData(const std::string inputFile)
+WINDSGeneralData::WINDSGeneralData(const std::string inputFile, const std::vector<int> &window)
 {
   std::cout << "-------------------------------------------------------------------" << std::endl;
   std::cout << "[QES-WINDS]\t Initialization of wind model...\n";
   std::cout << "[WINDS Data]\t Loading QES-winds fields " << std::endl;
 
   // fullname passed to WINDSGeneralData
+  inputFileName = inputFile;
   input = new NetCDFInput(inputFile);
 
   // create wall instance for BC
@@ -883,12 +909,7 @@ WINDSGeneralData::WINDSGeneralData(const std::string inputFile)
   // nt - number of time instance in data
   input->getDimensionSize("t", nt);
 
-  numcell_cout = (nx - 1) * (ny - 1) * (nz - 2); /**< Total number of cell-centered values in domain */
-  numcell_cout_2d = (nx - 1) * (ny - 1); /**< Total number of horizontal cell-centered values in domain */
-  numcell_cent = (nx - 1) * (ny - 1) * (nz - 1); /**< Total number of cell-centered values in domain */
-  numcell_face = nx * ny * nz; /**< Total number of face-centered values in domain */
-
-  // get grid information
+  // get grid information (x and y on the whole domain)
   x.resize(nx - 1);
   y.resize(ny - 1);
   z.resize(nz - 1);
@@ -902,6 +923,25 @@ WINDSGeneralData::WINDSGeneralData(const std::string inputFile)
   dy = y[1] - y[0]; /**< Grid resolution in x-direction */
   dxy = MIN_S(dx, dy);
 
+  // horizontal window of the domain: the fields are only read on the window
+  if (!window.empty()) {
+    if (window[0] < 0 || window[1] > nx - 1 || window[1] - window[0] < 2
+        || window[2] < 0 || window[3] > ny - 1 || window[3] - window[2] < 2) {
+      QESout::error("Invalid window of the domain");
+    }
+    windowI0 = window[0];
+    windowJ0 = window[2];
+    nx = window[1] - window[0] + 1;
+    ny = window[3] - window[2] + 1;
+    std::cout << "[WINDS Data] \t Loading the window [" << window[0] << "," << window[1] << ") x ["
+              << window[2] << "," << window[3] << ") of the domain" << std::endl;
+  }
+
+  numcell_cout = (nx - 1) * (ny - 1) * (nz - 2); /**< Total number of cell-centered values in domain */
+  numcell_cout_2d = (nx - 1) * (ny - 1); /**< Total number of horizontal cell-centered values in domain */
+  numcell_cent = (nx - 1) * (ny - 1) * (nz - 1); /**< Total number of cell-centered values in domain */
+  numcell_face = nx * ny * nz; /**< Total number of face-centered values in domain */
+
   input->getVariableData("z", z);
   // check if dz_array is in the NetCDF file
   NcVar NcVar_dz;
@@ -976,7 +1016,8 @@ WINDSGeneralData::WINDSGeneralData(const std::string inputFile)
   std::vector<size_t> start;
   std::vector<size_t> count_2d;
 
-  start = { 0, 0 };
+  start = { static_cast<unsigned long>(windowJ0),
+            static_cast<unsigned long>(windowI0) };
   count_2d = { static_cast<unsigned long>(ny - 1),
                static_cast<unsigned long>(nx - 1) };
 
@@ -1064,14 +1105,9 @@ void WINDSGeneralData::allocateMemory()
 
   building_volume_frac.resize(numcell_cent, 1.0);
   terrain_volume_frac.resize(numcell_cent, 1.0);
-  ni.resize(numcell_cent, 0.0);
-  nj.resize(numcell_cent, 0.0);
-  nk.resize(numcell_cent, 0.0);
-  ti.resize(numcell_cent, 0.0);
-  tj.resize(numcell_cent, 0.0);
-  tk.resize(numcell_cent, 0.0);
+  // cut-cell geometry is sparse, only the cut cells and the wall cells are stored
+  cutCellGeometry.clear();
   center_id.resize(numcell_cent, 1);
-  wall_distance.resize(numcell_cent, 0.0);
 
   icellflag.resize(numcell_cent, 1);
   icellflag_initial.resize(numcell_cent, 1);
@@ -1104,32 +1140,81 @@ void WINDSGeneralData::loadNetCDFData(int stepin)
 
   std::cout << "[WINDS Data] \t Loading data at step " << stepin
             << " (" << timestamp[stepin] << ")" << std::endl;
-#if 0
-  std::vector<size_t> start_time;
-  std::vector<size_t> count_time;
-  start_time = { static_cast<unsigned long>(stepin), 0 };
-  count_time = { 1, 19 };
 
-  NcVar NcVar_timestamp;
-  input->getVariable("timestamp", NcVar_timestamp);
+  // wait for the background reader (if any) before touching the back buffer
+  if (prefetchThread.joinable()) {
+    prefetchThread.join();
+  }
+  if (nextStep.step != stepin) {
+    readNetCDFData(stepin, nextStep);
+  } else {
+    std::cout << "[WINDS Data] \t Using prefetched data for step " << stepin << std::endl;
+  }
+
+  if (fieldCache) {
+    // the velocity is only read: index the mapping in place (no copy)
+    u_mapped = fieldCache->getVariableView("u", stepin);
+    v_mapped = fieldCache->getVariableView("v", stepin);
+    w_mapped = fieldCache->getVariableView("w", stepin);
+    std::vector<float>().swap(u);
+    std::vector<float>().swap(v);
+    std::vector<float>().swap(w);
+  } else {
+    // swap the back buffer in (cheap, no copy)
+    u.swap(nextStep.u);
+    v.swap(nextStep.v);
+    w.swap(nextStep.w);
+  }
 
-  std::vector<char> timestamp_tmp;
-  NcVar_timestamp.getVar(start_time, count_time, &timestamp_tmp[0]);
-  std::string tmp;
-  for (int i = 0; i < 19; ++i) {
-    tmp[i] = timestamp_tmp[i];
+  if (nextStep.sameGeometry) {
+    // icellflag (and hence the coefficients and the walls) did not change:
+    // the current processed fields and wall indices are still valid
+    nextStep.step = -1;
+    return;
   }
-  QEStime time(tmp);
-  std::cout << "read at time " << time << std::endl;
 
-  timestamp.push_back(time);
-#endif
+  icellflag_loaded = nextStep.icellflag;
+  icellflag.swap(nextStep.icellflag);
+  e.swap(nextStep.e);
+  f.swap(nextStep.f);
+  g.swap(nextStep.g);
+  h.swap(nextStep.h);
+  m.swap(nextStep.m);
+  n.swap(nextStep.n);
+  nextStep.step = -1;
+
+  // clear wall indices container (guarantee entry vector)
+  wall_right_indices.clear();
+  wall_left_indices.clear();
+  wall_above_indices.clear();
+  wall_below_indices.clear();
+  wall_front_indices.clear();
+  wall_back_indices.clear();
+  wall_indices.clear();
+
+  // define new wall indices container for new data
+  wall->defineWalls(this);
+
+  return;
+}
+
+void WINDSGeneralData::prefetchNetCDFData(int stepin)
+{
+  if (stepin < 0 || stepin >= nt) {
+    return;
+  }
+  if (prefetchThread.joinable()) {
+    prefetchThread.join();
+  }
+  prefetchThread = std::thread(&WINDSGeneralData::readNetCDFData, this, stepin, std::ref(nextStep));
+}
+
+void WINDSGeneralData::readNetCDFData(int stepin, NetCDFStepBuffer &buffer)
+{
   // netCDF variables
-  std::vector<size_t> start;
   std::vector<size_t> count_cc;
   std::vector<size_t> count_fc;
 
-  start = { static_cast<unsigned long>(stepin), 0, 0, 0 };
   count_cc = { 1,
                static_cast<unsigned long>(nz - 1),
                static_cast<unsigned long>(ny - 1),
@@ -1141,43 +1226,294 @@ void WINDSGeneralData::loadNetCDFData(int stepin)
 
   // cell-center variables
   // icellflag (see .h for velues)
-  input->getVariableData("icellflag", start, count_cc, icellflag);
-  /// coefficients for SOR solver
+  buffer.icellflag.resize(numcell_cent);
+  readStepVariable("icellflag", stepin, count_cc, buffer.icellflag);
+  buffer.sameGeometry = (buffer.icellflag == icellflag_loaded);
+
+  if (!buffer.sameGeometry) {
+    buffer.e.assign(numcell_cent, 1.0);
+    buffer.f.assign(numcell_cent, 1.0);
+    buffer.g.assign(numcell_cent, 1.0);
+    buffer.h.assign(numcell_cent, 1.0);
+    buffer.m.assign(numcell_cent, 1.0);
+    buffer.n.assign(numcell_cent, 1.0);
+
+    /// coefficients for SOR solver
+    bool hasSORcoeff;
+    if (fieldCache) {
+      hasSORcoeff = fieldCache->hasVariable("e", stepin);
+    } else {
+      NcVar NcVar_SORcoeff;
+      input->getVariable("e", NcVar_SORcoeff);
+      hasSORcoeff = !NcVar_SORcoeff.isNull();
+    }
+
+    if (hasSORcoeff) {
+      readStepVariable("e", stepin, count_cc, buffer.e);
+      readStepVariable("f", stepin, count_cc, buffer.f);
+      readStepVariable("g", stepin, count_cc, buffer.g);
+      readStepVariable("h", stepin, count_cc, buffer.h);
+      readStepVariable("m", stepin, count_cc, buffer.m);
+      readStepVariable("n", stepin, count_cc, buffer.n);
+    } else {
+      std::cout << "[WINDS Data] \t no SORcoeff data found -> assumed e,f,g,h,m,n=1" << std::endl;
+    }
+  }
+
+  // face-center variables
+  if (fieldCache) {
+    // read in place by loadNetCDFData, only page them in ahead
+    fieldCache->willNeed("u", stepin);
+    fieldCache->willNeed("v", stepin);
+    fieldCache->willNeed("w", stepin);
+  } else {
+    buffer.u.resize(numcell_face);
+    buffer.v.resize(numcell_face);
+    buffer.w.resize(numcell_face);
+    readStepVariable("u", stepin, count_fc, buffer.u);
+    readStepVariable("v", stepin, count_fc, buffer.v);
+    readStepVariable("w", stepin, count_fc, buffer.w);
+  }
+
+  buffer.step = stepin;
+}
+
+void WINDSGeneralData::attachFieldCache(const std::string &cacheFile)
+{
+  // the cache maps the fields of the whole domain
+  if (nx != (int)x.size() + 1 || ny != (int)y.size() + 1) {
+    QESout::error("The field cache cannot be used with a window of the domain");
+  }
+
+  // the background reader must not switch source in the middle of a step
+  if (prefetchThread.joinable()) {
+    prefetchThread.join();
+  }
+
+  if (!FieldCache::exists(cacheFile, inputFileName)) {
+    writeFieldCache(cacheFile);
+  }
+  // the views of the previous cache (if any) are released with it
+  u_mapped = v_mapped = w_mapped = FieldView<float>();
+  delete fieldCache;
+  fieldCache = new FieldCache(cacheFile);
+}
+
+void WINDSGeneralData::writeFieldCache(const std::string &cacheFile)
+{
+  auto startTime = std::chrono::high_resolution_clock::now();
+
+  std::vector<size_t> count_cc = { 1,
+                                   static_cast<unsigned long>(nz - 1),
+                                   static_cast<unsigned long>(ny - 1),
+                                   static_cast<unsigned long>(nx - 1) };
+  std::vector<size_t> count_fc = { 1,
+                                   static_cast<unsigned long>(nz),
+                                   static_cast<unsigned long>(ny),
+                                   static_cast<unsigned long>(nx) };
+
   NcVar NcVar_SORcoeff;
   input->getVariable("e", NcVar_SORcoeff);
 
-  if (!NcVar_SORcoeff.isNull()) {
-    input->getVariableData("e", start, count_cc, e);
-    input->getVariableData("f", start, count_cc, f);
-    input->getVariableData("g", start, count_cc, g);
-    input->getVariableData("h", start, count_cc, h);
-    input->getVariableData("m", start, count_cc, m);
-    input->getVariableData("n", start, count_cc, n);
-  } else {
-    std::cout << "[WINDS Data] \t no SORcoeff data found -> assumed e,f,g,h,m,n=1" << std::endl;
+  std::vector<int> cellVar_int(numcell_cent);
+  std::vector<float> cellVar(numcell_cent);
+  std::vector<float> faceVar(numcell_face);
+
+  FieldCacheWriter writer(cacheFile);
+  for (int k = 0; k < nt; ++k) {
+    std::vector<size_t> start = { static_cast<unsigned long>(k), 0, 0, 0 };
+
+    input->getVariableData("icellflag", start, count_cc, cellVar_int);
+    writer.addVariable("icellflag", k, cellVar_int);
+
+    if (!NcVar_SORcoeff.isNull()) {
+      for (const auto &name : { "e", "f", "g", "h", "m", "n" }) {
+        input->getVariableData(name, start, count_cc, cellVar);
+        writer.addVariable(name, k, cellVar);
+      }
+    }
+
+    for (const auto &name : { "u", "v", "w" }) {
+      input->getVariableData(name, start, count_fc, faceVar);
+      writer.addVariable(name, k, faceVar);
+    }
   }
+  writer.close();
 
-  // face-center variables
-  input->getVariableData("u", start, count_fc, u);
-  input->getVariableData("v", start, count_fc, v);
-  input->getVariableData("w", start, count_fc, w);
+  auto endTime = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> elapsed = endTime - startTime;
+  std::cout << "[WINDS Data] \t Field cache written (" << nt << " steps) in "
+            << elapsed.count() << " s" << std::endl;
+}
 
-  // clear wall indices container (guarantee entry vector)
-  wall_right_indices.clear();
-  wall_left_indices.clear();
-  wall_above_indices.clear();
-  wall_below_indices.clear();
-  wall_front_indices.clear();
-  wall_back_indices.clear();
+// size and modification time of an input file, to key the caches on
+static std::string fileStamp(const std::string &fileName)
+{
+  struct stat st;
+  if (fileName.empty() || stat(fileName.c_str(), &st) != 0) {
+    return "-";
+  }
+  return std::to_string(st.st_size) + ":" + std::to_string(st.st_mtime);
+}
 
-  // define new wall indices container for new data
-  wall->defineWalls(this);
+std::string WINDSGeneralData::domainCacheFileName(const WINDSInputData *WID) const
+{
+  if (WID->simParams->domainCache.empty()) {
+    return "";
+  }
+  // coefficients read from file and canopies (which keep their own per-cell
+  // state) are not covered by the cache
+  if (WID->simParams->readCoefficientsFlag == 1 || WID->vegetationParams) {
+    std::cout << "[QES-WINDS]\t Preprocessed-domain cache not used with vegetation or readCoefficientsFlag" << std::endl;
+    return "";
+  }
 
+  // everything the preprocessing depends on: grid, terrain and buildings
+  std::ostringstream key;
+  key.precision(9);
+  key << "layout 1 " << nx << " " << ny << " " << nz << " " << dx << " " << dy;
+  for (auto dz : dz_array) {
+    key << " " << dz;
+  }
+  key << " " << WID->simParams->meshTypeFlag << " " << WID->simParams->halo_x << " " << WID->simParams->halo_y
+      << " " << WID->simParams->originFlag << " " << WID->simParams->UTMx << " " << WID->simParams->UTMy
+      << " " << WID->simParams->DEMDistancex << " " << WID->simParams->DEMDistancey
+      << " " << WID->simParams->demFile << " " << fileStamp(WID->simParams->demFile);
+  if (WID->simParams->m_domIType == SimulationParameters::WRFOnly) {
+    // terrain from the WRF fire mesh
+    key << " " << WID->simParams->wrfFile << " " << fileStamp(WID->simParams->wrfFile);
+  }
 
-  return;
+  // building footprints and heights (before the halo is added)
+  size_t buildingHash = 0;
+  auto combine = [&buildingHash](float value) {
+    buildingHash ^= std::hash<float>()(value) + 0x9e3779b9 + (buildingHash << 6) + (buildingHash >> 2);
+  };
+  if (WID->buildingsParams) {
+    key << " " << WID->buildingsParams->heightFactor;
+    if (WID->buildingsParams->SHPData) {
+      const auto &polygons = WID->buildingsParams->SHPData->m_polygons;
+      const auto &heights = WID->buildingsParams->SHPData->m_features[WID->buildingsParams->shpHeightField];
+      key << " shp " << polygons.size();
+      for (size_t pIdx = 0; pIdx < polygons.size(); pIdx++) {
+        for (const auto &vertex : polygons[pIdx]) {
+          combine(vertex.x_poly);
+          combine(vertex.y_poly);
+        }
+        combine(heights[pIdx]);
+      }
+    }
+    key << " xml " << WID->buildingsParams->buildings.size();
+    for (const auto &building : WID->buildingsParams->buildings) {
+      for (const auto &vertex : building->polygonVertices) {
+        combine(vertex.x_poly);
+        combine(vertex.y_poly);
+      }
+      combine(building->H);
+      combine(building->base_height);
+    }
+  }
+  key << " " << buildingHash;
+
+  std::ostringstream cacheFile;
+  cacheFile << WID->simParams->domainCache << "/qesDomain_" << std::hex << std::hash<std::string>()(key.str()) << ".fcache";
+  return cacheFile.str();
+}
+
+void WINDSGeneralData::saveDomainCache(const std::string &cacheFile) const
+{
+  // skip the cache if its folder is not writable
+  std::string folder = cacheFile.substr(0, cacheFile.find_last_of('/') + 1);
+  if (access(folder.c_str(), W_OK) != 0) {
+    std::cout << "[QES-WINDS]\t Cannot write the preprocessed-domain cache " << cacheFile << std::endl;
+    return;
+  }
+
+  auto startTime = std::chrono::high_resolution_clock::now();
+
+  FieldCacheWriter writer(cacheFile);
+  writer.addVariable("icellflag", 0, icellflag);
+  writer.addVariable("icellflag_footprint", 0, icellflag_footprint);
+  writer.addVariable("ibuilding_flag", 0, ibuilding_flag);
+  writer.addVariable("e", 0, e);
+  writer.addVariable("f", 0, f);
+  writer.addVariable("g", 0, g);
+  writer.addVariable("h", 0, h);
+  writer.addVariable("m", 0, m);
+  writer.addVariable("n", 0, n);
+  writer.addVariable("building_volume_frac", 0, building_volume_frac);
+  writer.addVariable("terrain_volume_frac", 0, terrain_volume_frac);
+
+  writer.addVariable("wall_right_indices", 0, wall_right_indices);
+  writer.addVariable("wall_left_indices", 0, wall_left_indices);
+  writer.addVariable("wall_above_indices", 0, wall_above_indices);
+  writer.addVariable("wall_below_indices", 0, wall_below_indices);
+  writer.addVariable("wall_back_indices", 0, wall_back_indices);
+  writer.addVariable("wall_front_indices", 0, wall_front_indices);
+  writer.addVariable("wall_indices", 0, wall_indices);
+
+  // sparse cut-cell geometry, one entry per stored cell
+  size_t nCut = cutCellGeometry.size();
+  std::vector<float> geometry(7 * nCut);
+  for (size_t c = 0; c < nCut; c++) {
+    const CutCellGeometry::Cell &cell = cutCellGeometry.cells()[c];
+    float values[7] = { cell.ni, cell.nj, cell.nk, cell.ti, cell.tj, cell.tk, cell.wall_distance };
+    std::copy(values, values + 7, geometry.begin() + 7 * c);
+  }
+  writer.addVariable("cut_id", 0, cutCellGeometry.ids());
+  writer.addVariable("cut_geometry", 0, geometry);
+  writer.close();
+
+  auto endTime = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> elapsed = endTime - startTime;
+  std::cout << "[QES-WINDS]\t Preprocessed domain cached in " << cacheFile
+            << " (" << elapsed.count() << " s)" << std::endl;
+}
+
+void WINDSGeneralData::loadDomainCache(const std::string &cacheFile)
+{
+  FieldCache cache(cacheFile);
+  cache.getVariableData("icellflag", 0, icellflag);
+  cache.getVariableData("icellflag_footprint", 0, icellflag_footprint);
+  cache.getVariableData("ibuilding_flag", 0, ibuilding_flag);
+  cache.getVariableData("e", 0, e);
+  cache.getVariableData("f", 0, f);
+  cache.getVariableData("g", 0, g);
+  cache.getVariableData("h", 0, h);
+  cache.getVariableData("m", 0, m);
+  cache.getVariableData("n", 0, n);
+  cache.getVariableData("building_volume_frac", 0, building_volume_frac);
+  cache.getVariableData("terrain_volume_frac", 0, terrain_volume_frac);
+
+  cache.getVariableData("wall_right_indices", 0, wall_right_indices);
+  cache.getVariableData("wall_left_indices", 0, wall_left_indices);
+  cache.getVariableData("wall_above_indices", 0, wall_above_indices);
+  cache.getVariableData("wall_below_indices", 0, wall_below_indices);
+  cache.getVariableData("wall_back_indices", 0, wall_back_indices);
+  cache.getVariableData("wall_front_indices", 0, wall_front_indices);
+  cache.getVariableData("wall_indices", 0, wall_indices);
+
+  std::vector<int> cut_id;
+  std::vector<float> geometry;
+  cache.getVariableData("cut_id", 0, cut_id);
+  cache.getVariableData("cut_geometry", 0, geometry);
+  cutCellGeometry.clear();
+  cutCellGeometry.reserve(cut_id.size());
+  for (size_t c = 0; c < cut_id.size(); c++) {
+    CutCellGeometry::Cell &cell = cutCellGeometry[cut_id[c]];
+    cell.ni = geometry[7 * c];
+    cell.nj = geometry[7 * c + 1];
+    cell.nk = geometry[7 * c + 2];
+    cell.ti = geometry[7 * c + 3];
+    cell.tj = geometry[7 * c + 4];
+    cell.tk = geometry[7 * c + 5];
+    cell.wall_distance = geometry[7 * c + 6];
+  }
 }
+
 void WINDSGeneralData::applyWindProfile(const WINDSInputData *WID, int timeIndex, int solveType)
 {
+  QESprofile::Scope profile("wind_profile");
   std::cout << "[QES-WINDS]\t Applying Wind Profile...\n";
 
   u0.clear();
@@ -1263,6 +1599,7 @@ void WINDSGeneralData::applyWindProfile(const WINDSInputData *WID, int timeIndex
 
 void WINDSGeneralData::applyParametrizations(const WINDSInputData *WID)
 {
+  QESprofile::Scope profile("parametrizations");
 
   auto start_param = std::chrono::high_resolution_clock::now();// Start recording execution time
   std::cout << "[QES-WINDS]\t Applying parameterizations...\n";
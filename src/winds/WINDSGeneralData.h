@@ -35,6 +35,8 @@
 #include <vector>
 #include <netcdf>
 #include <cmath>
+#include <thread>
+#include <cstdint>
 
 
 #define _USE_MATH_DEFINES
@@ -59,10 +61,13 @@
 
 #include "DTEHeightField.h"
 #include "CutCell.h"
+#include "CutCellGeometry.h"
 #include "Wall.h"
 
 // #include "util/Mesh.h"
 #include "util/NetCDFInput.h"
+#include "util/FieldCache.h"
+#include "util/FieldView.h"
 #include "util/QEStime.h"
 
 #ifdef HAS_OPTIX
@@ -84,9 +89,21 @@ public:
   WINDSGeneralData()
   {}
   WINDSGeneralData(const WINDSInputData *WID, int solverType);
-  WINDSGeneralData(const std::string inputFile);
+  /**
+   * Loads the fields of a QES-Winds file, on the whole domain or on a
+   * horizontal window of it.
+   *
+   * @param inputFile QES-Winds file
+   * @param window cells [i0,i1) x [j0,j1) of the window given as {i0, i1, j0, j1} (whole domain if empty)
+   */
+  WINDSGeneralData(const std::string inputFile, const std::vector<int> &window = {});
   virtual ~WINDSGeneralData()
-  {}
+  {
+    if (prefetchThread.joinable()) {
+      prefetchThread.join();
+    }
+    delete fieldCache;
+  }
 
   void mergeSort(std::vector<float> &effective_height,
                  std::vector<int> &building_id);
@@ -125,6 +142,32 @@ public:
    */
   void save();
   void loadNetCDFData(int);
+  /**
+   * Starts reading the fields of a given step of the QES-Winds file on a
+   * background thread. The next call to loadNetCDFData with the same step
+   * only swaps the buffers instead of reading the file.
+   *
+   * @param stepin index of the time step to read ahead
+   */
+  void prefetchNetCDFData(int);
+  /**
+   * Reads the time-dependent fields from a memory-mapped field cache instead
+   * of the NetCDF file. The cache is created from the NetCDF file first if it
+   * does not exist or is older than the file.
+   *
+   * @param cacheFile path of the field cache
+   */
+  void attachFieldCache(const std::string &);
+
+  /**
+   * Path of the preprocessed-domain cache for the geometry inputs of WID
+   * (grid, terrain, buildings), empty if the cache is not used.
+   *
+   * @param WID :document this:
+   */
+  std::string domainCacheFileName(const WINDSInputData *WID) const;
+  std::string domainCacheFile; /**< preprocessed-domain cache of this domain (empty = no cache) */
+  bool domainCacheHit = false; /**< the preprocessing is restored from domainCacheFile */
 
   ////////////////////////////////////////////////////////////////////////////
   //////// Variables and constants needed only in other functions-- Behnam
@@ -146,6 +189,14 @@ public:
   int nx, ny, nz;
   ///@}
   ///@{
+  /**
+   * First cell (x and y) of the window of the domain held by this instance,
+   * 0 for the whole domain. With a window, nx, ny and the fields only cover
+   * the window while x and y cover the whole domain.
+   */
+  int windowI0 = 0, windowJ0 = 0;
+  ///@}
+  ///@{
   /** Grid resolution */
   float dx, dy, dz;
   ///@}
@@ -213,16 +264,10 @@ public:
   std::vector<float> building_volume_frac, terrain_volume_frac;
   ///@}
 
-  ///@{
-  /** Normal components of the cut surface for the solid elements (Building or Terrain) */
-  std::vector<float> ni, nj, nk;
-  ///@}
-  ///@{
-  /** Tangential components of the cut surface for the solid elements (Building or Terrain) */
-  std::vector<float> ti, tj, tk;
-  ///@}
-  std::vector<float> wall_distance; /**< :Distance of the cell center from the cut face: */
-  std::vector<int> center_id; /**< :Defines whether a cell center is inside a solid (0) or air (1): */
+  /** Normal and tangential components of the cut surface and distance of the cell
+      center from the cut face, for the solid elements (Building or Terrain) */
+  CutCellGeometry cutCellGeometry;
+  std::vector<uint8_t> center_id; /**< :Defines whether a cell center is inside a solid (0) or air (1): */
   std::vector<float> terrain; /**< :document this: */
   std::vector<int> terrain_id;
   std::vector<int> terrain_face_id; /**< Sensor function (inputWindProfile) */
@@ -241,9 +286,19 @@ public:
   std::vector<float> u, v, w;
   ///@}
 
+  ///@{
+  /**
+   * Read-only views of the final velocity field. With a field cache attached,
+   * they point into its mapping and u, v and w are left empty.
+   */
+  FieldView<float> uView() const { return u_mapped.empty() ? FieldView<float>(u) : u_mapped; }
+  FieldView<float> vView() const { return v_mapped.empty() ? FieldView<float>(v) : v_mapped; }
+  FieldView<float> wView() const { return w_mapped.empty() ? FieldView<float>(w) : w_mapped; }
+  ///@}
+
   // local Mixing class and data
   LocalMixing *localMixing; /**< :document this: */
-  std::vector<double> mixingLengths; /**< :document this: */
+  std::vector<float> mixingLengths; /**< :document this: */
 
   // Sensor* sensor;      may not need this now
 
@@ -305,6 +360,46 @@ public:
 private:
   // input: store here for multiple time instance.
   NetCDFInput *input; /**< :document this: */
+  std::string inputFileName; /**< path of the QES-Winds file */
+
+  /**
+   * Time-dependent fields of one step of the QES-Winds file (back buffer).
+   */
+  struct NetCDFStepBuffer
+  {
+    int step = -1;
+    bool sameGeometry = false; /**< icellflag identical to the one currently loaded */
+    std::vector<int> icellflag;
+    std::vector<float> e, f, g, h, m, n;
+    std::vector<float> u, v, w;
+  };
+  NetCDFStepBuffer nextStep; /**< back buffer filled by prefetchNetCDFData */
+  std::thread prefetchThread; /**< background reader of the back buffer */
+  std::vector<int> icellflag_loaded; /**< icellflag as read from file (before defineWalls) */
+
+  FieldCache *fieldCache = nullptr; /**< read-only mapped fields (optional) */
+  FieldView<float> u_mapped, v_mapped, w_mapped; /**< velocity of the loaded step in the field cache (empty without cache) */
+
+  void readNetCDFData(int, NetCDFStepBuffer &);
+  void writeFieldCache(const std::string &);
+
+  void saveDomainCache(const std::string &) const;
+  void loadDomainCache(const std::string &);
+
+  /**
+   * Reads one time-dependent field from the field cache if attached, from
+   * the NetCDF file otherwise (window of the domain only).
+   */
+  template<typename T>
+  void readStepVariable(const std::string &name, const int &step, const std::vector<size_t> &count, std::vector<T> &data)
+  {
+    if (fieldCache) {
+      fieldCache->getVariableData(name, step, data);
+    } else {
+      std::vector<size_t> start = { static_cast<unsigned long>(step), 0, static_cast<unsigned long>(windowJ0), static_cast<unsigned long>(windowI0) };
+      input->getVariableData(name, start, count, data);
+    }
+  }
 
 protected:
   void defineHorizontalGrid();
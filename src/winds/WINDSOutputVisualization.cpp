@@ -133,10 +133,80 @@ WINDSOutputVisualization::WINDSOutputVisualization(WINDSGeneralData *WGD, WINDSI
   createAttVector("icell", "icell flag value", "--", dim_vect_3d, &icellflag_out);
   createAttVector("icellInitial", "icell flag value", "--", dim_vect_3d, &icellflag2_out);
 
+  // reduced outputs: terrain-following slices, cross-sections and decimated volume
+  VisualizationSlices *slices = WID->fileOptions->visuSlices;
+  if (slices) {
+    m_slicer = new OutputSlicer(slices, m_WGD);
+
+    if (!slices->fullVolume) {
+      std::vector<std::string> fullFields = { "u", "v", "w", "mag", "icell", "icellInitial" };
+      output_fields.erase(std::remove_if(output_fields.begin(), output_fields.end(),
+                                         [&](const std::string &field) {
+                                           return std::find(fullFields.begin(), fullFields.end(), field) != fullFields.end();
+                                         }),
+                          output_fields.end());
+    }
+
+    if (!slices->sliceHeights.empty()) {
+      sliceHeight_out = slices->sliceHeights;
+      NcDim NcDim_slice = addDimension("zSlice", sliceHeight_out.size());
+      createAttVector("zSlice", "height of the slice above the terrain", "m", { NcDim_slice }, &sliceHeight_out);
+      output_fields.push_back("zSlice");
+      addReducedOutput("hslice", { NcDim_t, NcDim_slice, NcDim_y, NcDim_x }, hSlice_out);
+    }
+    if (!slices->xSections.empty()) {
+      xSection_pos = slices->xSections;
+      NcDim NcDim_sec = addDimension("xSection", xSection_pos.size());
+      createAttVector("xSection", "x-position of the cross-section", "m", { NcDim_sec }, &xSection_pos);
+      output_fields.push_back("xSection");
+      addReducedOutput("xsec", { NcDim_t, NcDim_sec, NcDim_z, NcDim_y }, xSection_out);
+    }
+    if (!slices->ySections.empty()) {
+      ySection_pos = slices->ySections;
+      NcDim NcDim_sec = addDimension("ySection", ySection_pos.size());
+      createAttVector("ySection", "y-position of the cross-section", "m", { NcDim_sec }, &ySection_pos);
+      output_fields.push_back("ySection");
+      addReducedOutput("ysec", { NcDim_t, NcDim_sec, NcDim_z, NcDim_x }, ySection_out);
+    }
+    if (slices->stride > 0) {
+      NcDim NcDim_xc = addDimension("xCoarse", m_slicer->xCoarse.size());
+      NcDim NcDim_yc = addDimension("yCoarse", m_slicer->yCoarse.size());
+      NcDim NcDim_zc = addDimension("zCoarse", m_slicer->zCoarse.size());
+      createAttVector("xCoarse", "x-distance (decimated)", "m", { NcDim_xc }, &(m_slicer->xCoarse));
+      createAttVector("yCoarse", "y-distance (decimated)", "m", { NcDim_yc }, &(m_slicer->yCoarse));
+      createAttVector("zCoarse", "z-distance (decimated)", "m", { NcDim_zc }, &(m_slicer->zCoarse));
+      output_fields.insert(output_fields.end(), { "xCoarse", "yCoarse", "zCoarse" });
+      addReducedOutput("coarse", { NcDim_t, NcDim_zc, NcDim_yc, NcDim_xc }, coarse_out);
+    }
+  }
+
   // create output fields
   addOutputFields();
 }
 
+void WINDSOutputVisualization::addReducedOutput(const std::string &suffix, const std::vector<NcDim> &dims, ReducedFields &fields)
+{
+  createAttVector("u_" + suffix, "x-component velocity", "m s-1", dims, &fields.u);
+  createAttVector("v_" + suffix, "y-component velocity", "m s-1", dims, &fields.v);
+  createAttVector("w_" + suffix, "z-component velocity", "m s-1", dims, &fields.w);
+  createAttVector("mag_" + suffix, "velocity magnitude", "m s-1", dims, &fields.mag);
+  createAttVector("icell_" + suffix, "icell flag value", "--", dims, &fields.icell);
+
+  for (const auto &field : { "u_", "v_", "w_", "mag_", "icell_" }) {
+    output_fields.push_back(field + suffix);
+  }
+}
+
+void WINDSOutputVisualization::extractReducedOutput(const std::vector<OutputSlicer::Sample> &samples, ReducedFields &fields)
+{
+  // the visualization fields start at the first layer above the ground (k = 1)
+  m_slicer->extract(samples, u_out, 1, fields.u);
+  m_slicer->extract(samples, v_out, 1, fields.v);
+  m_slicer->extract(samples, w_out, 1, fields.w);
+  m_slicer->extract(samples, mag_out, 1, fields.mag);
+  m_slicer->extract(samples, icellflag_out, 1, fields.icell);
+}
+
 void WINDSOutputVisualization::setAllOutputFields()
 {
   all_output_fields.clear();
@@ -165,6 +235,7 @@ void WINDSOutputVisualization::save(QEStime timeOut)
   timeCurrent = timeOut;
 
   // get cell-centered values
+#pragma omp parallel for default(none) shared(nx, ny, nz)
   for (auto k = 1; k < nz - 1; k++) {
     for (auto j = 0; j < ny - 1; j++) {
       for (auto i = 0; i < nx - 1; i++) {
@@ -183,6 +254,14 @@ void WINDSOutputVisualization::save(QEStime timeOut)
     }
   }
 
+  // sample the reduced outputs
+  if (m_slicer) {
+    extractReducedOutput(m_slicer->hSlice, hSlice_out);
+    extractReducedOutput(m_slicer->xSection, xSection_out);
+    extractReducedOutput(m_slicer->ySection, ySection_out);
+    extractReducedOutput(m_slicer->coarse, coarse_out);
+  }
+
   // save the fields to NetCDF files
   saveOutputFields();
 };
@@ -38,6 +38,7 @@
 
 #include "WINDSGeneralData.h"
 #include "WINDSInputData.h"
+#include "OutputSlicer.h"
 #include "util/QESNetCDFOutput.h"
 #include "util/QEStime.h"
 
@@ -54,7 +55,9 @@ private:
 public:
   WINDSOutputVisualization(WINDSGeneralData *, WINDSInputData *, std::string);
   ~WINDSOutputVisualization()
-  {}
+  {
+    delete m_slicer;
+  }
 
   /**
    * :document this:
@@ -68,6 +71,25 @@ protected:
   void setAllOutputFields();
 
 private:
+  /**
+   * Fields on a reduced output (horizontal slices, cross-sections or decimated volume).
+   */
+  struct ReducedFields
+  {
+    std::vector<float> u, v, w, mag;
+    std::vector<int> icell;
+  };
+
+  /**
+   * Creates the variables <field>_<suffix> of a reduced output and adds them to the output fields.
+   */
+  void addReducedOutput(const std::string &, const std::vector<NcDim> &, ReducedFields &);
+
+  /**
+   * Samples the cell-centered fields on a reduced output.
+   */
+  void extractReducedOutput(const std::vector<OutputSlicer::Sample> &, ReducedFields &);
+
   ///@{
   /** :document this: */
   std::vector<float> x_out, y_out, z_out;
@@ -83,5 +105,13 @@ private:
   std::vector<float> u_out, v_out, w_out, mag_out;
   ///@}
 
+  ///@{
+  /** Reduced outputs (only allocated if requested in the fileOptions) */
+  ReducedFields hSlice_out, xSection_out, ySection_out, coarse_out;
+  std::vector<float> sliceHeight_out, xSection_pos, ySection_pos;
+  ///@}
+
+  OutputSlicer *m_slicer = nullptr; /**< Sampling of the reduced outputs (nullptr -> full volume only) */
+
   WINDSGeneralData *m_WGD; /**< :document this: */
 };
@@ -17,6 +17,8 @@
 
 #include <fstream>
 #include <cmath>
+#include <chrono>
+#include <algorithm>
 
 #include "WRFInput.h"
 
@@ -358,19 +360,12 @@ WRFInput::WRFInput(const std::string &filename,
   wrfInputFile.getVar("FRAME0_FMW").getVar(fmw_StartIdx, fmw_counts, &wrfFRAME0_FMW);
 
   if (m_performWRFRunCoupling) {
+    wrfWatcher = new FileWatcher(m_WRFFilename);
 
     // Wait for WRF to start the coupling...
-    while (wrfFRAME0_FMW != 1) {
+    if (wrfFRAME0_FMW != 1) {
       std::cout << "Waiting for FRAME0_FMW to be initialized to 1 before starting the coupling with WRF..." << std::endl;
-
-      // close file
-      wrfInputFile.close();
-
-      usleep(2000000);// 2 sec
-
-      // re-open
-      wrfInputFile.open(m_WRFFilename, NcFile::write);
-      wrfInputFile.getVar("FRAME0_FMW").getVar(fmw_StartIdx, fmw_counts, &wrfFRAME0_FMW);
+      wrfFRAME0_FMW = waitForWRFFrame(1, fmwTimeSize - 10, 0.0);
     }
 
     std::cout << "WRF-QES Coupling: Received starting frame count = " << wrfFRAME0_FMW << std::endl;
@@ -477,17 +472,21 @@ WRFInput::WRFInput(const std::string &filename,
                                    static_cast<unsigned long>(fm_ny),
                                    static_cast<unsigned long>(fm_nx) };
 
-    std::vector<double> fxlong(fm_nx * fm_ny);
-    std::vector<double> fxlat(fm_nx * fm_ny);
-    wrfInputFile.getVar("FXLONG").getVar(startIdx, counts, fxlong.data());
-    wrfInputFile.getVar("FXLAT").getVar(startIdx, counts, fxlat.data());
+    // only the corners of the fire mesh are used for the geo-referencing
+    // (LL, LR, UL, UR)
+    double fxlong[4], fxlat[4];
+    const int cornerX[4] = { 0, fm_nx - 1, 0, fm_nx - 1 };
+    const int cornerY[4] = { 0, 0, fm_ny - 1, fm_ny - 1 };
+    for (int c = 0; c < 4; c++) {
+      std::vector<size_t> cornerIdx = { 0, static_cast<size_t>(cornerY[c]), static_cast<size_t>(cornerX[c]) };
+      wrfInputFile.getVar("FXLONG").getVar(cornerIdx, &fxlong[c]);
+      wrfInputFile.getVar("FXLAT").getVar(cornerIdx, &fxlat[c]);
+    }
 
-    std::cout << "\treading data for FWH, FZ0, and ZSF..." << std::endl;
+    std::cout << "\treading data for FWH and ZSF..." << std::endl;
 
     fwh.resize(fm_nx * fm_ny);
-    std::vector<double> fz0(fm_nx * fm_ny);
     wrfInputFile.getVar("FWH").getVar(startIdx, counts, fwh.data());
-    wrfInputFile.getVar("FZ0").getVar(startIdx, counts, fz0.data());
 
     fmHeight.resize(fm_nx * fm_ny);
     wrfInputFile.getVar("ZSF").getVar(startIdx, counts, fmHeight.data());
@@ -533,9 +532,9 @@ WRFInput::WRFInput(const std::string &filename,
     std::cout << "UTM Zone: " << UTMZone << std::endl;
 
     std::cout << "(Lat,Long) at Lower Left (LL) = " << fxlat[0] << ", " << fxlong[0] << std::endl;
-    std::cout << "(Lat,Long) at Lower Right (LR) = " << fxlat[fm_nx - 1] << ", " << fxlong[fm_nx - 1] << std::endl;
-    std::cout << "(Lat,Long) at Upper Left (UL) = " << fxlat[(fm_ny - 1) * fm_nx] << ", " << fxlong[(fm_ny - 1) * fm_nx] << std::endl;
-    std::cout << "(Lat,Long) at Upper Right (UR) = " << fxlat[fm_nx - 1 + (fm_ny - 1) * fm_nx] << ", " << fxlong[fm_nx - 1 + (fm_ny - 1) * fm_nx] << std::endl;
+    std::cout << "(Lat,Long) at Lower Right (LR) = " << fxlat[1] << ", " << fxlong[1] << std::endl;
+    std::cout << "(Lat,Long) at Upper Left (UL) = " << fxlat[2] << ", " << fxlong[2] << std::endl;
+    std::cout << "(Lat,Long) at Upper Right (UR) = " << fxlat[3] << ", " << fxlong[3] << std::endl;
 
 
     // variables to hold the UTM coordinates of the corners
@@ -548,30 +547,19 @@ WRFInput::WRFInput(const std::string &filename,
     UTMConv(fxlong[0], fxlat[0], domainUTMx, domainUTMy, UTMZone, 0);
     std::cout << std::setprecision(9) << "\tConverted LL UTM: " << domainUTMx << ", " << domainUTMy << std::endl;
 
-    UTMConv(fxlong[fm_nx - 1], fxlat[fm_nx - 1], lrUTMx, lrUTMy, UTMZone, 0);
+    UTMConv(fxlong[1], fxlat[1], lrUTMx, lrUTMy, UTMZone, 0);
     std::cout << std::setprecision(9) << "\tConverted LR UTM: " << lrUTMx << ", " << lrUTMy << std::endl;
 
-    UTMConv(fxlong[(fm_ny - 1) * fm_nx], fxlat[(fm_ny - 1) * fm_nx], ulUTMx, ulUTMy, UTMZone, 0);
+    UTMConv(fxlong[2], fxlat[2], ulUTMx, ulUTMy, UTMZone, 0);
     std::cout << std::setprecision(9) << "\tConverted UL UTM: " << ulUTMx << ", " << ulUTMy << std::endl;
 
-    UTMConv(fxlong[fm_nx - 1 + (fm_ny - 1) * fm_nx], fxlat[fm_nx - 1 + (fm_ny - 1) * fm_nx], urUTMx, urUTMy, UTMZone, 0);
+    UTMConv(fxlong[3], fxlat[3], urUTMx, urUTMy, UTMZone, 0);
     std::cout << std::setprecision(9) << "\tConverted UR UTM: " << urUTMx << ", " << urUTMy << std::endl;
 
 
     dimX = fm_nx * fm_dx;
     dimY = fm_ny * fm_dy;
 
-    //
-    // Need this anymore? ???
-    std::vector<float> abyRaster(fm_nx * fm_ny);
-    for (int i = 0; i < fm_nx; i++) {
-      for (int j = 0; j < fm_ny; j++) {
-
-        int l_idx = i + j * fm_nx;
-        abyRaster[l_idx] = fmHeight[l_idx];
-        // std::cout << "height = " << fmHeight[ l_idx ] << std::endl;
-      }
-    }
     std::cout << "Done." << std::endl;
 
 #if 0
@@ -775,144 +763,6 @@ WRFInput::WRFInput(const std::string &filename,
   // Matthieu put in the Matlab code
   //
 
-  // Wind data vertical positions, stored in PHB and PH
-  //
-  // For example, 360 time series, 41 vertical, 114 x 114
-  // SUBDATASET_12_DESC=[360x41x114x114] PH (32-bit floating-point)
-  // SUBDATASET_13_NAME=NETCDF:"/scratch/Downloads/RXCwrfout_d07_2012-11-11_15-21":PHB
-  //
-  // SUBDATASET_13_DESC=[360x41x114x114] PHB (32-bit floating-point)
-  // SUBDATASET_14_NAME=NETCDF:"/scratch/Downloads/RXCwrfout_d07_2012-11-11_15-21":T
-  //
-  std::vector<size_t> atmStartIdx = { 0, 0, 0, 0 };
-  std::vector<size_t> atmCounts = { 1,
-                                    static_cast<unsigned long>(atm_nz),
-                                    static_cast<unsigned long>(atm_ny),
-                                    static_cast<unsigned long>(atm_nx) };
-
-  std::vector<double> phbData(2 * atm_nz * atm_ny * atm_nx);
-  wrfInputFile.getVar("PHB").getVar(atmStartIdx, atmCounts, phbData.data());
-
-  std::vector<double> phData(2 * atm_nz * atm_ny * atm_nx);
-  wrfInputFile.getVar("PH").getVar(atmStartIdx, atmCounts, phData.data());
-
-  std::cout << "Reading PHB and PH from Atmospheric Mesh..." << std::endl;
-
-  //
-  // Calculate the height  (PHB + PH) / 9.81
-  //
-  std::vector<double> heightData(2 * atm_nz * atm_ny * atm_nx);
-  for (int t = 0; t < 2; t++) {
-    for (int k = 0; k < atm_nz; k++) {
-      for (int j = 0; j < atm_ny; j++) {
-        for (int i = 0; i < atm_nx; i++) {
-          int l_idx = t * (atm_nz * atm_ny * atm_nx) + k * (atm_ny * atm_nx) + j * atm_nx + i;
-          heightData[l_idx] = (phbData[l_idx] + phData[l_idx]) / 9.81;
-        }
-      }
-    }
-  }
-  std::cout << "\tpressure-based height computed." << std::endl;
-
-  // calculate number of altitudes to store, which is one less than
-  // nz
-  atmCounts[1] = atm_nz - 1;
-
-  //
-  // Wind components are on staggered grid in U and V
-  //
-  // When these are read in, we will read one additional cell in X
-  // and Y, for U and V, respectively.
-
-  std::cout << "Reading U and V staggered wind input from WRF..." << std::endl;
-
-  atmCounts[3] = atm_nx + 1;
-  std::vector<double> UStaggered(2 * (atm_nz - 1) * atm_ny * (atm_nx + 1));
-  wrfInputFile.getVar("U").getVar(atmStartIdx, atmCounts, UStaggered.data());
-
-  atmCounts[2] = atm_ny + 1;
-  atmCounts[3] = atm_nx;
-  std::vector<double> VStaggered(2 * (atm_nz - 1) * (atm_ny + 1) * atm_nx);
-  wrfInputFile.getVar("V").getVar(atmStartIdx, atmCounts, VStaggered.data());
-  atmCounts[2] = atm_ny;// reset to atm_ny
-
-  // But then, U and V are on standard nx and ny atmos mesh, cell
-  // centered space
-  std::vector<double> U(2 * (atm_nz - 1) * atm_ny * atm_nx);
-  std::vector<double> V(2 * (atm_nz - 1) * atm_ny * atm_nx);
-  for (int t = 0; t < 2; t++) {
-    for (int k = 0; k < (atm_nz - 1); k++) {
-      for (int j = 0; j < atm_ny; j++) {
-        for (int i = 0; i < atm_nx; i++) {
-
-          int l_idx = t * ((atm_nz - 1) * atm_ny * atm_nx) + k * (atm_ny * atm_nx) + j * atm_nx + i;
-
-          int l_xp1_idx = t * ((atm_nz - 1) * atm_ny * atm_nx) + k * (atm_ny * atm_nx) + j * atm_nx + i + 1;
-          int l_yp1_idx = t * ((atm_nz - 1) * atm_ny * atm_nx) + k * (atm_ny * atm_nx) + (j + 1) * atm_nx + i;
-
-          U[l_idx] = 0.5 * (UStaggered[l_idx] + UStaggered[l_xp1_idx]);
-          V[l_idx] = 0.5 * (VStaggered[l_idx] + VStaggered[l_yp1_idx]);
-        }
-      }
-    }
-  }
-
-  std::cout << "\twind input complete" << std::endl;
-
-  // Calculate CoordZ
-  std::vector<double> coordZ(2 * (atm_nz - 1) * atm_ny * atm_nx);
-  for (int t = 0; t < 2; t++) {
-    for (int k = 0; k < (atm_nz - 1); k++) {
-      for (int j = 0; j < atm_ny; j++) {
-        for (int i = 0; i < atm_nx; i++) {
-          int l_idx = t * ((atm_nz - 1) * atm_ny * atm_nx) + k * (atm_ny * atm_nx) + j * atm_nx + i;
-          int l_kp1_idx = t * ((atm_nz - 1) * atm_ny * atm_nx) + (k + 1) * (atm_ny * atm_nx) + j * atm_nx + i;
-          coordZ[l_idx] = 0.5 * (heightData[l_idx] + heightData[l_kp1_idx]);
-        }
-      }
-    }
-  }
-
-
-  //
-  // wind speed sqrt(u*u + v*v);
-  //
-  std::vector<double> wsData(2 * (atm_nz - 1) * atm_ny * atm_nx);
-  for (int t = 0; t < 2; t++) {
-    for (int k = 0; k < (atm_nz - 1); k++) {
-      for (int j = 0; j < atm_ny; j++) {
-        for (int i = 0; i < atm_nx; i++) {
-          int l_idx = t * ((atm_nz - 1) * atm_ny * atm_nx) + k * (atm_ny * atm_nx) + j * atm_nx + i;
-          wsData[l_idx] = sqrt(U[l_idx] * U[l_idx] + V[l_idx] * V[l_idx]);
-        }
-      }
-    }
-  }
-
-  std::cout << "Wind speed computed." << std::endl;
-
-
-  //
-  // compute wind direction
-  //
-  std::vector<double> wdData(2 * (atm_nz - 1) * atm_ny * atm_nx);
-  for (int t = 0; t < 2; t++) {
-    for (int k = 0; k < (atm_nz - 1); k++) {
-      for (int j = 0; j < atm_ny; j++) {
-        for (int i = 0; i < atm_nx; i++) {
-          int l_idx = t * ((atm_nz - 1) * atm_ny * atm_nx) + k * (atm_ny * atm_nx) + j * atm_nx + i;
-
-          if (U[l_idx] > 0.0)
-            wdData[l_idx] = 270.0 - (180.0 / c_PI) * atan(V[l_idx] / U[l_idx]);
-          else
-            wdData[l_idx] = 90.0 - (180.0 / c_PI) * atan(V[l_idx] / U[l_idx]);
-        }
-      }
-    }
-  }
-
-  std::cout << "Wind direction computed." << std::endl;
-
   // use the Fz0 rather than LU_INDEX
 
   // read LU -- depends on if reading the restart or the output file
@@ -1119,49 +969,130 @@ WRFInput::WRFInput(const std::string &filename,
         // Pull Z0
         sd.z0 = z0Data[yIdx * atm_nx + xIdx];
 
-        sd.profiles.resize(1);// 2 time series
-
-        // Use the last time step
-        for (int t = 0; t < 1; t++) {
-
-          std::cout << "Time: " << t << std::endl;
+        sd.profiles.resize(1);
 
-          // At this X, Y, look through all heights and
-          // accumulate the heights that exist between our min
-          // and max
-          for (int k = 0; k < (atm_nz - 1); k++) {
-
-            int l_idx = t * ((atm_nz - 1) * atm_ny * atm_nx) + k * (atm_ny * atm_nx) + yIdx * atm_nx + xIdx;
+        // the profiles are filled once all the stations are known
+        m_statColumn.push_back(atm_idx);
+        m_statHgt.push_back(atm_hgt[atm_idx]);
 
+        statData.push_back(sd);
+      }
+    }
+  }
 
-            // only works for dz = 1 so will need to
-            // incorporate that...
-            // if (coordZ[l_idx] <= fm_nz) {
-            if (coordZ[l_idx] < maxWRFAlt) {
-              // if (coordZ[l_idx] >= minWRFAlt && coordZ[l_idx] <= maxWRFAlt) {
+  m_maxProfileAlt = maxWRFAlt;
+  readStationProfiles();
+}
 
-              // Use ZSF + FZ0 -- should be built into coordZ it seems
+/**
+ * The mesh window containing the station columns is read once per variable
+ * (hyperslab of the first time), in the precision of the WRF fields. The
+ * heights, speeds and directions are only derived at the stations, all the
+ * levels of all the stations being processed in parallel.
+ */
+void WRFInput::readStationProfiles()
+{
+  if (m_statColumn.empty()) {
+    return;
+  }
 
-              std::cout << "profile height at " << k << ": " << coordZ[l_idx] - atm_hgt[yIdx * atm_nx + xIdx] << "\n";
+  // window of the atmospheric mesh containing all the station columns
+  int x0 = atm_nx, x1 = -1, y0 = atm_ny, y1 = -1;
+  for (auto col : m_statColumn) {
+    x0 = std::min(x0, col % atm_nx);
+    x1 = std::max(x1, col % atm_nx);
+    y0 = std::min(y0, col / atm_nx);
+    y1 = std::max(y1, col / atm_nx);
+  }
+  const int wnx = x1 - x0 + 1;
+  const int wny = y1 - y0 + 1;
+  const int nzStag = atm_nz;
+  const int nzCell = atm_nz - 1;
 
-              profData profEl;
-              profEl.zCoord = coordZ[l_idx] - atm_hgt[yIdx * atm_nx + xIdx];
-              profEl.ws = wsData[l_idx];
-              profEl.wd = wdData[l_idx];
+  std::cout << "Reading the wind profiles of " << m_statColumn.size() << " stations (window of "
+            << wnx << " X " << wny << " columns of the atmospheric mesh)..." << std::endl;
 
-              sd.profiles[t].push_back(profEl);
-            }
-          }
-        }
+  // Wind data vertical positions, stored in PHB and PH
+  // PHB(Time, bottom_top_stag, south_north, west_east)
+  std::vector<size_t> startIdx = { 0, 0, static_cast<size_t>(y0), static_cast<size_t>(x0) };
+  std::vector<size_t> counts = { 1,
+                                 static_cast<size_t>(nzStag),
+                                 static_cast<size_t>(wny),
+                                 static_cast<size_t>(wnx) };
+  std::vector<float> phbData(nzStag * wny * wnx);
+  std::vector<float> phData(nzStag * wny * wnx);
+  wrfInputFile.getVar("PHB").getVar(startIdx, counts, phbData.data());
+  wrfInputFile.getVar("PH").getVar(startIdx, counts, phData.data());
+
+  // Wind components are on staggered grid in U and V: one additional
+  // column in X for U and one additional row in Y for V
+  counts[1] = nzCell;
+  counts[3] = wnx + 1;
+  std::vector<float> UStaggered(nzCell * wny * (wnx + 1));
+  wrfInputFile.getVar("U").getVar(startIdx, counts, UStaggered.data());
+
+  counts[2] = wny + 1;
+  counts[3] = wnx;
+  std::vector<float> VStaggered(nzCell * (wny + 1) * wnx);
+  wrfInputFile.getVar("V").getVar(startIdx, counts, VStaggered.data());
+
+  const int nStat = m_statColumn.size();
+
+  // height, speed and direction of each level of each station
+  std::vector<double> levelZ(nStat * nzCell), levelWs(nStat * nzCell), levelWd(nStat * nzCell);
+#pragma omp parallel for collapse(2) default(none) shared(phbData, phData, UStaggered, VStaggered, levelZ, levelWs, levelWd, nStat, x0, y0, wnx, wny, nzCell)
+  for (int s = 0; s < nStat; ++s) {
+    for (int k = 0; k < nzCell; k++) {
+      const int i = m_statColumn[s] % atm_nx - x0;
+      const int j = m_statColumn[s] / atm_nx - y0;
+
+      // height (PHB + PH) / 9.81 on the staggered levels, cell centered
+      int l_idx = k * (wny * wnx) + j * wnx + i;
+      int l_kp1_idx = (k + 1) * (wny * wnx) + j * wnx + i;
+      levelZ[s * nzCell + k] = 0.5 * (((double)phbData[l_idx] + (double)phData[l_idx]) / 9.81
+                                      + ((double)phbData[l_kp1_idx] + (double)phData[l_kp1_idx]) / 9.81);
+
+      // U and V on the cell centers of the atm mesh
+      int u_idx = k * (wny * (wnx + 1)) + j * (wnx + 1) + i;
+      int v_idx = k * ((wny + 1) * wnx) + j * wnx + i;
+      double U = 0.5 * ((double)UStaggered[u_idx] + (double)UStaggered[u_idx + 1]);
+      double V = 0.5 * ((double)VStaggered[v_idx] + (double)VStaggered[v_idx + wnx]);
+
+      levelWs[s * nzCell + k] = sqrt(U * U + V * V);
+      if (U > 0.0)
+        levelWd[s * nzCell + k] = 270.0 - (180.0 / c_PI) * atan(V / U);
+      else
+        levelWd[s * nzCell + k] = 90.0 - (180.0 / c_PI) * atan(V / U);
+    }
+  }
 
-        statData.push_back(sd);
+  // the profiles keep the heights below our max
+  for (int s = 0; s < nStat; ++s) {
+    std::vector<profData> &profile = statData[s].profiles[0];
+    profile.clear();
+    for (int k = 0; k < nzCell; k++) {
+      if (levelZ[s * nzCell + k] < m_maxProfileAlt) {
+        profData profEl;
+        profEl.zCoord = levelZ[s * nzCell + k] - m_statHgt[s];
+        profEl.ws = levelWs[s * nzCell + k];
+        profEl.wd = levelWd[s * nzCell + k];
+        profile.push_back(profEl);
       }
     }
   }
+
+  for (int s = 0; s < nStat; ++s) {
+    std::cout << "Station " << s << ": " << statData[s].profiles[0].size() << " profile heights";
+    if (!statData[s].profiles[0].empty()) {
+      std::cout << " from " << statData[s].profiles[0].front().zCoord << " to " << statData[s].profiles[0].back().zCoord;
+    }
+    std::cout << std::endl;
+  }
 }
 
 WRFInput::~WRFInput()
 {
+  delete wrfWatcher;
 }
 
 void WRFInput::readDomainInfo()
@@ -2237,32 +2168,13 @@ void WRFInput::updateFromWRF()
     NcDim fmwdim = wrfInputFile.getVar("U0_FMW").getDim(0);
     int fmwTimeSize = fmwdim.getSize();
 
-    std::vector<size_t> fmw_StartIdx = { static_cast<unsigned long>(fmwTimeSize - 1) };
-    std::vector<size_t> fmw_counts = { 1 };
-
-    int numWait = 0;
-    int maxWait = 20;
-
-    int wrfFRAME0_FMW = -1;
-    wrfInputFile.getVar("FRAME0_FMW").getVar(fmw_StartIdx, fmw_counts, &wrfFRAME0_FMW);
-    while (wrfFRAME0_FMW != nextWRFFrameNum && (numWait < maxWait)) {
-      std::cout << "Waiting for FRAME0_FMW to be ====> " << nextWRFFrameNum << ", received " << wrfFRAME0_FMW << std::endl;
-
-      // close file
-      wrfInputFile.close();
+    // woken up by the writes of WRF to the file (20 s at most)
+    int wrfFRAME0_FMW = waitForWRFFrame(nextWRFFrameNum, fmwTimeSize - 1, 20.0);
 
-      // wait a few seconds for now
-      usleep(1000000);
-
-      // re-open
-      wrfInputFile.open(m_WRFFilename, NcFile::write);
-      wrfInputFile.getVar("FRAME0_FMW").getVar(fmw_StartIdx, fmw_counts, &wrfFRAME0_FMW);
-
-      numWait++;
-    }
-
-    if ((numWait == maxWait) || (wrfFRAME0_FMW < 0))
+    if ((wrfFRAME0_FMW != nextWRFFrameNum) || (wrfFRAME0_FMW < 0)) {
+      std::cerr << "[ERROR] WRF-QES Coupling: timed out waiting for frame " << nextWRFFrameNum << std::endl;
       exit(EXIT_FAILURE);
+    }
 
     std::cout << "WRF-QES Coupling: Frame = " << wrfFRAME0_FMW << std::endl;
 
@@ -2331,6 +2243,47 @@ void WRFInput::updateFromWRF()
 }
 
 
+int WRFInput::waitForWRFFrame(const int &frame, const size_t &timeIdx, const double &maxWait)
+{
+  std::vector<size_t> fmw_StartIdx = { timeIdx };
+  std::vector<size_t> fmw_counts = { 1 };
+
+  // the notifications pending at this point are our own writes (extractWind),
+  // the frame is read after discarding them so no write of WRF can be missed
+  wrfWatcher->clear();
+
+  int wrfFRAME0_FMW = -1;
+  wrfInputFile.getVar("FRAME0_FMW").getVar(fmw_StartIdx, fmw_counts, &wrfFRAME0_FMW);
+
+  auto start = std::chrono::steady_clock::now();
+  while (wrfFRAME0_FMW != frame) {
+    std::chrono::duration<double> waited = std::chrono::steady_clock::now() - start;
+    if (maxWait > 0.0 && waited.count() >= maxWait) {
+      break;
+    }
+    std::cout << "Waiting for FRAME0_FMW to be ====> " << frame << ", received " << wrfFRAME0_FMW << std::endl;
+
+    // the file is still checked regularly without notification (they are not
+    // delivered on some network file systems), every second when polling
+    double timeout = wrfWatcher->isEventDriven() ? 5.0 : 1.0;
+    if (maxWait > 0.0) {
+      timeout = std::min(timeout, maxWait - waited.count());
+    }
+    wrfWatcher->wait(timeout);
+
+    // re-open to read the data written by WRF (closing the file opened for writing
+    // notifies the watcher, this notification is ours and is discarded before the
+    // frame is read)
+    wrfInputFile.close();
+    wrfInputFile.open(m_WRFFilename, NcFile::write);
+    wrfWatcher->clear();
+    wrfInputFile.getVar("FRAME0_FMW").getVar(fmw_StartIdx, fmw_counts, &wrfFRAME0_FMW);
+  }
+
+  return wrfFRAME0_FMW;
+}
+
+
 void WRFInput::extractWind(WINDSGeneralData *wgd)
 {
   // WRF fire mesh and wgd domain should be identical with the
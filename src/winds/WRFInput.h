@@ -27,6 +27,8 @@
 
 #include <string>
 #include <netcdf>
+
+#include "util/FileWatcher.h"
 using namespace std;
 using namespace netCDF;
 using namespace netCDF::exceptions;
@@ -284,6 +286,34 @@ public:
 private:
   NcFile wrfInputFile;
 
+  // notifications of the writes of WRF to the file (run coupling only)
+  FileWatcher *wrfWatcher = nullptr;
+
+  /**
+   * Waits until WRF has written the given frame number in FRAME0_FMW.
+   *
+   * The file is re-opened when WRF writes to it (or every 5 s without
+   * notification, every second if the notifications are not available).
+   *
+   * @param frame frame number expected
+   * @param timeIdx index of FRAME0_FMW read
+   * @param maxWait maximum waiting time in seconds (0 -> no limit)
+   * @return last frame number read
+   */
+  int waitForWRFFrame(const int &frame, const size_t &timeIdx, const double &maxWait);
+
+  // atmospheric mesh columns of the stations (same order as statData)
+  std::vector<int> m_statColumn;
+  // terrain height at the stations
+  std::vector<double> m_statHgt;
+  // maximum height of the profiles
+  float m_maxProfileAlt;
+
+  /**
+   * Reads the wind profiles of the stations at the first time of the WRF file.
+   */
+  void readStationProfiles();
+
   int nx, ny;
   float m_dx, m_dy;
 
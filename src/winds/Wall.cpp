@@ -37,6 +37,8 @@
  */
 #include "Wall.h"
 
+#include <algorithm>
+
 #include "WINDSGeneralData.h"
 #include "WINDSInputData.h"
 
@@ -49,6 +51,9 @@ void Wall::defineWalls(WINDSGeneralData *WGD)
   int nz = WGD->nz;
 
 
+  // Clamp the coefficients and turn the (nearly) solid cells into solid cells.
+  // Every step only touches the cell itself, so they are fused in one parallel pass.
+#pragma omp parallel for default(none) shared(WGD, nx, ny, nz)
   for (auto k = 1; k < nz - 1; k++) {
     for (auto i = 0; i < nx - 1; i++) {
       for (auto j = 0; j < ny - 1; j++) {
@@ -90,14 +95,7 @@ void Wall::defineWalls(WINDSGeneralData *WGD)
         if (WGD->n[icell_cent] > 1.0) {
           WGD->n[icell_cent] = 1.0;
         }
-      }
-    }
-  }
 
-  for (auto k = 1; k < nz - 1; k++) {
-    for (auto i = 0; i < nx - 1; i++) {
-      for (auto j = 0; j < ny - 1; j++) {
-        int icell_cent = i + j * (nx - 1) + k * (nx - 1) * (ny - 1);
         if ((WGD->icellflag[icell_cent] == 7 || WGD->icellflag[icell_cent] == 0) && WGD->building_volume_frac[icell_cent] <= 0.1) {
           WGD->icellflag[icell_cent] = 0;
           WGD->e[icell_cent] = 1.0;
@@ -107,14 +105,7 @@ void Wall::defineWalls(WINDSGeneralData *WGD)
           WGD->m[icell_cent] = 1.0;
           WGD->n[icell_cent] = 1.0;
         }
-      }
-    }
-  }
 
-  for (auto k = 1; k < nz - 1; k++) {
-    for (auto i = 0; i < nx - 1; i++) {
-      for (auto j = 0; j < ny - 1; j++) {
-        int icell_cent = i + j * (nx - 1) + k * (nx - 1) * (ny - 1);
         if (WGD->e[icell_cent] == 0.0 && WGD->f[icell_cent] == 0.0 && WGD->g[icell_cent] == 0.0
             && WGD->h[icell_cent] == 0.0 && WGD->m[icell_cent] == 0.0 && WGD->n[icell_cent] == 0.0 && WGD->icellflag[icell_cent] == 7) {
           WGD->icellflag[icell_cent] = 0;
@@ -129,6 +120,8 @@ void Wall::defineWalls(WINDSGeneralData *WGD)
     }
   }
 
+  // Matching of the coefficients with the neighbours: the cells above/below are written and
+  // the coefficients already updated by the sweep are read back, so this pass keeps its serial order
   for (auto k = 1; k < nz - 2; k++) {
     for (auto i = 0; i < nx - 1; i++) {
       for (auto j = 0; j < ny - 1; j++) {
@@ -259,6 +252,8 @@ void Wall::defineWalls(WINDSGeneralData *WGD)
     }
   }
 
+  // Cells closed on all sides become solid (local to the cell)
+#pragma omp parallel for default(none) shared(WGD, nx, ny, nz)
   for (auto k = 1; k < nz - 1; k++) {
     for (auto i = 0; i < nx - 1; i++) {
       for (auto j = 0; j < ny - 1; j++) {
@@ -291,7 +286,18 @@ void Wall::defineWalls(WINDSGeneralData *WGD)
     }
   }
 
+  // The wall indices are gathered per level in parallel, then each list is built from an
+  // exclusive prefix sum of the level counts, which keeps the k-i-j order of a serial sweep.
+  std::vector<int> *wallLists[7] = { &WGD->wall_below_indices, &WGD->wall_above_indices,
+                                     &WGD->wall_back_indices, &WGD->wall_front_indices,
+                                     &WGD->wall_right_indices, &WGD->wall_left_indices,
+                                     &WGD->wall_indices };
+  int nLevels = std::max(nz - 3, 0);
+  std::vector<std::vector<int>> levelLists(7 * nLevels);
+
+#pragma omp parallel for schedule(dynamic) default(none) shared(WGD, nx, ny, nz, levelLists)
   for (auto k = 1; k < nz - 2; k++) {
+    std::vector<int> *level = &levelLists[7 * (k - 1)];
     for (auto i = 0; i < nx - 1; i++) {
       for (auto j = 0; j < ny - 1; j++) {
         int icell_cent = i + j * (nx - 1) + k * (nx - 1) * (ny - 1);
@@ -301,14 +307,14 @@ void Wall::defineWalls(WINDSGeneralData *WGD)
           // Wall below
           if (WGD->icellflag[icell_cent - (WGD->nx - 1) * (WGD->ny - 1)] == 0 || WGD->icellflag[icell_cent - (WGD->nx - 1) * (WGD->ny - 1)] == 2) {
             if (WGD->icellflag[icell_cent] != 8) {
-              WGD->wall_below_indices.push_back(icell_face);
+              level[0].push_back(icell_face);
             }
             WGD->n[icell_cent] = 0.0;
           }
           // Wall above
           if (WGD->icellflag[icell_cent + (WGD->nx - 1) * (WGD->ny - 1)] == 0 || WGD->icellflag[icell_cent + (WGD->nx - 1) * (WGD->ny - 1)] == 2) {
             if (WGD->icellflag[icell_cent] != 8) {
-              WGD->wall_above_indices.push_back(icell_face);
+              level[1].push_back(icell_face);
             }
             WGD->m[icell_cent] = 0.0;
           }
@@ -316,7 +322,7 @@ void Wall::defineWalls(WINDSGeneralData *WGD)
           if (WGD->icellflag[icell_cent - 1] == 0 || WGD->icellflag[icell_cent - 1] == 2) {
             if (i > 0) {
               if (WGD->icellflag[icell_cent] != 8) {
-                WGD->wall_back_indices.push_back(icell_face);
+                level[2].push_back(icell_face);
               }
               WGD->f[icell_cent] = 0.0;
             }
@@ -324,7 +330,7 @@ void Wall::defineWalls(WINDSGeneralData *WGD)
           // Wall in front
           if (WGD->icellflag[icell_cent + 1] == 0 || WGD->icellflag[icell_cent + 1] == 2) {
             if (WGD->icellflag[icell_cent] != 8) {
-              WGD->wall_front_indices.push_back(icell_face);
+              level[3].push_back(icell_face);
             }
             WGD->e[icell_cent] = 0.0;
           }
@@ -332,7 +338,7 @@ void Wall::defineWalls(WINDSGeneralData *WGD)
           if (WGD->icellflag[icell_cent - (WGD->nx - 1)] == 0 || WGD->icellflag[icell_cent - (WGD->nx - 1)] == 2) {
             if (j > 0) {
               if (WGD->icellflag[icell_cent] != 8) {
-                WGD->wall_right_indices.push_back(icell_face);
+                level[4].push_back(icell_face);
               }
               WGD->h[icell_cent] = 0.0;
             }
@@ -340,18 +346,33 @@ void Wall::defineWalls(WINDSGeneralData *WGD)
           // Wall on left
           if (WGD->icellflag[icell_cent + (WGD->nx - 1)] == 0 || WGD->icellflag[icell_cent + (WGD->nx - 1)] == 2) {
             if (WGD->icellflag[icell_cent] != 8) {
-              WGD->wall_left_indices.push_back(icell_face);
+              level[5].push_back(icell_face);
             }
             WGD->g[icell_cent] = 0.0;
           }
         }
 
         if (WGD->icellflag[icell_cent] == 7 || WGD->icellflag[icell_cent] == 8) {
-          WGD->wall_indices.push_back(icell_cent);
+          level[6].push_back(icell_cent);
         }
       }
     }
   }
+
+  for (auto l = 0; l < 7; l++) {
+    // exclusive prefix sum of the level counts (after the indices already stored)
+    std::vector<size_t> offset(nLevels + 1, wallLists[l]->size());
+    for (auto k = 0; k < nLevels; k++) {
+      offset[k + 1] = offset[k] + levelLists[7 * k + l].size();
+    }
+    std::vector<int> &list = *wallLists[l];
+    list.resize(offset[nLevels]);
+
+#pragma omp parallel for default(none) shared(list, levelLists, offset, nLevels, l)
+    for (auto k = 0; k < nLevels; k++) {
+      std::copy(levelLists[7 * k + l].begin(), levelLists[7 * k + l].end(), list.begin() + offset[k]);
+    }
+  }
 }
 
 
@@ -384,9 +405,17 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
   int first_i(0), first_j(0), first_k(0);
   int second_i(0), second_j(0), second_k(0);
 
+  // every wall cell gets an entry in the sparse cut-cell geometry (insertion is serial,
+  // the parallel loops below only look the entries up)
+  for (auto i = 0u; i < WGD->wall_indices.size(); i++) {
+    WGD->cutCellGeometry[WGD->wall_indices[i]];
+  }
+
   // Loop through all the cells
+#pragma omp parallel for private(s_behind, s_front, s_right, s_left, s_below, s_above, s_cut) default(none) shared(WGD)
   for (auto i = 0u; i < WGD->wall_indices.size(); i++) {
-    if (WGD->ni[WGD->wall_indices[i]] == 0.0 && WGD->nj[WGD->wall_indices[i]] == 0.0 && WGD->nk[WGD->wall_indices[i]] == 0.0) {
+    CutCellGeometry::Cell &cutGeometry = WGD->cutCellGeometry[WGD->wall_indices[i]];
+    if (cutGeometry.ni == 0.0 && cutGeometry.nj == 0.0 && cutGeometry.nk == 0.0) {
       int k = WGD->wall_indices[i] / ((WGD->nx - 1) * (WGD->ny - 1));
       s_behind = WGD->f[WGD->wall_indices[i]] * (WGD->dy * WGD->dz_array[k]) * (WGD->dx * WGD->dx);
       s_front = WGD->e[WGD->wall_indices[i]] * (WGD->dy * WGD->dz_array[k]) * (WGD->dx * WGD->dx);
@@ -399,9 +428,9 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
                    + pow(s_below - s_above, 2.0));
       // Calculate normal to the cut surface
       if (s_cut != 0.0) {
-        WGD->ni[WGD->wall_indices[i]] = (s_front - s_behind) / s_cut;
-        WGD->nj[WGD->wall_indices[i]] = (s_left - s_right) / s_cut;
-        WGD->nk[WGD->wall_indices[i]] = (s_above - s_below) / s_cut;
+        cutGeometry.ni = (s_front - s_behind) / s_cut;
+        cutGeometry.nj = (s_left - s_right) / s_cut;
+        cutGeometry.nk = (s_above - s_below) / s_cut;
       }
     }
   }
@@ -415,7 +444,14 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
   float coeff;
   int count;
   float max_dist;
+
+  // The corrections of the cut-cells are computed independently from the velocity field
+  // before correction, then applied in the order of the wall cells
+  std::vector<int> corr_id(WGD->wall_indices.size(), -1);
+  std::vector<float> corr_u(WGD->wall_indices.size()), corr_v(WGD->wall_indices.size()), corr_w(WGD->wall_indices.size());
+
   // Loop through all the cut-cells
+#pragma omp parallel for schedule(dynamic) private(ustar_wall, new_ustar, vel_mag1, vel_mag2, dist1, dist2, first_i, first_j, first_k, second_i, second_j, second_k, z_buffer, dot_product, ut, vt, wt, un, vn, wn, first_id, second_id, vel_tan_mag, coeff, count, max_dist) default(none) shared(WGD, isInitial, corr_id, corr_u, corr_v, corr_w)
   for (auto id = 0u; id < WGD->wall_indices.size(); id++) {
     int k = WGD->wall_indices[id] / ((WGD->nx - 1) * (WGD->ny - 1));
     int j = (WGD->wall_indices[id] - k * (WGD->nx - 1) * (WGD->ny - 1)) / (WGD->nx - 1);
@@ -423,22 +459,23 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
     coeff = 1.0;
     count = 0;
     max_dist = sqrt(pow(WGD->dx, 2.0) + pow(WGD->dy, 2.0) + pow(WGD->dz_array[k], 2.0));
+    CutCellGeometry::Cell &cutGeometry = WGD->cutCellGeometry[WGD->wall_indices[id]];
 
-    if (abs(WGD->ni[WGD->wall_indices[id]]) < 0.05) {
-      WGD->ni[WGD->wall_indices[id]] = 0;
+    if (abs(cutGeometry.ni) < 0.05) {
+      cutGeometry.ni = 0;
     }
-    if (abs(WGD->nj[WGD->wall_indices[id]]) < 0.05) {
-      WGD->nj[WGD->wall_indices[id]] = 0;
+    if (abs(cutGeometry.nj) < 0.05) {
+      cutGeometry.nj = 0;
     }
-    if (abs(WGD->nk[WGD->wall_indices[id]]) < 0.05) {
-      WGD->nk[WGD->wall_indices[id]] = 0;
+    if (abs(cutGeometry.nk) < 0.05) {
+      cutGeometry.nk = 0;
     }
 
     if (WGD->center_id[WGD->wall_indices[id]] == 1) {
-      if (WGD->wall_distance[WGD->wall_indices[id]] <= WGD->z0) {
+      if (cutGeometry.wall_distance <= WGD->z0) {
         count += 1;
       } else {
-        if ((log(1 + max_dist / WGD->wall_distance[WGD->wall_indices[id]]) / log(WGD->wall_distance[WGD->wall_indices[id]] / WGD->z0)) > 1.0) {
+        if ((log(1 + max_dist / cutGeometry.wall_distance) / log(cutGeometry.wall_distance / WGD->z0)) > 1.0) {
           count += 1;
         }
       }
@@ -453,25 +490,25 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
       first_k = k;
 
 
-      if (WGD->ni[WGD->wall_indices[id]] >= 0.0) {
+      if (cutGeometry.ni >= 0.0) {
         // Finding indices for the second node location in normal to surface direction
-        second_i = std::round((WGD->x[i] - 0.001 + WGD->ni[WGD->wall_indices[id]] * coeff * WGD->dx) / WGD->dx);
+        second_i = std::round((WGD->x[i] - 0.001 + cutGeometry.ni * coeff * WGD->dx) / WGD->dx);
       } else {
         // Finding indices for the second node location in normal to surface direction
-        second_i = std::round((WGD->x[i] - 0.001 + WGD->ni[WGD->wall_indices[id]] * coeff * WGD->dx) / WGD->dx) - 1;
+        second_i = std::round((WGD->x[i] - 0.001 + cutGeometry.ni * coeff * WGD->dx) / WGD->dx) - 1;
       }
 
-      if (WGD->nj[WGD->wall_indices[id]] >= 0.0) {
+      if (cutGeometry.nj >= 0.0) {
         // Finding indices for the second node location in normal to surface direction
-        second_j = std::round((WGD->y[j] - 0.001 + WGD->nj[WGD->wall_indices[id]] * coeff * WGD->dy) / WGD->dy);
+        second_j = std::round((WGD->y[j] - 0.001 + cutGeometry.nj * coeff * WGD->dy) / WGD->dy);
       } else {
         // Finding indices for the second node location in normal to surface direction
-        second_j = std::round((WGD->y[j] - 0.001 + WGD->nj[WGD->wall_indices[id]] * coeff * WGD->dy) / WGD->dy) - 1;
+        second_j = std::round((WGD->y[j] - 0.001 + cutGeometry.nj * coeff * WGD->dy) / WGD->dy) - 1;
       }
 
 
-      if (WGD->nk[WGD->wall_indices[id]] >= 0.0) {
-        z_buffer = WGD->z[k] + WGD->nk[WGD->wall_indices[id]] * coeff * WGD->dz_array[k];
+      if (cutGeometry.nk >= 0.0) {
+        z_buffer = WGD->z[k] + cutGeometry.nk * coeff * WGD->dz_array[k];
         for (auto kk = 0u; kk < WGD->z.size() - 1; ++kk) {
           second_k = kk + 1;
           if (z_buffer <= WGD->z_face[kk + 2]) {
@@ -479,7 +516,7 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
           }
         }
       } else {
-        z_buffer = WGD->z[k] + WGD->nk[WGD->wall_indices[id]] * coeff * WGD->dz_array[k];
+        z_buffer = WGD->z[k] + cutGeometry.nk * coeff * WGD->dz_array[k];
         for (auto kk = 0u; kk < WGD->z.size() - 1; ++kk) {
           second_k = kk + 1;
           if (z_buffer <= WGD->z_face[kk + 2]) {
@@ -491,11 +528,11 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
       // Distance of the first cell center from the cut surface
       dist1 = sqrt(pow((WGD->x[first_i] - WGD->x[i]), 2.0) + pow((WGD->y[first_j] - WGD->y[j]), 2.0)
                    + pow((WGD->z[first_k] - WGD->z[k]), 2.0))
-              + WGD->wall_distance[WGD->wall_indices[id]];
+              + cutGeometry.wall_distance;
       // Distance of the second cell center from the cut surface
       dist2 = sqrt(pow((WGD->x[second_i] - WGD->x[i]), 2.0) + pow((WGD->y[second_j] - WGD->y[j]), 2.0)
                    + pow((WGD->z[second_k] - WGD->z[k]), 2.0))
-              + WGD->wall_distance[WGD->wall_indices[id]];
+              + cutGeometry.wall_distance;
     } else {
       bool condition = true;
       while (condition) {
@@ -505,39 +542,39 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
           coeff = 1.0 + count;
         }
 
-        if (WGD->ni[WGD->wall_indices[id]] >= 0.0) {
+        if (cutGeometry.ni >= 0.0) {
           // Finding index for the first node location in normal to surface direction
-          first_i = std::round((WGD->x[i] - 0.001 + WGD->ni[WGD->wall_indices[id]] * coeff * WGD->dx) / WGD->dx);
+          first_i = std::round((WGD->x[i] - 0.001 + cutGeometry.ni * coeff * WGD->dx) / WGD->dx);
           // Finding index for the second node location in normal to surface direction
-          second_i = std::round((WGD->x[i] - 0.001 + WGD->ni[WGD->wall_indices[id]] * (coeff + 1) * WGD->dx) / WGD->dx);
+          second_i = std::round((WGD->x[i] - 0.001 + cutGeometry.ni * (coeff + 1) * WGD->dx) / WGD->dx);
         } else {
           // Finding index for the first node location in normal to surface direction
-          first_i = std::round((WGD->x[i] - 0.001 + WGD->ni[WGD->wall_indices[id]] * coeff * WGD->dx) / WGD->dx) - 1;
+          first_i = std::round((WGD->x[i] - 0.001 + cutGeometry.ni * coeff * WGD->dx) / WGD->dx) - 1;
           // Finding index for the second node location in normal to surface direction
-          second_i = std::round((WGD->x[i] - 0.001 + WGD->ni[WGD->wall_indices[id]] * (coeff + 1) * WGD->dx) / WGD->dx) - 1;
+          second_i = std::round((WGD->x[i] - 0.001 + cutGeometry.ni * (coeff + 1) * WGD->dx) / WGD->dx) - 1;
         }
 
-        if (WGD->nj[WGD->wall_indices[id]] >= 0.0) {
+        if (cutGeometry.nj >= 0.0) {
           // Finding index for the first node location in normal to surface direction
-          first_j = std::round((WGD->y[j] - 0.001 + WGD->nj[WGD->wall_indices[id]] * coeff * WGD->dy) / WGD->dy);
+          first_j = std::round((WGD->y[j] - 0.001 + cutGeometry.nj * coeff * WGD->dy) / WGD->dy);
           // Finding index for the second node location in normal to surface direction
-          second_j = std::round((WGD->y[j] - 0.001 + WGD->nj[WGD->wall_indices[id]] * (coeff + 1) * WGD->dy) / WGD->dy);
+          second_j = std::round((WGD->y[j] - 0.001 + cutGeometry.nj * (coeff + 1) * WGD->dy) / WGD->dy);
         } else {
           // Finding index for the first node location in normal to surface direction
-          first_j = std::round((WGD->y[j] - 0.001 + WGD->nj[WGD->wall_indices[id]] * coeff * WGD->dy) / WGD->dy) - 1;
+          first_j = std::round((WGD->y[j] - 0.001 + cutGeometry.nj * coeff * WGD->dy) / WGD->dy) - 1;
           // Finding index for the second node location in normal to surface direction
-          second_j = std::round((WGD->y[j] - 0.001 + WGD->nj[WGD->wall_indices[id]] * (coeff + 1) * WGD->dy) / WGD->dy) - 1;
+          second_j = std::round((WGD->y[j] - 0.001 + cutGeometry.nj * (coeff + 1) * WGD->dy) / WGD->dy) - 1;
         }
 
-        if (WGD->nk[WGD->wall_indices[id]] >= 0.0) {
-          z_buffer = WGD->z[k] + WGD->nk[WGD->wall_indices[id]] * coeff * WGD->dz_array[k];
+        if (cutGeometry.nk >= 0.0) {
+          z_buffer = WGD->z[k] + cutGeometry.nk * coeff * WGD->dz_array[k];
           for (auto kk = 0u; kk < WGD->z.size(); kk++) {
             first_k = kk + 1;
             if (z_buffer <= WGD->z[kk + 1]) {
               break;
             }
           }
-          z_buffer = WGD->z[k] + WGD->nk[WGD->wall_indices[id]] * (coeff + 1) * WGD->dz_array[k];
+          z_buffer = WGD->z[k] + cutGeometry.nk * (coeff + 1) * WGD->dz_array[k];
           for (auto kk = 0u; kk < WGD->z.size() - 1; ++kk) {
             second_k = kk + 1;
             if (z_buffer <= WGD->z_face[kk + 2]) {
@@ -545,14 +582,14 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
             }
           }
         } else {
-          z_buffer = WGD->z[k] + WGD->nk[WGD->wall_indices[id]] * coeff * WGD->dz_array[k];
+          z_buffer = WGD->z[k] + cutGeometry.nk * coeff * WGD->dz_array[k];
           for (auto kk = 0u; kk < WGD->z.size() - 1; ++kk) {
             first_k = kk + 1;
             if (z_buffer <= WGD->z_face[kk + 2]) {
               break;
             }
           }
-          z_buffer = WGD->z[k] + WGD->nk[WGD->wall_indices[id]] * (coeff + 1) * WGD->dz_array[k];
+          z_buffer = WGD->z[k] + cutGeometry.nk * (coeff + 1) * WGD->dz_array[k];
           for (auto kk = 0u; kk < WGD->z.size(); kk++) {
             second_k = kk - 1;
             if (z_buffer <= WGD->z[kk]) {
@@ -568,11 +605,11 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
         // Distance of the first cell center from the cut surface
         dist1 = sqrt(pow((WGD->x[first_i] - WGD->x[i]), 2.0) + pow((WGD->y[first_j] - WGD->y[j]), 2.0)
                      + pow((WGD->z[first_k] - WGD->z[k]), 2.0))
-                + WGD->wall_distance[WGD->wall_indices[id]];
+                + cutGeometry.wall_distance;
         // Distance of the second cell center from the cut surface
         dist2 = sqrt(pow((WGD->x[second_i] - WGD->x[i]), 2.0) + pow((WGD->y[second_j] - WGD->y[j]), 2.0)
                      + pow((WGD->z[second_k] - WGD->z[k]), 2.0))
-                + WGD->wall_distance[WGD->wall_indices[id]];
+                + cutGeometry.wall_distance;
 
         if (((log(dist2 / dist1) / log(dist1 / WGD->z0)) <= 1.0) && dist1 > WGD->z0) {
           condition = false;
@@ -593,18 +630,18 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
 
     if (isInitial == true) {
       // Velocity magnitude in normal direction (U.N = u0*ni+v0*nj+w0*nk)
-      dot_product = WGD->u0[first_id] * WGD->ni[WGD->wall_indices[id]] + WGD->v0[first_id] * WGD->nj[WGD->wall_indices[id]]
-                    + WGD->w0[first_id] * WGD->nk[WGD->wall_indices[id]];
+      dot_product = WGD->u0[first_id] * cutGeometry.ni + WGD->v0[first_id] * cutGeometry.nj
+                    + WGD->w0[first_id] * cutGeometry.nk;
     } else {
       // Velocity magnitude in normal direction (U.N = u0*ni+v0*nj+w0*nk)
-      dot_product = WGD->u[first_id] * WGD->ni[WGD->wall_indices[id]] + WGD->v[first_id] * WGD->nj[WGD->wall_indices[id]]
-                    + WGD->w[first_id] * WGD->nk[WGD->wall_indices[id]];
+      dot_product = WGD->u[first_id] * cutGeometry.ni + WGD->v[first_id] * cutGeometry.nj
+                    + WGD->w[first_id] * cutGeometry.nk;
     }
 
     // Velocity components in normal direction
-    un = dot_product * WGD->ni[WGD->wall_indices[id]];
-    vn = dot_product * WGD->nj[WGD->wall_indices[id]];
-    wn = dot_product * WGD->nk[WGD->wall_indices[id]];
+    un = dot_product * cutGeometry.ni;
+    vn = dot_product * cutGeometry.nj;
+    wn = dot_product * cutGeometry.nk;
 
     if (isInitial == true) {
       // Velocity components in tangential direction (Ut = U-Un)
@@ -622,9 +659,9 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
     vel_tan_mag = sqrt(pow(ut, 2.0) + pow(vt, 2.0) + pow(wt, 2.0));
     // Calculating tangential unit vectors
     if (vel_tan_mag != 0.0) {
-      WGD->ti[WGD->wall_indices[id]] = ut / vel_tan_mag;
-      WGD->tj[WGD->wall_indices[id]] = vt / vel_tan_mag;
-      WGD->tk[WGD->wall_indices[id]] = wt / vel_tan_mag;
+      cutGeometry.ti = ut / vel_tan_mag;
+      cutGeometry.tj = vt / vel_tan_mag;
+      cutGeometry.tk = wt / vel_tan_mag;
     }
 
 
@@ -632,12 +669,12 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
     second_id = second_i + second_j * WGD->nx + second_k * WGD->nx * WGD->ny;
     if (isInitial == true) {
       // Velocity magnitude in tangential direction (U.T = u0*ti+v0*tj+w0*tk)
-      vel_mag2 = abs(WGD->u0[second_id] * WGD->ti[WGD->wall_indices[id]] + WGD->v0[second_id] * WGD->tj[WGD->wall_indices[id]]
-                     + WGD->w0[second_id] * WGD->tk[WGD->wall_indices[id]]);
+      vel_mag2 = abs(WGD->u0[second_id] * cutGeometry.ti + WGD->v0[second_id] * cutGeometry.tj
+                     + WGD->w0[second_id] * cutGeometry.tk);
     } else {
       // Velocity magnitude in tangential direction (U.T = u0*ti+v0*tj+w0*tk)
-      vel_mag2 = abs(WGD->u[second_id] * WGD->ti[WGD->wall_indices[id]] + WGD->v[second_id] * WGD->tj[WGD->wall_indices[id]]
-                     + WGD->w[second_id] * WGD->tk[WGD->wall_indices[id]]);
+      vel_mag2 = abs(WGD->u[second_id] * cutGeometry.ti + WGD->v[second_id] * cutGeometry.tj
+                     + WGD->w[second_id] * cutGeometry.tk);
     }
 
     if (vel_mag2 == 0.0) {
@@ -652,9 +689,18 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
     }
 
     // Turn the velocity magnitude in the tangential direction to Cartesian grid (U0 = ut + un (un = 0))
-    WGD->u0[first_id] = vel_mag1 * WGD->ti[WGD->wall_indices[id]];
-    WGD->v0[first_id] = vel_mag1 * WGD->tj[WGD->wall_indices[id]];
-    WGD->w0[first_id] = vel_mag1 * WGD->tk[WGD->wall_indices[id]];
+    corr_id[id] = first_id;
+    corr_u[id] = vel_mag1 * cutGeometry.ti;
+    corr_v[id] = vel_mag1 * cutGeometry.tj;
+    corr_w[id] = vel_mag1 * cutGeometry.tk;
+  }
+
+  for (auto id = 0u; id < WGD->wall_indices.size(); id++) {
+    if (corr_id[id] >= 0) {
+      WGD->u0[corr_id[id]] = corr_u[id];
+      WGD->v0[corr_id[id]] = corr_v[id];
+      WGD->w0[corr_id[id]] = corr_w[id];
+    }
   }
 
 
@@ -669,6 +715,9 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
   index.resize(wall_size, 0.0);
   int j;
 
+  // Each face correction writes the face of the wall and reads the next face in the
+  // normal direction, which is never a wall face of the same list: the loops are parallel.
+
   ustar_wall = 0.1;
   wind_dir = 0.0;
   vel_mag1 = 0.0;
@@ -678,6 +727,7 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
   dist2 = 1.5 * WGD->dz;
 
   // apply log law fix to the cells with wall below
+#pragma omp parallel for private(ustar_wall, new_ustar, wind_dir, vel_mag1, vel_mag2, j) default(none) shared(WGD, index, ustar, dist1, dist2)
   for (size_t i = 0; i < WGD->wall_below_indices.size(); i++) {
     ustar_wall = 0.1;// reset default value for velocity gradient
     for (auto iter = 0; iter < 20; iter++) {
@@ -696,6 +746,7 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
   }
 
   // apply log law fix to the cells with wall above
+#pragma omp parallel for private(ustar_wall, new_ustar, wind_dir, vel_mag1, vel_mag2, j) default(none) shared(WGD, index, ustar, dist1, dist2)
   for (size_t i = 0; i < WGD->wall_above_indices.size(); i++) {
     ustar_wall = 0.1;// reset default value for velocity gradient
     for (auto iter = 0; iter < 20; iter++) {
@@ -718,6 +769,7 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
   dist2 = 1.5 * WGD->dx;
 
   // apply log law fix to the cells with wall in back
+#pragma omp parallel for private(ustar_wall, new_ustar, wind_dir, vel_mag1, vel_mag2, j) default(none) shared(WGD, index, ustar, dist1, dist2)
   for (size_t i = 0; i < WGD->wall_back_indices.size(); i++) {
     ustar_wall = 0.1;
     for (auto iter = 0; iter < 20; iter++) {
@@ -738,6 +790,7 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
 
 
   // apply log law fix to the cells with wall in front
+#pragma omp parallel for private(ustar_wall, new_ustar, wind_dir, vel_mag1, vel_mag2, j) default(none) shared(WGD, index, ustar, dist1, dist2)
   for (size_t i = 0; i < WGD->wall_front_indices.size(); i++) {
     ustar_wall = 0.1;// reset default value for velocity gradient
     for (auto iter = 0; iter < 20; iter++) {
@@ -761,6 +814,7 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
   dist2 = 1.5 * WGD->dy;
 
   // apply log law fix to the cells with wall to right
+#pragma omp parallel for private(ustar_wall, new_ustar, wind_dir, vel_mag1, vel_mag2, j) default(none) shared(WGD, index, ustar, dist1, dist2)
   for (size_t i = 0; i < WGD->wall_right_indices.size(); i++) {
     ustar_wall = 0.1;// reset default value for velocity gradient
     for (auto iter = 0; iter < 20; iter++) {
@@ -780,6 +834,7 @@ void Wall::wallLogBC(WINDSGeneralData *WGD, bool isInitial)
   }
 
   // apply log law fix to the cells with wall to left
+#pragma omp parallel for private(ustar_wall, new_ustar, wind_dir, vel_mag1, vel_mag2, j) default(none) shared(WGD, index, ustar, dist1, dist2)
   for (size_t i = 0; i < WGD->wall_left_indices.size(); i++) {
     ustar_wall = 0.1;// reset default value for velocity gradient
     for (auto iter = 0; iter < 20; iter++) {
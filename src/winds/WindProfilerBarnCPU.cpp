@@ -44,6 +44,7 @@
 #include <vector>
 #include <chrono>
 #include <limits>
+#include <algorithm>
 
 #include "WINDSInputData.h"
 #include "WINDSGeneralData.h"
@@ -69,153 +70,313 @@ void WindProfilerBarnCPU::interpolateWindProfile(const WINDSInputData *WID, WIND
   return;
 }
 
-void WindProfilerBarnCPU::BarnesInterpolationCPU(const WINDSInputData *WID, WINDSGeneralData *WGD)
+bool WindProfilerBarnCPU::sensorLayoutChanged(const WINDSInputData *WID, const WINDSGeneralData *WGD)
 {
-  std::vector<float> x, y;
-  x.resize(WGD->nx);
-  for (auto i = 0; i < WGD->nx; i++) {
-    x[i] = (i - 0.5) * WGD->dx; /**< Location of face centers in x-dir */
+  int num_sites = available_sensor_id.size();
+  if (layout_nx != WGD->nx || layout_ny != WGD->ny || layout_dx != WGD->dx || layout_dy != WGD->dy
+      || (int)layout_x.size() != num_sites) {
+    return true;
   }
-
-  y.resize(WGD->ny);
-  for (auto j = 0; j < WGD->ny; j++) {
-    y[j] = (j - 0.5) * WGD->dy; /**< Location of face centers in y-dir */
+  for (auto ii = 0; ii < num_sites; ii++) {
+    if (layout_x[ii] != WID->metParams->sensors[available_sensor_id[ii]]->site_xcoord
+        || layout_y[ii] != WID->metParams->sensors[available_sensor_id[ii]]->site_ycoord) {
+      return true;
+    }
   }
+  return false;
+}
 
-  float rc_sum, rc_val, xc, yc, rc;
-  float dn, lamda, s_gamma;
-  float sum_wm, sum_wu, sum_wv;
-  float dxx, dyy, u12, u34, v12, v34;
-  int icell_face;
-
-  float surf_layer_height;// Surface layer height of the atmospheric boundary layer
-
+void WindProfilerBarnCPU::computeBarnesWeights(const WINDSInputData *WID, const WINDSGeneralData *WGD)
+{
   int num_sites = available_sensor_id.size();
 
-  std::vector<float> u0_int(num_sites * WGD->nz, 0.0);
-  std::vector<float> v0_int(num_sites * WGD->nz, 0.0);
-  std::vector<std::vector<std::vector<float>>> wm(num_sites, std::vector<std::vector<float>>(WGD->nx, std::vector<float>(WGD->ny, 0.0)));
-  std::vector<std::vector<std::vector<float>>> wms(num_sites, std::vector<std::vector<float>>(WGD->nx, std::vector<float>(WGD->ny, 0.0)));
-  int iwork = 0, jwork = 0;
-  std::vector<int> site_i(num_sites, 0);
-  std::vector<int> site_j(num_sites, 0);
-  std::vector<int> site_id(num_sites, 0);
+  layout_nx = WGD->nx;
+  layout_ny = WGD->ny;
+  layout_dx = WGD->dx;
+  layout_dy = WGD->dy;
+  layout_x.resize(num_sites);
+  layout_y.resize(num_sites);
+  site_column.resize(num_sites);
+  for (auto ii = 0; ii < num_sites; ii++) {
+    layout_x[ii] = WID->metParams->sensors[available_sensor_id[ii]]->site_xcoord;
+    layout_y[ii] = WID->metParams->sensors[available_sensor_id[ii]]->site_ycoord;
+    int site_i = layout_x[ii] / WGD->dx;
+    int site_j = layout_y[ii] / WGD->dy;
+    site_column[ii] = site_i + site_j * WGD->nx;
+  }
+
+  // spatial grid of buckets holding the sites
+  float x_min = *std::min_element(layout_x.begin(), layout_x.end());
+  float x_max = *std::max_element(layout_x.begin(), layout_x.end());
+  float y_min = *std::min_element(layout_y.begin(), layout_y.end());
+  float y_max = *std::max_element(layout_y.begin(), layout_y.end());
 
-  rc_sum = 0.0;
-  for (auto i = 0; i < num_sites; i++) {
-    rc_val = 1000000.0;
+  // Barnes length scale from the mean distance to the nearest neighbor site
+  // (same definition as the full Barnes scheme)
+  float rc_sum = 0.0;
+  {
+    // provisional buckets sized to hold about one site each
+    float h = std::max(std::max(x_max - x_min, y_max - y_min) / std::max(1.0f, std::sqrt((float)num_sites)), 1.0f);
+    int nbx = (int)((x_max - x_min) / h) + 1;
+    int nby = (int)((y_max - y_min) / h) + 1;
+    std::vector<int> bucket_start(nbx * nby + 1, 0), bucket_site(num_sites);
+    for (auto ii = 0; ii < num_sites; ii++) {
+      bucket_start[(int)((layout_x[ii] - x_min) / h) + (int)((layout_y[ii] - y_min) / h) * nbx + 1]++;
+    }
+    for (auto b = 0; b < nbx * nby; b++) {
+      bucket_start[b + 1] += bucket_start[b];
+    }
+    std::vector<int> fill(bucket_start.begin(), bucket_start.end() - 1);
     for (auto ii = 0; ii < num_sites; ii++) {
-      xc = WID->metParams->sensors[available_sensor_id[ii]]->site_xcoord - WID->metParams->sensors[available_sensor_id[i]]->site_xcoord;
-      yc = WID->metParams->sensors[available_sensor_id[ii]]->site_ycoord - WID->metParams->sensors[available_sensor_id[i]]->site_ycoord;
-      rc = sqrt(pow(xc, 2.0) + pow(yc, 2.0));
-      if (rc < rc_val && ii != i) {
-        rc_val = rc;
+      bucket_site[fill[(int)((layout_x[ii] - x_min) / h) + (int)((layout_y[ii] - y_min) / h) * nbx]++] = ii;
+    }
+
+#pragma omp parallel for reduction(+ : rc_sum) default(none) shared(num_sites, h, nbx, nby, x_min, y_min, bucket_start, bucket_site)
+    for (auto i = 0; i < num_sites; i++) {
+      int bi = (int)((layout_x[i] - x_min) / h);
+      int bj = (int)((layout_y[i] - y_min) / h);
+      float rc_val = 1000000.0;
+      for (auto r = 0; r <= std::max(nbx, nby); r++) {
+        if (r > 1 && rc_val <= (r - 1) * h) {
+          break;
+        }
+        for (auto bjj = std::max(bj - r, 0); bjj <= std::min(bj + r, nby - 1); bjj++) {
+          for (auto bii = std::max(bi - r, 0); bii <= std::min(bi + r, nbx - 1); bii++) {
+            if (std::max(std::abs(bii - bi), std::abs(bjj - bj)) != r) {
+              continue;
+            }
+            int b = bii + bjj * nbx;
+            for (auto n = bucket_start[b]; n < bucket_start[b + 1]; n++) {
+              int ii = bucket_site[n];
+              float xc = layout_x[ii] - layout_x[i];
+              float yc = layout_y[ii] - layout_y[i];
+              float rc = std::sqrt(xc * xc + yc * yc);
+              if (rc < rc_val && ii != i) {
+                rc_val = rc;
+              }
+            }
+          }
+        }
       }
+      rc_sum += rc_val;
     }
-    rc_sum = rc_sum + rc_val;
   }
 
-  dn = rc_sum / num_sites;
-  lamda = 5.052 * pow((2 * dn / M_PI), 2.0);
-  s_gamma = 0.2;
-  for (auto j = 0; j < WGD->ny; j++) {
-    for (auto i = 0; i < WGD->nx; i++) {
-      sum_wm = 0.0;
-      for (auto ii = 0; ii < num_sites; ii++) {
-        wm[ii][i][j] = exp((-1 / lamda)
-                             * pow(WID->metParams->sensors[available_sensor_id[ii]]->site_xcoord - x[i], 2.0)
-                           - (1 / lamda) * pow(WID->metParams->sensors[available_sensor_id[ii]]->site_ycoord - y[j], 2.0));
-        wms[ii][i][j] = exp((-1 / (s_gamma * lamda))
-                              * pow(WID->metParams->sensors[available_sensor_id[ii]]->site_xcoord - x[i], 2.0)
-                            - (1 / (s_gamma * lamda)) * pow(WID->metParams->sensors[available_sensor_id[ii]]->site_ycoord - y[j], 2.0));
-        sum_wm += wm[ii][i][j];
+  float dn = rc_sum / num_sites;
+  float lamda = 5.052 * pow((2 * dn / M_PI), 2.0);
+  // squared distance, beyond the nearest site, past which the weight drops below the cutoff
+  float r2_cutoff = -lamda * std::log(weight_cutoff);
+
+  // buckets at least as wide as the cutoff distance, at most a few per site
+  float h = std::sqrt(r2_cutoff);
+  h = std::max(h, std::max(x_max - x_min, y_max - y_min) / (2.0f * std::sqrt((float)num_sites) + 1.0f));
+  h = std::max(h, 1.0f);
+  int nbx = (int)((x_max - x_min) / h) + 1;
+  int nby = (int)((y_max - y_min) / h) + 1;
+  std::vector<int> bucket_start(nbx * nby + 1, 0), bucket_site(num_sites);
+  for (auto ii = 0; ii < num_sites; ii++) {
+    bucket_start[(int)((layout_x[ii] - x_min) / h) + (int)((layout_y[ii] - y_min) / h) * nbx + 1]++;
+  }
+  for (auto b = 0; b < nbx * nby; b++) {
+    bucket_start[b + 1] += bucket_start[b];
+  }
+  std::vector<int> fill(bucket_start.begin(), bucket_start.end() - 1);
+  for (auto ii = 0; ii < num_sites; ii++) {
+    bucket_site[fill[(int)((layout_x[ii] - x_min) / h) + (int)((layout_y[ii] - y_min) / h) * nbx]++] = ii;
+  }
+
+  int nx = WGD->nx, ny = WGD->ny;
+  std::vector<std::vector<int>> column_site(nx * ny);
+  std::vector<std::vector<float>> column_wm(nx * ny);
+
+#pragma omp parallel for schedule(dynamic) default(none) shared(WGD, nx, ny, h, nbx, nby, x_min, y_min, lamda, r2_cutoff, bucket_start, bucket_site, column_site, column_wm)
+  for (auto j = 0; j < ny; j++) {
+    float yf = (j - 0.5) * WGD->dy; /**< Location of face centers in y-dir */
+    int bj = std::min(std::max((int)std::floor((yf - y_min) / h), 0), nby - 1);
+    for (auto i = 0; i < nx; i++) {
+      float xf = (i - 0.5) * WGD->dx; /**< Location of face centers in x-dir */
+      int bi = std::min(std::max((int)std::floor((xf - x_min) / h), 0), nbx - 1);
+
+      // nearest site, searching rings of buckets around the face
+      float r2_min = std::numeric_limits<float>::max();
+      for (auto r = 0; r <= std::max(nbx, nby); r++) {
+        if (r > 1 && r2_min <= (r - 1) * h * (r - 1) * h) {
+          break;
+        }
+        for (auto bjj = std::max(bj - r, 0); bjj <= std::min(bj + r, nby - 1); bjj++) {
+          for (auto bii = std::max(bi - r, 0); bii <= std::min(bi + r, nbx - 1); bii++) {
+            if (std::max(std::abs(bii - bi), std::abs(bjj - bj)) != r) {
+              continue;
+            }
+            int b = bii + bjj * nbx;
+            for (auto n = bucket_start[b]; n < bucket_start[b + 1]; n++) {
+              int ii = bucket_site[n];
+              float r2 = (layout_x[ii] - xf) * (layout_x[ii] - xf) + (layout_y[ii] - yf) * (layout_y[ii] - yf);
+              r2_min = std::min(r2_min, r2);
+            }
+          }
+        }
       }
-      if (sum_wm == 0) {
-        for (auto ii = 0; ii < num_sites; ii++) {
-          wm[ii][i][j] = 1e-20;
+
+      // all the sites within the cutoff distance. The weights are taken relative
+      // to the nearest site, which cancels out in the normalization but keeps
+      // the sum of the weights from underflowing far from the sites.
+      float r2_max = r2_min + r2_cutoff;
+      float r_max = std::sqrt(r2_max);
+      int bi_0 = std::max((int)std::floor((xf - r_max - x_min) / h), 0);
+      int bi_1 = std::min((int)std::floor((xf + r_max - x_min) / h), nbx - 1);
+      int bj_0 = std::max((int)std::floor((yf - r_max - y_min) / h), 0);
+      int bj_1 = std::min((int)std::floor((yf + r_max - y_min) / h), nby - 1);
+      int id = i + j * nx;
+      for (auto bjj = bj_0; bjj <= bj_1; bjj++) {
+        for (auto bii = bi_0; bii <= bi_1; bii++) {
+          int b = bii + bjj * nbx;
+          for (auto n = bucket_start[b]; n < bucket_start[b + 1]; n++) {
+            int ii = bucket_site[n];
+            float r2 = (layout_x[ii] - xf) * (layout_x[ii] - xf) + (layout_y[ii] - yf) * (layout_y[ii] - yf);
+            if (r2 <= r2_max) {
+              column_site[id].push_back(ii);
+              column_wm[id].push_back(std::exp(-(r2 - r2_min) / lamda));
+            }
+          }
         }
       }
     }
   }
 
-  int k_mod;//Modified index in z-direction
-  for (auto k = 1; k < WGD->nz - 1; k++) {
-    for (auto j = 0; j < WGD->ny; j++) {
-      for (auto i = 0; i < WGD->nx; i++) {
-        sum_wu = 0.0;
-        sum_wv = 0.0;
-        sum_wm = 0.0;
-        int id = i + j * WGD->nx;//Index in horizontal surface
+  // flatten the columns
+  weight_start.assign(nx * ny + 1, 0);
+  for (auto id = 0; id < nx * ny; id++) {
+    weight_start[id + 1] = weight_start[id] + column_site[id].size();
+  }
+  weight_site.resize(weight_start[nx * ny]);
+  weight_wm.resize(weight_start[nx * ny]);
+  weight_dz.resize(weight_start[nx * ny]);
+  for (auto id = 0; id < nx * ny; id++) {
+    for (size_t n = 0; n < column_site[id].size(); n++) {
+      int e = weight_start[id] + n;
+      weight_site[e] = column_site[id][n];
+      weight_wm[e] = column_wm[id][n];
+      weight_dz[e] = std::abs(WGD->z[WGD->terrain_face_id[id]] - WGD->z[WGD->terrain_face_id[site_column[column_site[id][n]]]]);
+    }
+  }
+
+  std::cout << "[QES-WINDS]\t Barnes weights computed for " << num_sites << " sites ("
+            << (float)weight_site.size() / (nx * ny) << " sites per column on average)" << std::endl;
+}
+
+void WindProfilerBarnCPU::barnesPass(WINDSGeneralData *WGD, const std::vector<float> &u_ref, const std::vector<float> &v_ref, bool correction)
+{
+  int nx = WGD->nx, ny = WGD->ny, nz = WGD->nz;
+
+  // each (i,j,k) writes its own face, and the faces of a column are distinct in k
+#pragma omp parallel for collapse(2) default(none) shared(WGD, u_ref, v_ref, correction, nx, ny, nz)
+  for (auto k = 1; k < nz - 1; k++) {
+    for (auto j = 0; j < ny; j++) {
+      for (auto i = 0; i < nx; i++) {
+        float sum_wu = 0.0;
+        float sum_wv = 0.0;
+        float sum_wm = 0.0;
+        int id = i + j * nx;//Index in horizontal surface
+        int k_mod;//Modified index in z-direction
         //If height added to top of terrain is still inside QES domain
-        if (k + WGD->terrain_face_id[id] - 1 < WGD->nz) {
+        if (k + WGD->terrain_face_id[id] - 1 < nz) {
           k_mod = k + WGD->terrain_face_id[id] - 1;//Set the modified index
         } else {
           continue;
         }
 
-        for (auto ii = 0; ii < num_sites; ii++) {
-          site_i[ii] = WID->metParams->sensors[available_sensor_id[ii]]->site_xcoord / WGD->dx;
-          site_j[ii] = WID->metParams->sensors[available_sensor_id[ii]]->site_ycoord / WGD->dy;
-          site_id[ii] = site_i[ii] + site_j[ii] * WGD->nx;
-          // If the height difference between the terrain at the curent cell and sensor location is less than ABL height
-          if (abs(WGD->z[WGD->terrain_face_id[id]] - WGD->z[WGD->terrain_face_id[site_id[ii]]]) > abl_height) {
-            surf_layer_height = asl_percent * abl_height;
-          } else {
-            surf_layer_height = asl_percent * (2 * abl_height - abs(WGD->z[WGD->terrain_face_id[id]] - WGD->z[WGD->terrain_face_id[site_id[ii]]]));
-          }
+        for (auto e = weight_start[id]; e < weight_start[id + 1]; e++) {
+          int ii = weight_site[e];
+          int k_site = k + WGD->terrain_face_id[site_column[ii]] - 1;
+          int k_prof;
           // If sum of z index and the terrain index at the sensor location is outside the domain
-          if (k + WGD->terrain_face_id[site_id[ii]] - 1 > WGD->nz - 2) {
-            sum_wu += wm[ii][i][j] * u_prof[ii * WGD->nz + WGD->nz - 2];
-            sum_wv += wm[ii][i][j] * v_prof[ii * WGD->nz + WGD->nz - 2];
-            sum_wm += wm[ii][i][j];
-          }// If height (above ground) is less than or equal to ASL height
-          else if (WGD->z[k] <= surf_layer_height) {
-            sum_wu += wm[ii][i][j] * u_prof[ii * WGD->nz + k + WGD->terrain_face_id[site_id[ii]] - 1];
-            sum_wv += wm[ii][i][j] * v_prof[ii * WGD->nz + k + WGD->terrain_face_id[site_id[ii]] - 1];
-            sum_wm += wm[ii][i][j];
-          }// If height (above ground) is greater than ASL height and modified index is inside the domain
-          else if (WGD->z[k] > surf_layer_height
-                   && k + WGD->terrain_face_id[site_id[ii]] - 1 < WGD->nz
-                   && k_mod > k + WGD->terrain_face_id[site_id[ii]] - 1) {
-            sum_wu += wm[ii][i][j] * u_prof[ii * WGD->nz + k_mod];
-            sum_wv += wm[ii][i][j] * v_prof[ii * WGD->nz + k_mod];
-            sum_wm += wm[ii][i][j];
+          if (k_site > nz - 2) {
+            k_prof = nz - 2;
           } else {
-            sum_wu += wm[ii][i][j] * u_prof[ii * WGD->nz + k + WGD->terrain_face_id[site_id[ii]] - 1];
-            sum_wv += wm[ii][i][j] * v_prof[ii * WGD->nz + k + WGD->terrain_face_id[site_id[ii]] - 1];
-            sum_wm += wm[ii][i][j];
+            // If the height difference between the terrain at the curent cell and sensor location is less than ABL height
+            float surf_layer_height;
+            if (weight_dz[e] > abl_height) {
+              surf_layer_height = asl_percent * abl_height;
+            } else {
+              surf_layer_height = asl_percent * (2 * abl_height - weight_dz[e]);
+            }
+            // If height (above ground) is greater than ASL height and modified index is inside the domain
+            if (WGD->z[k] > surf_layer_height && k_mod > k_site) {
+              k_prof = k_mod;
+            } else {
+              k_prof = k_site;
+            }
           }
+          sum_wu += weight_wm[e] * (u_prof[ii * nz + k_prof] - u_ref[k_prof + ii * nz]);
+          sum_wv += weight_wm[e] * (v_prof[ii * nz + k_prof] - v_ref[k_prof + ii * nz]);
+          sum_wm += weight_wm[e];
         }
 
-        icell_face = i + j * WGD->nx + k_mod * WGD->nx * WGD->ny;
-        WGD->u0[icell_face] = sum_wu / sum_wm;
-        WGD->v0[icell_face] = sum_wv / sum_wm;
-        WGD->w0[icell_face] = 0.0;
+        int icell_face = i + j * nx + k_mod * nx * ny;
+        if (!correction) {
+          WGD->u0[icell_face] = sum_wu / sum_wm;
+          WGD->v0[icell_face] = sum_wv / sum_wm;
+          WGD->w0[icell_face] = 0.0;
+        } else if (sum_wm != 0) {
+          WGD->u0[icell_face] = WGD->u0[icell_face] + sum_wu / sum_wm;
+          WGD->v0[icell_face] = WGD->v0[icell_face] + sum_wv / sum_wm;
+        }
       }
     }
   }
+}
+
+void WindProfilerBarnCPU::BarnesInterpolationCPU(const WINDSInputData *WID, WINDSGeneralData *WGD)
+{
+  std::vector<float> x, y;
+  x.resize(WGD->nx);
+  for (auto i = 0; i < WGD->nx; i++) {
+    x[i] = (i - 0.5) * WGD->dx; /**< Location of face centers in x-dir */
+  }
+
+  y.resize(WGD->ny);
+  for (auto j = 0; j < WGD->ny; j++) {
+    y[j] = (j - 0.5) * WGD->dy; /**< Location of face centers in y-dir */
+  }
+
+  float dxx, dyy, u12, u34, v12, v34;
+  int iwork = 0, jwork = 0;
+
+  int num_sites = available_sensor_id.size();
+
+  // the weights only depend on the sensor layout, reuse them across timesteps
+  if (sensorLayoutChanged(WID, WGD)) {
+    computeBarnesWeights(WID, WGD);
+  }
+
+  std::vector<float> u0_int(num_sites * WGD->nz, 0.0);
+  std::vector<float> v0_int(num_sites * WGD->nz, 0.0);
+
+  // first pass: weighted average of the site profiles
+  barnesPass(WGD, u0_int, v0_int, false);
 
   for (auto ii = 0; ii < num_sites; ii++) {
-    if (WID->metParams->sensors[available_sensor_id[ii]]->site_xcoord > 0
-        && WID->metParams->sensors[available_sensor_id[ii]]->site_xcoord < (WGD->nx - 1) * WGD->dx
-        && WID->metParams->sensors[available_sensor_id[ii]]->site_ycoord > 0
-        && WID->metParams->sensors[available_sensor_id[ii]]->site_ycoord < (WGD->ny - 1) * WGD->dy) {
+    if (layout_x[ii] > 0
+        && layout_x[ii] < (WGD->nx - 1) * WGD->dx
+        && layout_y[ii] > 0
+        && layout_y[ii] < (WGD->ny - 1) * WGD->dy) {
       for (auto j = 0; j < WGD->ny; j++) {
-        if (y[j] < WID->metParams->sensors[available_sensor_id[ii]]->site_ycoord) {
+        if (y[j] < layout_y[ii]) {
           jwork = j;
         }
       }
 
       for (auto i = 0; i < WGD->nx; i++) {
-        if (x[i] < WID->metParams->sensors[available_sensor_id[ii]]->site_xcoord) {
+        if (x[i] < layout_x[ii]) {
           iwork = i;
         }
       }
 
       int id = iwork + jwork * WGD->nx;
       for (auto k_mod = WGD->terrain_face_id[id]; k_mod < WGD->nz; k_mod++) {
-        dxx = WID->metParams->sensors[available_sensor_id[ii]]->site_xcoord - x[iwork];
-        dyy = WID->metParams->sensors[available_sensor_id[ii]]->site_ycoord - y[jwork];
+        dxx = layout_x[ii] - x[iwork];
+        dyy = layout_y[ii] - y[jwork];
         int index_work = iwork + jwork * WGD->nx + k_mod * WGD->nx * WGD->ny;
         u12 = (1 - (dxx / WGD->dx)) * WGD->u0[index_work + WGD->nx] + (dxx / WGD->dx) * WGD->u0[index_work + 1 + WGD->nx];
         u34 = (1 - (dxx / WGD->dx)) * WGD->u0[index_work] + (dxx / WGD->dx) * WGD->u0[index_work + 1];
@@ -226,82 +387,19 @@ void WindProfilerBarnCPU::BarnesInterpolationCPU(const WINDSInputData *WID, WIND
         v0_int[k_mod + ii * WGD->nz] = (dyy / WGD->dy) * v12 + (1 - (dyy / WGD->dy)) * v34;
       }
     } else {
-      site_i[ii] = WID->metParams->sensors[available_sensor_id[ii]]->site_xcoord / WGD->dx;
-      site_j[ii] = WID->metParams->sensors[available_sensor_id[ii]]->site_ycoord / WGD->dy;
-      site_id[ii] = site_i[ii] + site_j[ii] * WGD->nx;
+      int kt = WGD->terrain_face_id[site_column[ii]];
       for (auto k = 1; k < WGD->nz; k++) {
-        if (k + WGD->terrain_face_id[site_id[ii]] - 1 > WGD->nz - 2) {
+        if (k + kt - 1 > WGD->nz - 2) {
           u0_int[k + ii * WGD->nz] = u_prof[ii * WGD->nz + WGD->nz - 2];
           v0_int[k + ii * WGD->nz] = v_prof[ii * WGD->nz + WGD->nz - 2];
         } else {
-          u0_int[k + WGD->terrain_face_id[site_id[ii]] - 1 + ii * WGD->nz] = u_prof[ii * WGD->nz + k + WGD->terrain_face_id[site_id[ii]] - 1];
-          v0_int[k + WGD->terrain_face_id[site_id[ii]] - 1 + ii * WGD->nz] = v_prof[ii * WGD->nz + k + WGD->terrain_face_id[site_id[ii]] - 1];
+          u0_int[k + kt - 1 + ii * WGD->nz] = u_prof[ii * WGD->nz + k + kt - 1];
+          v0_int[k + kt - 1 + ii * WGD->nz] = v_prof[ii * WGD->nz + k + kt - 1];
         }
       }
     }
   }
 
-  for (auto k = 1; k < WGD->nz - 1; k++) {
-    for (auto j = 0; j < WGD->ny; j++) {
-      for (auto i = 0; i < WGD->nx; i++) {
-        sum_wu = 0.0;
-        sum_wv = 0.0;
-        sum_wm = 0.0;
-        int id = i + j * WGD->nx;//Index in horizontal surface
-        //If height added to top of terrain is still inside QES domain
-        if (k + WGD->terrain_face_id[id] - 1 < WGD->nz) {
-          k_mod = k + WGD->terrain_face_id[id] - 1;//Set the modified index
-        } else {
-          continue;
-        }
-        for (auto ii = 0; ii < num_sites; ii++) {
-          site_i[ii] = WID->metParams->sensors[available_sensor_id[ii]]->site_xcoord / WGD->dx;
-          site_j[ii] = WID->metParams->sensors[available_sensor_id[ii]]->site_ycoord / WGD->dy;
-          site_id[ii] = site_i[ii] + site_j[ii] * WGD->nx;
-          // If the height difference between the terrain at the curent cell and sensor location is less than ABL height
-          if (abs(WGD->z[WGD->terrain_face_id[id]] - WGD->z[WGD->terrain_face_id[site_id[ii]]]) > abl_height) {
-            surf_layer_height = asl_percent * abl_height;
-          } else {
-            surf_layer_height = asl_percent * (2 * abl_height - abs(WGD->z[WGD->terrain_face_id[id]] - WGD->z[WGD->terrain_face_id[site_id[ii]]]));
-          }
-          // If sum of z index and the terrain index at the sensor location is outside the domain
-          if (k + WGD->terrain_face_id[site_id[ii]] - 1 > WGD->nz - 2) {
-            sum_wu += wm[ii][i][j] * (u_prof[ii * WGD->nz + WGD->nz - 2] - u0_int[WGD->nz - 2 + ii * WGD->nz]);
-            sum_wv += wm[ii][i][j] * (v_prof[ii * WGD->nz + WGD->nz - 2] - v0_int[WGD->nz - 2 + ii * WGD->nz]);
-            sum_wm += wm[ii][i][j];
-          }// If height (above ground) is less than or equal to ASL height
-          else if (WGD->z[k] <= surf_layer_height) {
-            sum_wu += wm[ii][i][j]
-                      * (u_prof[ii * WGD->nz + k + WGD->terrain_face_id[site_id[ii]] - 1]
-                         - u0_int[k + WGD->terrain_face_id[site_id[ii]] - 1 + ii * WGD->nz]);
-            sum_wv += wm[ii][i][j]
-                      * (v_prof[ii * WGD->nz + k + WGD->terrain_face_id[site_id[ii]] - 1]
-                         - v0_int[k + WGD->terrain_face_id[site_id[ii]] - 1 + ii * WGD->nz]);
-            sum_wm += wm[ii][i][j];
-          }// If height (above ground) is greater than ASL height and modified index is inside the domain
-          else if (WGD->z[k] > surf_layer_height
-                   && k + WGD->terrain_face_id[site_id[ii]] - 1 < WGD->nz
-                   && k_mod > k + WGD->terrain_face_id[site_id[ii]] - 1) {
-            sum_wu += wm[ii][i][j] * (u_prof[ii * WGD->nz + k_mod] - u0_int[k_mod + ii * WGD->nz]);
-            sum_wv += wm[ii][i][j] * (v_prof[ii * WGD->nz + k_mod] - v0_int[k_mod + ii * WGD->nz]);
-            sum_wm += wm[ii][i][j];
-          } else {
-            sum_wu += wm[ii][i][j]
-                      * (u_prof[ii * WGD->nz + k + WGD->terrain_face_id[site_id[ii]] - 1]
-                         - u0_int[k + WGD->terrain_face_id[site_id[ii]] - 1 + ii * WGD->nz]);
-            sum_wv += wm[ii][i][j]
-                      * (v_prof[ii * WGD->nz + k + WGD->terrain_face_id[site_id[ii]] - 1]
-                         - v0_int[k + WGD->terrain_face_id[site_id[ii]] - 1 + ii * WGD->nz]);
-            sum_wm += wm[ii][i][j];
-          }
-        }
-
-        if (sum_wm != 0) {
-          icell_face = i + j * WGD->nx + k_mod * WGD->nx * WGD->ny;
-          WGD->u0[icell_face] = WGD->u0[icell_face] + sum_wu / sum_wm;
-          WGD->v0[icell_face] = WGD->v0[icell_face] + sum_wv / sum_wm;
-        }
-      }
-    }
-  }
+  // second pass: weighted average of the residuals at the sites
+  barnesPass(WGD, u0_int, v0_int, true);
 }
@@ -43,6 +43,27 @@ class WindProfilerBarnCPU : public WindProfilerSensorType
 private:
   void BarnesInterpolationCPU(const WINDSInputData *WID, WINDSGeneralData *WGD);
 
+  bool sensorLayoutChanged(const WINDSInputData *WID, const WINDSGeneralData *WGD);
+  void computeBarnesWeights(const WINDSInputData *WID, const WINDSGeneralData *WGD);
+  void barnesPass(WINDSGeneralData *WGD, const std::vector<float> &u_ref, const std::vector<float> &v_ref, bool correction);
+
+  // relative weight (to the nearest site) below which a site is dropped from a column
+  const float weight_cutoff = 1.0e-6;
+
+  // sensor layout the cached weights were computed for
+  std::vector<float> layout_x; /**< x-coordinates of the available sites */
+  std::vector<float> layout_y; /**< y-coordinates of the available sites */
+  int layout_nx = 0, layout_ny = 0;
+  float layout_dx = 0.0, layout_dy = 0.0;
+
+  // sparse Barnes weights, one row per horizontal face column (i + j*nx)
+  std::vector<int> weight_start; /**< first entry of each column (size nx*ny+1) */
+  std::vector<int> weight_site; /**< site of each entry */
+  std::vector<float> weight_wm; /**< Gaussian weight of each entry */
+  std::vector<float> weight_dz; /**< terrain height difference between the column and the site */
+
+  std::vector<int> site_column; /**< horizontal face index of the column holding each site */
+
 public:
   void interpolateWindProfile(const WINDSInputData *, WINDSGeneralData *);
 };
@@ -0,0 +1,89 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include <vector>
+
+#include "plume/ConcentrationKernel.h"
+
+static double sum(const std::vector<double> &w)
+{
+  double s = 0.0;
+  for (auto v : w) s += v;
+  return s;
+}
+
+TEST_CASE("Testing the kernel concentration estimator")
+{
+  // 20 boxes of 2 m starting at 10 m
+  ConcentrationKernel kernel(20, 10.0, 2.0, false);
+  int first;
+  std::vector<double> w;
+
+  SECTION("zero half-width gives back the box count")
+  {
+    REQUIRE(kernel.weights(15.3, 0.0, first, w));
+    REQUIRE(first == 2);
+    REQUIRE(w.size() == 1);
+    REQUIRE(w[0] == 1.0);
+    REQUIRE_FALSE(kernel.weights(9.0, 0.0, first, w));
+    REQUIRE_FALSE(kernel.weights(51.0, 0.0, first, w));
+  }
+
+  SECTION("the mass is conserved inside of the boxes")
+  {
+    REQUIRE(kernel.weights(25.3, 3.7, first, w));
+    REQUIRE(first == 5);
+    REQUIRE(w.size() == 5);
+    REQUIRE_THAT(sum(w), Catch::Matchers::WithinAbs(1.0, 1e-12));
+    // the kernel is symmetric around its center
+    REQUIRE(kernel.weights(27.0, 3.0, first, w));
+    REQUIRE(first == 7);
+    REQUIRE(w.size() == 3);
+    REQUIRE_THAT(w[0], Catch::Matchers::WithinAbs(w[2], 1e-12));
+    REQUIRE(w[1] > w[0]);
+  }
+
+  SECTION("the part of the kernel outside of the boxes is lost")
+  {
+    REQUIRE(kernel.weights(10.5, 2.0, first, w));
+    REQUIRE(first == 0);
+    REQUIRE(sum(w) < 1.0);
+  }
+
+  SECTION("the kernel is folded at the lower bound")
+  {
+    ConcentrationKernel ground(10, 0.0, 1.0, true);
+    REQUIRE(ground.weights(0.3, 1.5, first, w));
+    REQUIRE(first == 0);
+    REQUIRE_THAT(sum(w), Catch::Matchers::WithinAbs(1.0, 1e-12));
+    REQUIRE_FALSE(ground.weights(-0.1, 1.5, first, w));
+  }
+
+  SECTION("the kernel is folded at the ground, not at a lower bound below it")
+  {
+    // boxes starting 2 m below the ground
+    ConcentrationKernel below(12, -2.0, 1.0, true, 0.0);
+    REQUIRE(below.weights(0.3, 1.5, first, w));
+    REQUIRE_THAT(sum(w), Catch::Matchers::WithinAbs(1.0, 1e-12));
+    // no mass below the ground, same weights as boxes starting at the ground
+    ConcentrationKernel ground(10, 0.0, 1.0, true, 0.0);
+    std::vector<double> wg;
+    int firstGround;
+    REQUIRE(ground.weights(0.3, 1.5, firstGround, wg));
+    for (size_t n = 0; n < w.size(); ++n) {
+      int box = first + n;
+      if (box < 2) {
+        REQUIRE(w[n] == 0.0);
+      } else {
+        REQUIRE_THAT(w[n], Catch::Matchers::WithinAbs(wg[box - 2 - firstGround], 1e-12));
+      }
+    }
+
+    // boxes starting above the ground get the reflected part of the kernel
+    ConcentrationKernel above(10, 0.5, 1.0, true, 0.0);
+    REQUIRE(above.weights(0.8, 1.0, first, w));
+    REQUIRE(first == 0);
+    REQUIRE(sum(w) < 1.0);
+    REQUIRE(sum(w) > 0.7);
+  }
+}
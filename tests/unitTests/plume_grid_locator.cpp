@@ -0,0 +1,72 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "plume/GridLocator.h"
+
+// reference: binary search on the nodes
+static int upperRef(const std::vector<float> &nodes, const double &z)
+{
+  return std::upper_bound(nodes.begin(), nodes.end(), z, [](const double &a, const float &b) { return a < b; }) - nodes.begin() - 1;
+}
+
+static int lowerRef(const std::vector<float> &nodes, const double &z)
+{
+  return std::lower_bound(nodes.begin(), nodes.end(), z, [](const float &a, const double &b) { return a < b; }) - nodes.begin() - 1;
+}
+
+TEST_CASE("Testing the O(1) location on a stretched vertical grid")
+{
+  // faces of a stretched grid (fine near the ground, growing by 8% per cell)
+  std::vector<float> dz_array(60);
+  dz_array[0] = 0.3f;
+  for (size_t k = 1; k < dz_array.size(); ++k) {
+    dz_array[k] = dz_array[k - 1] * 1.08f;
+  }
+  std::vector<float> z_face(dz_array.size() + 1);
+  z_face[0] = -dz_array[0];
+  for (size_t k = 0; k < dz_array.size(); ++k) {
+    z_face[k + 1] = z_face[k] + dz_array[k];
+  }
+  GridLocator locator(z_face);
+
+  std::vector<double> points;
+  // exactly on the faces, and just around them
+  for (auto zf : z_face) {
+    points.push_back(zf);
+    points.push_back(std::nextafter((double)zf, -1.0e9));
+    points.push_back(std::nextafter((double)zf, 1.0e9));
+  }
+  // at and beyond the bounds
+  points.push_back(z_face.front() - 10.0);
+  points.push_back(z_face.back() + 10.0);
+  // random heights over the grid
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> dist(z_face.front(), z_face.back());
+  for (int n = 0; n < 10000; ++n) {
+    points.push_back(dist(gen));
+  }
+
+  for (auto z : points) {
+    REQUIRE(locator.upperIndex(z) == upperRef(z_face, z));
+    REQUIRE(locator.lowerIndex(z) == lowerRef(z_face, z));
+  }
+
+  // interval: nodes[k] < z <= nodes[k + 1] and the fractional distance in (0, 1]
+  for (auto z : points) {
+    if (z <= z_face.front() || z > z_face.back()) {
+      continue;
+    }
+    int k;
+    double w;
+    locator.interval(z, k, w);
+    REQUIRE(k == lowerRef(z_face, z));
+    REQUIRE(z_face[k] < z);
+    REQUIRE(z <= z_face[k + 1]);
+    REQUIRE(w > 0.0);
+    REQUIRE(w <= 1.0);
+  }
+}
@@ -265,4 +265,161 @@ TEST_CASE("interpolation stretched grid", "[Working]")
     errT = errT / float(N);
     REQUIRE(errT < tol);
   }
-}
\ No newline at end of file
+}
+TEST_CASE("interpolation in time", "[Working]")
+{
+
+  int gridSize[3] = { 200, 200, 200 };
+  float gridRes[3] = { 1.0, 1.0, 1.0 };
+
+  test_WINDSGeneralData *WGD0 = new test_WINDSGeneralData(gridSize, gridRes);
+  test_TURBGeneralData *TGD0 = new test_TURBGeneralData(WGD0);
+  test_PlumeGeneralData *PGD = new test_PlumeGeneralData(WGD0, TGD0);
+  PGD->setInterpMethod("triLinear", WGD0, TGD0);
+
+  test_functions *tf0 = new test_functions(WGD0, TGD0, "trig");
+
+  // second timestep: same fields shifted by a constant
+  test_WINDSGeneralData *WGD1 = new test_WINDSGeneralData(gridSize, gridRes);
+  test_TURBGeneralData *TGD1 = new test_TURBGeneralData(WGD1);
+  test_functions *tf1 = new test_functions(WGD1, TGD1, "trig");
+  for (auto &u : WGD1->u) {
+    u += 2.0;
+  }
+  for (auto &txx : TGD1->txx) {
+    txx += 1.0;
+  }
+
+  SECTION("testing linear blending")
+  {
+    std::vector<float> xArray = { 10 + .01, 10 + .51, 125 };
+    std::vector<float> yArray = { 10 + .51, 10 + .51, 136 };
+    std::vector<float> zArray = { 10 + .51, 10 + .01, 190 };
+    std::vector<double> weights = { 0.0, 0.25, 1.0 };
+
+    float tol(1.0e-4);
+
+    for (size_t it = 0; it < xArray.size(); ++it) {
+      double xPos = xArray[it];
+      double yPos = yArray[it];
+      double zPos = zArray[it];
+
+      double uMean0 = 0.0, vMean0 = 0.0, wMean0 = 0.0;
+      double txx0 = 0.0, txy0 = 0.0, txz0 = 0.0, tyy0 = 0.0, tyz0 = 0.0, tzz0 = 0.0;
+      double flux_div_x0 = 0.0, flux_div_y0 = 0.0, flux_div_z0 = 0.0;
+      double CoEps0 = 1e-6, nuT0 = 0.0;
+
+      PGD->interp->interpValues(xPos, yPos, zPos, WGD0, uMean0, vMean0, wMean0, TGD0, txx0, txy0, txz0, tyy0, tyz0, tzz0, flux_div_x0, flux_div_y0, flux_div_z0, nuT0, CoEps0);
+
+      for (auto weight : weights) {
+        double uMean = 0.0, vMean = 0.0, wMean = 0.0;
+        double txx = 0.0, txy = 0.0, txz = 0.0, tyy = 0.0, tyz = 0.0, tzz = 0.0;
+        double flux_div_x = 0.0, flux_div_y = 0.0, flux_div_z = 0.0;
+        double CoEps = 1e-6, nuT = 0.0;
+
+        PGD->interp->interpValuesInTime(xPos, yPos, zPos, WGD0, TGD0, WGD1, TGD1, weight, uMean, vMean, wMean, txx, txy, txz, tyy, tyz, tzz, flux_div_x, flux_div_y, flux_div_z, nuT, CoEps);
+
+        REQUIRE(std::abs(uMean - (uMean0 + 2.0 * weight)) < tol);
+        REQUIRE(std::abs(vMean - vMean0) < tol);
+        REQUIRE(std::abs(wMean - wMean0) < tol);
+        REQUIRE(std::abs(txx - (txx0 + 1.0 * weight)) < tol);
+        REQUIRE(std::abs(tyy - tyy0) < tol);
+      }
+    }
+  }
+}
+
+TEST_CASE("interpolation on a window of the domain", "[Working]")
+{
+
+  int gridSize[3] = { 80, 80, 40 };
+  float gridRes[3] = { 1.0, 1.0, 1.0 };
+
+  test_WINDSGeneralData *WGD = new test_WINDSGeneralData(gridSize, gridRes);
+  test_TURBGeneralData *TGD = new test_TURBGeneralData(WGD);
+  test_PlumeGeneralData *PGD = new test_PlumeGeneralData(WGD, TGD);
+  PGD->setInterpMethod("triLinear", WGD, TGD);
+
+  test_functions *tf = new test_functions(WGD, TGD, "trig");
+
+  // window of cells [20,60) x [30,70) of the domain (as loaded by a process in distributed mode)
+  int i0 = 20, j0 = 30;
+  int windowSize[3] = { 40, 40, 40 };
+  test_WINDSGeneralData *WGDw = new test_WINDSGeneralData(windowSize, gridRes);
+  WGDw->windowI0 = i0;
+  WGDw->windowJ0 = j0;
+  WGDw->x = WGD->x;
+  WGDw->y = WGD->y;
+  test_TURBGeneralData *TGDw = new test_TURBGeneralData(WGDw);
+
+  for (int k = 0; k < WGDw->nz; k++) {
+    for (int j = 0; j < WGDw->ny; j++) {
+      for (int i = 0; i < WGDw->nx; i++) {
+        int faceID = i + j * WGDw->nx + k * WGDw->nx * WGDw->ny;
+        int domainFaceID = (i + i0) + (j + j0) * WGD->nx + k * WGD->nx * WGD->ny;
+        WGDw->u[faceID] = WGD->u[domainFaceID];
+        WGDw->v[faceID] = WGD->v[domainFaceID];
+        WGDw->w[faceID] = WGD->w[domainFaceID];
+      }
+    }
+  }
+  for (int k = 0; k < WGDw->nz - 1; k++) {
+    for (int j = 0; j < WGDw->ny - 1; j++) {
+      for (int i = 0; i < WGDw->nx - 1; i++) {
+        int cellID = i + j * (WGDw->nx - 1) + k * (WGDw->nx - 1) * (WGDw->ny - 1);
+        int domainCellID = (i + i0) + (j + j0) * (WGD->nx - 1) + k * (WGD->nx - 1) * (WGD->ny - 1);
+        WGDw->icellflag[cellID] = WGD->icellflag[domainCellID];
+        for (auto field : { &TURBGeneralData::txx, &TURBGeneralData::txy, &TURBGeneralData::txz,
+                            &TURBGeneralData::tyy, &TURBGeneralData::tyz, &TURBGeneralData::tzz,
+                            &TURBGeneralData::div_tau_x, &TURBGeneralData::div_tau_y, &TURBGeneralData::div_tau_z,
+                            &TURBGeneralData::nuT, &TURBGeneralData::CoEps }) {
+          (TGDw->*field)[cellID] = (TGD->*field)[domainCellID];
+        }
+      }
+    }
+  }
+
+  test_PlumeGeneralData *PGDw = new test_PlumeGeneralData(WGDw, TGDw);
+  PGDw->setInterpMethod("triLinear", WGDw, TGDw);
+
+  SECTION("testing random points inside the window")
+  {
+    int N = 10000;
+
+    std::mt19937 mersenne_engine{ 42 };
+    // keep the interpolation stencil inside the window
+    std::uniform_real_distribution<float> disX{ WGD->x[i0 + 2], WGD->x[i0 + windowSize[0] - 3] };
+    std::uniform_real_distribution<float> disY{ WGD->y[j0 + 2], WGD->y[j0 + windowSize[1] - 3] };
+    std::uniform_real_distribution<float> disZ{ 0, WGD->z_face[WGD->nz - 3] };
+
+    for (int it = 0; it < N; ++it) {
+      double xPos = disX(mersenne_engine);
+      double yPos = disY(mersenne_engine);
+      double zPos = disZ(mersenne_engine);
+
+      double uMean = 0.0, vMean = 0.0, wMean = 0.0;
+      double txx = 0.0, txy = 0.0, txz = 0.0, tyy = 0.0, tyz = 0.0, tzz = 0.0;
+      double flux_div_x = 0.0, flux_div_y = 0.0, flux_div_z = 0.0;
+      double CoEps = 1e-6, nuT = 0.0;
+      PGD->interp->interpValues(xPos, yPos, zPos, WGD, uMean, vMean, wMean, TGD, txx, txy, txz, tyy, tyz, tzz, flux_div_x, flux_div_y, flux_div_z, nuT, CoEps);
+
+      double uMeanW = 0.0, vMeanW = 0.0, wMeanW = 0.0;
+      double txxW = 0.0, txyW = 0.0, txzW = 0.0, tyyW = 0.0, tyzW = 0.0, tzzW = 0.0;
+      double flux_div_xW = 0.0, flux_div_yW = 0.0, flux_div_zW = 0.0;
+      double CoEpsW = 1e-6, nuTW = 0.0;
+      PGDw->interp->interpValues(xPos, yPos, zPos, WGDw, uMeanW, vMeanW, wMeanW, TGDw, txxW, txyW, txzW, tyyW, tyzW, tzzW, flux_div_xW, flux_div_yW, flux_div_zW, nuTW, CoEpsW);
+
+      // same cells and weights as on the whole domain
+      REQUIRE(uMeanW == uMean);
+      REQUIRE(vMeanW == vMean);
+      REQUIRE(wMeanW == wMean);
+      REQUIRE(txxW == txx);
+      REQUIRE(tzzW == tzz);
+      REQUIRE(flux_div_xW == flux_div_x);
+      REQUIRE(CoEpsW == CoEps);
+
+      REQUIRE(WGDw->icellflag[PGDw->interp->getCellId(xPos, yPos, zPos)]
+              == WGD->icellflag[PGD->interp->getCellId(xPos, yPos, zPos)]);
+    }
+  }
+}
@@ -0,0 +1,129 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <list>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "test_WINDSGeneralData.h"
+#include "test_TURBGeneralData.h"
+
+#include "plume/Plume.hpp"
+#include "plume/InterpNearestCell.h"
+#include "plume/ParticleTracer.hpp"
+
+class test_PopulationControl : public Plume
+{
+public:
+  test_PopulationControl(WINDSGeneralData *WGD, TURBGeneralData *TGD)
+    : Plume(WGD, TGD)
+  {
+    interp = new InterpNearestCell(WGD, TGD, false);
+#ifdef _OPENMP
+    threadRNG.resize(omp_get_max_threads(), nullptr);
+    for (size_t t = 0; t < threadRNG.size(); ++t) {
+      threadRNG[t] = new Random(1234 + t);
+    }
+#else
+    RNG = RandomSingleton::getInstance();
+#endif
+  }
+
+  using Plume::maxSplitGenerations;
+  using Plume::mergeParticles;
+  using Plume::particleList;
+  using Plume::roiBounds;
+  using Plume::splitParticles;
+
+  void addTracer(const double &x, const double &y, const double &z, const double &m)
+  {
+    auto *par_ptr = new ParticleTracer(0.0, m, 0.0);
+    par_ptr->xPos = x;
+    par_ptr->yPos = y;
+    par_ptr->zPos = z;
+    par_ptr->isActive = true;
+    par_ptr->particleID = particleList.size();
+    particleList.push_back(par_ptr);
+  }
+
+  double totalMass() const
+  {
+    double mass = 0.0;
+    for (auto &par_ptr : particleList) {
+      if (par_ptr->isActive) {
+        mass += par_ptr->m * par_ptr->wdecay;
+      }
+    }
+    return mass;
+  }
+};
+
+TEST_CASE("Testing the population control of the plume")
+{
+  int gridSize[3] = { 20, 20, 20 };
+  float gridRes[3] = { 1.0, 1.0, 1.0 };
+  test_WINDSGeneralData *WGD = new test_WINDSGeneralData(gridSize, gridRes);
+  test_TURBGeneralData *TGD = new test_TURBGeneralData(WGD);
+  test_PopulationControl *plume = new test_PopulationControl(WGD, TGD);
+
+  SECTION("merging conserves the mass")
+  {
+    // two groups of co-located particles (two cells), various masses
+    for (int p = 0; p < 100; ++p) {
+      plume->addTracer(5.5, 5.5, 5.5, 1.0 + 0.1 * p);
+      plume->addTracer(12.5, 8.5, 3.5, 0.5 + 0.01 * p);
+    }
+    double massBefore = plume->totalMass();
+
+    long nMerged = plume->mergeParticles(30);
+    REQUIRE(nMerged == 30);
+    REQUIRE(plume->particleList.size() == 170);
+    REQUIRE(std::abs(plume->totalMass() - massBefore) < 1.0e-12 * massBefore);
+
+    // at most a quarter of a group is removed at once (lightest half merged pairwise)
+    nMerged = plume->mergeParticles(1000);
+    REQUIRE(nMerged <= 170 / 4 + 1);
+    REQUIRE(std::abs(plume->totalMass() - massBefore) < 1.0e-12 * massBefore);
+  }
+
+  SECTION("splitting conserves the mass and stops after maxSplitGenerations")
+  {
+    plume->maxSplitGenerations = 2;
+    // region of interest: the lower half of the domain
+    double bounds[6] = { 0.0, 20.0, 0.0, 20.0, 0.0, 10.0 };
+    std::copy(bounds, bounds + 6, plume->roiBounds);
+
+    for (int p = 0; p < 10; ++p) {
+      plume->addTracer(2.5 + p, 5.5, 5.5, 2.0);
+    }
+    // outside the region of interest (never split)
+    plume->addTracer(5.5, 5.5, 15.5, 2.0);
+    double massBefore = plume->totalMass();
+
+    REQUIRE(plume->splitParticles(1000) == 10);
+    REQUIRE(plume->particleList.size() == 21);
+    REQUIRE(plume->splitParticles(1000) == 20);
+    REQUIRE(plume->particleList.size() == 41);
+    // all the particles of the region of interest were split twice
+    REQUIRE(plume->splitParticles(1000) == 0);
+    REQUIRE(plume->particleList.size() == 41);
+
+    for (auto &par_ptr : plume->particleList) {
+      if (par_ptr->zPos < 10.0) {
+        REQUIRE(par_ptr->splitLevel == 2);
+        REQUIRE(par_ptr->m == 0.5);
+      } else {
+        REQUIRE(par_ptr->splitLevel == 0);
+      }
+    }
+    REQUIRE(std::abs(plume->totalMass() - massBefore) < 1.0e-12 * massBefore);
+
+    // the number of splits is limited by the deficit
+    plume->maxSplitGenerations = 3;
+    REQUIRE(plume->splitParticles(5) == 5);
+    REQUIRE(plume->particleList.size() == 46);
+  }
+}
@@ -0,0 +1,74 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+#include "test_WINDSGeneralData.h"
+#include "test_TURBGeneralData.h"
+
+#include "plume/Plume.hpp"
+#include "plume/InterpNearestCell.h"
+#include "plume/WallReflection_StairStep.h"
+
+class test_WallReflection : public Plume
+{
+public:
+  test_WallReflection(WINDSGeneralData *WGD, TURBGeneralData *TGD)
+    : Plume(WGD, TGD)
+  {
+    interp = new InterpNearestCell(WGD, TGD, false);
+  }
+};
+
+TEST_CASE("Testing the stair-step wall reflection")
+{
+  int gridSize[3] = { 20, 20, 20 };
+  float gridRes[3] = { 1.0, 1.0, 1.0 };
+  test_WINDSGeneralData *WGD = new test_WINDSGeneralData(gridSize, gridRes);
+  test_TURBGeneralData *TGD = new test_TURBGeneralData(WGD);
+  test_WallReflection *plume = new test_WallReflection(WGD, TGD);
+
+  // wall of one cell at i = 10
+  for (int k = 1; k < WGD->nz - 1; ++k) {
+    for (int j = 0; j < WGD->ny - 1; ++j) {
+      WGD->icellflag[10 + j * (WGD->nx - 1) + k * (WGD->nx - 1) * (WGD->ny - 1)] = 0;
+    }
+  }
+  WallReflection_StairStep wall;
+
+  SECTION("a trajectory within one fluid cell is unchanged")
+  {
+    double x = 5.7, y = 5.5, z = 5.5, disX = 0.4, disY = 0.0, disZ = 0.0;
+    double uF = 1.0, vF = 0.0, wF = 0.0;
+    REQUIRE(wall.reflect(WGD, plume, x, y, z, disX, disY, disZ, uF, vF, wF));
+    REQUIRE(x == 5.7);
+    REQUIRE(uF == 1.0);
+    REQUIRE(wall.takeBounceCount() == 0);
+  }
+
+  SECTION("a trajectory crossing the thin wall into fluid bounces on it")
+  {
+    // from x = 9.5 to x = 11.5 (fluid on both sides of the wall)
+    double x = 11.5, y = 5.5, z = 5.5, disX = 2.0, disY = 0.0, disZ = 0.0;
+    double uF = 1.0, vF = 0.0, wF = 0.0;
+    REQUIRE(wall.reflect(WGD, plume, x, y, z, disX, disY, disZ, uF, vF, wF));
+    REQUIRE_THAT(x, Catch::Matchers::WithinAbs(8.5, 1e-9));
+    REQUIRE(y == 5.5);
+    REQUIRE(z == 5.5);
+    REQUIRE(uF == -1.0);
+    REQUIRE(wall.takeBounceCount() == 1);
+  }
+
+  SECTION("a trajectory across several fluid cells is unchanged")
+  {
+    double x = 7.5, y = 5.5, z = 5.5, disX = -2.0, disY = 1.0, disZ = 0.0;
+    double uF = -1.0, vF = 0.5, wF = 0.0;
+    REQUIRE(wall.reflect(WGD, plume, x, y, z, disX, disY, disZ, uF, vF, wF));
+    REQUIRE_THAT(x, Catch::Matchers::WithinAbs(7.5, 1e-9));
+    REQUIRE_THAT(y, Catch::Matchers::WithinAbs(5.5, 1e-9));
+    REQUIRE(uF == -1.0);
+    REQUIRE(wall.takeBounceCount() == 0);
+  }
+
+  delete plume;
+  delete TGD;
+  delete WGD;
+}
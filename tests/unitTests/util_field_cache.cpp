@@ -0,0 +1,66 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "util/FieldCache.h"
+
+TEST_CASE("Testing FieldCache class")
+{
+  std::string cacheFile = "util_field_cache_test.fcache";
+  std::remove(cacheFile.c_str());
+  REQUIRE(!FieldCache::exists(cacheFile));
+
+  std::vector<int> icellflag = { 0, 1, 2, 1, 1 };
+  std::vector<float> u0(1000), u1(1000);
+  std::vector<double> z = { -0.5, 0.5, 1.5 };
+  for (size_t i = 0; i < u0.size(); ++i) {
+    u0[i] = 0.5f * i;
+    u1[i] = -1.0f * i;
+  }
+
+  FieldCacheWriter writer(cacheFile);
+  writer.addVariable("icellflag", 0, icellflag);
+  writer.addVariable("u", 0, u0);
+  writer.addVariable("u", 1, u1);
+  writer.addVariable("z", 0, z);
+  writer.close();
+
+  REQUIRE(FieldCache::exists(cacheFile));
+
+  FieldCache cache(cacheFile);
+  REQUIRE(cache.hasVariable("u", 1));
+  REQUIRE(!cache.hasVariable("u", 2));
+  REQUIRE(!cache.hasVariable("v", 0));
+
+  std::vector<int> icellflag_in;
+  cache.getVariableData("icellflag", 0, icellflag_in);
+  REQUIRE(icellflag_in == icellflag);
+
+  std::vector<float> u_in;
+  cache.getVariableData("u", 0, u_in);
+  REQUIRE(u_in == u0);
+  cache.getVariableData("u", 1, u_in);
+  REQUIRE(u_in == u1);
+
+  std::vector<double> z_in;
+  cache.getVariableData("z", 0, z_in);
+  REQUIRE(z_in == z);
+
+  // read-only views index the mapping in place
+  FieldView<float> u_view = cache.getVariableView("u", 1);
+  REQUIRE(u_view.size() == u1.size());
+  REQUIRE(reinterpret_cast<uintptr_t>(u_view.data()) % FieldCache::alignment == 0);
+  REQUIRE(std::vector<float>(u_view.begin(), u_view.end()) == u1);
+  REQUIRE(u_view[999] == u1[999]);
+  cache.willNeed("u", 0);
+
+  // a vector converts to a view of itself
+  FieldView<float> vec_view(u0);
+  REQUIRE(vec_view.data() == u0.data());
+  REQUIRE(vec_view.size() == u0.size());
+
+  std::remove(cacheFile.c_str());
+}
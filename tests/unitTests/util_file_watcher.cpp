@@ -0,0 +1,89 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "util/FileWatcher.h"
+
+TEST_CASE("Testing FileWatcher class")
+{
+  std::string watchedFile = "util_file_watcher_test.dat";
+  std::string otherFile = "util_file_watcher_other.dat";
+  std::ofstream(watchedFile) << 0;
+
+  FileWatcher watcher(watchedFile);
+  if (!watcher.isEventDriven()) {
+    // polling fallback: the wait only sleeps
+    REQUIRE(!watcher.wait(0.01));
+    std::remove(watchedFile.c_str());
+    return;
+  }
+
+  SECTION("timeout without write")
+  {
+    REQUIRE(!watcher.wait(0.05));
+  }
+
+  SECTION("other files of the directory are ignored")
+  {
+    std::ofstream(otherFile) << 1;
+    REQUIRE(!watcher.wait(0.05));
+    std::remove(otherFile.c_str());
+  }
+
+  SECTION("pending notifications are discarded")
+  {
+    std::ofstream(watchedFile) << 1;
+    watcher.clear();
+    REQUIRE(!watcher.wait(0.05));
+  }
+
+  SECTION("our own close of the file opened for writing is discarded")
+  {
+    // the coupling re-opens the file for writing to check the frame
+    std::fstream file(watchedFile, std::ios::in | std::ios::out);
+    file.close();
+    watcher.clear();
+    REQUIRE(!watcher.wait(0.05));
+
+    // and again at the next check
+    file.open(watchedFile, std::ios::in | std::ios::out);
+    file.close();
+    watcher.clear();
+    REQUIRE(!watcher.wait(0.05));
+  }
+
+  SECTION("woken up by a writer")
+  {
+    // stand-in for the coupled model, writing a new frame after a delay
+    std::thread writer([&]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      std::ofstream(watchedFile) << 2;
+    });
+    auto start = std::chrono::steady_clock::now();
+    REQUIRE(watcher.wait(5.0));
+    std::chrono::duration<double> waited = std::chrono::steady_clock::now() - start;
+    REQUIRE(waited.count() < 2.0);
+    writer.join();
+
+    int frame = -1;
+    std::ifstream(watchedFile) >> frame;
+    REQUIRE(frame == 2);
+  }
+
+  SECTION("file replaced by a rename")
+  {
+    std::thread writer([&]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      std::ofstream(otherFile) << 3;
+      std::rename(otherFile.c_str(), watchedFile.c_str());
+    });
+    REQUIRE(watcher.wait(5.0));
+    writer.join();
+  }
+
+  std::remove(watchedFile.c_str());
+}
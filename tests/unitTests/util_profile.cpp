@@ -0,0 +1,56 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "util/QESprofile.h"
+
+TEST_CASE("Testing QESprofile report")
+{
+  std::string reportFile = "util_profile_test.csv";
+  std::remove(reportFile.c_str());
+
+  // nothing is recorded before profiling is enabled
+  {
+    QESprofile::Scope scope("disabled");
+    QESprofile::addCount("disabled", 1);
+  }
+
+  QESprofile::enable();
+  REQUIRE(QESprofile::enabled());
+
+  for (int step = 0; step < 2; ++step) {
+    QESprofile::beginStep(step);
+    QESprofile::Scope outer("solver");
+    REQUIRE(QESprofile::currentPath() == "solver");
+    {
+      QESprofile::Scope inner("iteration");
+      REQUIRE(QESprofile::currentPath() == "solver/iteration");
+    }
+    REQUIRE(QESprofile::currentPath() == "solver");
+    QESprofile::addCount("iterations", 10);
+    QESprofile::addCount("iterations", 5);
+    QESprofile::setValue("cells_per_second", 2.0);
+    outer.stop();
+    REQUIRE(QESprofile::currentPath().empty());
+  }
+
+  QESprofile::writeReport(reportFile);
+
+  std::ifstream report(reportFile);
+  REQUIRE(report.good());
+  std::string line, content;
+  std::getline(report, line);
+  REQUIRE(line == "step,type,name,calls,value");
+  while (std::getline(report, line)) {
+    content += line + "\n";
+  }
+  REQUIRE(content.find("disabled") == std::string::npos);
+  REQUIRE(content.find("0,timer,solver,1,") != std::string::npos);
+  REQUIRE(content.find("1,timer,solver/iteration,1,") != std::string::npos);
+  REQUIRE(content.find("0,counter,iterations,,15") != std::string::npos);
+  REQUIRE(content.find("1,value,cells_per_second,,2") != std::string::npos);
+
+  std::remove(reportFile.c_str());
+}
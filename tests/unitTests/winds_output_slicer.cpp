@@ -0,0 +1,94 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include "test_WINDSGeneralData.h"
+#include "winds/OutputSlicer.h"
+
+TEST_CASE("Testing OutputSlicer class")
+{
+  int gridSize[3] = { 20, 16, 12 };
+  float gridRes[3] = { 2.0, 2.0, 1.0 };
+  test_WINDSGeneralData *WGD = new test_WINDSGeneralData(gridSize, gridRes);
+
+  int nx = WGD->nx, ny = WGD->ny, nz = WGD->nz;
+  long layer = (long)(nx - 1) * (ny - 1);
+
+  // terrain rising along x
+  for (int j = 0; j < ny - 1; j++) {
+    for (int i = 0; i < nx - 1; i++) {
+      WGD->terrain[i + j * (nx - 1)] = 0.25f * i;
+    }
+  }
+
+  // visualization-like field (layers 1 to nz-2): linear in z, index in x
+  std::vector<float> field((nz - 2) * layer);
+  std::vector<int> flags((nz - 2) * layer);
+  for (int k = 1; k < nz - 1; k++) {
+    for (int j = 0; j < ny - 1; j++) {
+      for (int i = 0; i < nx - 1; i++) {
+        long id = i + j * (nx - 1) + (k - 1) * layer;
+        field[id] = WGD->z[k];
+        flags[id] = k;
+      }
+    }
+  }
+
+  VisualizationSlices slices;
+  slices.sliceHeights = { 3.2f, 5.5f };
+  slices.xSections = { 11.0f };
+  slices.ySections = { 3.0f, 29.0f };
+  slices.stride = 4;
+
+  OutputSlicer slicer(&slices, WGD);
+
+  SECTION("terrain-following horizontal slices")
+  {
+    REQUIRE(slicer.hSlice.size() == 2 * (size_t)layer);
+    std::vector<float> out;
+    slicer.extract(slicer.hSlice, field, 1, out);
+    for (int s = 0; s < 2; s++) {
+      for (int j = 0; j < ny - 1; j++) {
+        for (int i = 0; i < nx - 1; i++) {
+          float expected = WGD->terrain[i + j * (nx - 1)] + slices.sliceHeights[s];
+          REQUIRE(std::abs(out[i + j * (nx - 1) + s * layer] - expected) < 1.0e-5);
+        }
+      }
+    }
+
+    // closest cell for the integer fields (3.2 m -> center of the cell k = 4 at 3.5 m)
+    std::vector<int> outFlags;
+    slicer.extract(slicer.hSlice, flags, 1, outFlags);
+    REQUIRE(outFlags[0] == 4);
+  }
+
+  SECTION("vertical cross-sections")
+  {
+    REQUIRE(slicer.xSection.size() == (size_t)((nz - 2) * (ny - 1)));
+    REQUIRE(slicer.ySection.size() == (size_t)(2 * (nz - 2) * (nx - 1)));
+    for (auto &sample : slicer.xSection) {
+      REQUIRE(sample.id0 % (nx - 1) == 5);
+    }
+    for (size_t p = 0; p < slicer.ySection.size(); p++) {
+      long j = (slicer.ySection[p].id0 / (nx - 1)) % (ny - 1);
+      REQUIRE(j == (p < slicer.ySection.size() / 2 ? 1 : 14));
+    }
+  }
+
+  SECTION("decimated volume")
+  {
+    REQUIRE(slicer.xCoarse.size() == 5);
+    REQUIRE(slicer.yCoarse.size() == 4);
+    REQUIRE(slicer.zCoarse.size() == 3);
+    REQUIRE(slicer.coarse.size() == 5 * 4 * 3);
+
+    std::vector<float> out;
+    slicer.extract(slicer.coarse, field, 1, out);
+    for (size_t k = 0; k < slicer.zCoarse.size(); k++) {
+      REQUIRE(out[k * 20] == slicer.zCoarse[k]);
+    }
+  }
+
+  delete WGD;
+}
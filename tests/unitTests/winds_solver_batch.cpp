@@ -0,0 +1,77 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <random>
+#include <vector>
+
+#include "test_WINDSGeneralData.h"
+#include "winds/WINDSInputData.h"
+#include "winds/Solver_CPU_RB.h"
+
+// random initial field (reproducible)
+static void randomField(test_WINDSGeneralData *WGD, std::mt19937 &gen)
+{
+  std::uniform_real_distribution<float> dist(-5.0f, 5.0f);
+  for (auto &u : WGD->u0) u = dist(gen);
+  for (auto &v : WGD->v0) v = dist(gen);
+  for (auto &w : WGD->w0) w = dist(gen);
+}
+
+TEST_CASE("Testing batched red/black solve against one-by-one solves")
+{
+  int gridSize[3] = { 14, 12, 10 };
+  float gridRes[3] = { 2.0, 2.0, 1.0 };
+  test_WINDSGeneralData *WGD = new test_WINDSGeneralData(gridSize, gridRes);
+
+  // reduced coefficients of some cells (like next to a solid face)
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<float> coef(0.0f, 1.0f);
+  for (long id = 0; id < WGD->numcell_cent; id += 7) {
+    WGD->e[id] = coef(gen);
+    WGD->h[id] = coef(gen);
+    WGD->m[id] = coef(gen);
+  }
+
+  // fixed omega (the adaptive omega follows the maximum error of the batch) and
+  // fixed number of iterations (the tolerance is never reached)
+  WINDSInputData *WID = new WINDSInputData();
+  WID->simParams = new SimulationParameters();
+  WID->simParams->maxIterations = 40;
+  WID->simParams->tolerance = 0.0;
+  WID->simParams->SORomega = 1.7f;
+
+  const int nRHS = 3;
+  std::vector<std::vector<float>> u0(nRHS), v0(nRHS), w0(nRHS);
+
+  Solver_CPU_RB batch(WID, WGD);
+  batch.setBatchSize(WGD, nRHS);
+  for (int t = 0; t < nRHS; ++t) {
+    randomField(WGD, gen);
+    u0[t] = WGD->u0;
+    v0[t] = WGD->v0;
+    w0[t] = WGD->w0;
+    batch.storeBatchRHS(WGD, t);
+  }
+  batch.solveBatch(WID, WGD, nRHS);
+
+  for (int t = 0; t < nRHS; ++t) {
+    // solution of the batch
+    WGD->u0 = u0[t];
+    WGD->v0 = v0[t];
+    WGD->w0 = w0[t];
+    batch.applyBatch(WGD, t);
+    std::vector<float> u = WGD->u, v = WGD->v, w = WGD->w;
+
+    // same timestep solved alone
+    Solver_CPU_RB single(WID, WGD);
+    Solver *solver = &single;
+    solver->resetLambda();
+    solver->solve(WID, WGD, true);
+
+    REQUIRE(u == WGD->u);
+    REQUIRE(v == WGD->v);
+    REQUIRE(w == WGD->w);
+  }
+
+  delete WID;
+  delete WGD;
+}